@@ -37,6 +37,29 @@ android {
             "String", "ANTHROPIC_API_KEY",
             "\"${System.getenv("ANTHROPIC_API_KEY") ?: localProps.getProperty("ANTHROPIC_API_KEY", "")}\""
         )
+
+        // Ableton Link JNI bridge (shared/tempo), built for every shipped ABI
+        ndk {
+            abiFilters += listOf("arm64-v8a", "armeabi-v7a", "x86_64")
+        }
+        externalNativeBuild {
+            cmake {
+                // Static libc++: the bridge is the only native library, so no
+                // libc++_shared.so to package and load alongside it
+                arguments += listOf("-DANDROID_STL=c++_static")
+                // -Pchromadmx.trace=true: ATrace sections for Perfetto (trace.h)
+                if (findProperty("chromadmx.trace")?.toString()?.toBoolean() == true) {
+                    arguments += listOf("-DCHROMADMX_TRACE=ON")
+                }
+            }
+        }
+    }
+
+    externalNativeBuild {
+        cmake {
+            path = rootProject.file("shared/tempo/src/androidMain/cpp/CMakeLists.txt")
+            version = "3.22.1"
+        }
     }
 
     buildFeatures {
@@ -51,6 +51,17 @@
     volatile <fields>;
 }
 
+# --- Ableton Link JNI bridge ---
+# JNI resolves native methods and the onNative* callbacks by name
+-keepclasseswithmembernames class com.chromadmx.tempo.link.LinkSession {
+    native <methods>;
+}
+-keepclassmembers class com.chromadmx.tempo.link.LinkSession {
+    private void onNativeNumPeers(int);
+    private void onNativeTempo(double);
+    private void onNativeStartStop(boolean);
+}
+
 # --- CameraX ---
 -keep class androidx.camera.** { *; }
 
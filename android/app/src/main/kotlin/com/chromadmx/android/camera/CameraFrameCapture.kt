@@ -34,6 +34,9 @@ class CameraFrameCapture(private val context: Context) {
         private const val TAG = "CameraFrameCapture"
         private const val ANALYSIS_WIDTH = 320
         private const val ANALYSIS_HEIGHT = 240
+
+        /** 8-bit luma to normalized brightness, matching `value / 255f`. */
+        private val LUMA_TO_FLOAT = FloatArray(256) { it / 255f }
     }
 
     private val analysisExecutor = Executors.newSingleThreadExecutor()
@@ -101,10 +104,17 @@ class CameraFrameCapture(private val context: Context) {
         cameraProvider = null
     }
 
+    /** Reused row copy of the Y plane; only touched on [analysisExecutor]. */
+    private var rowBytes = ByteArray(0)
+
     /**
      * Extract the Y (luminance) plane from a YUV_420_888 image and convert to
      * a normalized FloatArray. The Y plane is a direct grayscale representation
      * so no color conversion is needed.
+     *
+     * Each row is copied out of the (direct) plane buffer in one bulk get and
+     * mapped through [LUMA_TO_FLOAT], instead of one indexed buffer read and
+     * one division per pixel.
      */
     private fun processFrame(
         imageProxy: ImageProxy,
@@ -117,11 +127,15 @@ class CameraFrameCapture(private val context: Context) {
             val height = imageProxy.height
             val rowStride = yPlane.rowStride
 
+            if (rowBytes.size < width) rowBytes = ByteArray(width)
+            val row = rowBytes
             val luminance = FloatArray(width * height)
-            for (row in 0 until height) {
-                for (col in 0 until width) {
-                    val yValue = yBuffer.get(row * rowStride + col).toInt() and 0xFF
-                    luminance[row * width + col] = yValue / 255f
+            for (y in 0 until height) {
+                yBuffer.position(y * rowStride)
+                yBuffer.get(row, 0, width)
+                val offset = y * width
+                for (x in 0 until width) {
+                    luminance[offset + x] = LUMA_TO_FLOAT[row[x].toInt() and 0xFF]
                 }
             }
 
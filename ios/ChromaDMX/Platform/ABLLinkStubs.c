@@ -51,3 +51,58 @@ double ABLLinkGetBeatAtTime(ABLLinkSessionStateRef state, uint64_t hostTime, dou
     (void)quantum;
     return 0.0;
 }
+
+void ABLLinkSetSessionTempoCallback(ABLLinkRef ref, ABLLinkSessionTempoCallback callback, void* context) {
+    (void)ref;
+    (void)callback;
+    (void)context;
+}
+
+void ABLLinkSetIsConnectedCallback(ABLLinkRef ref, ABLLinkIsConnectedCallback callback, void* context) {
+    (void)ref;
+    (void)callback;
+    (void)context;
+}
+
+void ABLLinkSetStartStopCallback(ABLLinkRef ref, ABLLinkStartStopCallback callback, void* context) {
+    (void)ref;
+    (void)callback;
+    (void)context;
+}
+
+uint64_t ABLLinkGetTimeAtBeat(ABLLinkSessionStateRef state, double beatTime, double quantum) {
+    (void)state;
+    (void)beatTime;
+    (void)quantum;
+    return 0;
+}
+
+bool ABLLinkIsStartStopSyncEnabled(ABLLinkRef ref) {
+    (void)ref;
+    return false;
+}
+
+bool ABLLinkIsPlaying(ABLLinkSessionStateRef state) {
+    (void)state;
+    return false;
+}
+
+uint64_t ABLLinkTimeForIsPlaying(ABLLinkSessionStateRef state) {
+    (void)state;
+    return 0;
+}
+
+void ABLLinkSetIsPlaying(ABLLinkSessionStateRef state, bool isPlaying, uint64_t hostTime) {
+    (void)state;
+    (void)isPlaying;
+    (void)hostTime;
+}
+
+void ABLLinkSetIsPlayingAndRequestBeatAtTime(
+    ABLLinkSessionStateRef state, bool isPlaying, uint64_t hostTime, double beatTime, double quantum) {
+    (void)state;
+    (void)isPlaying;
+    (void)hostTime;
+    (void)beatTime;
+    (void)quantum;
+}
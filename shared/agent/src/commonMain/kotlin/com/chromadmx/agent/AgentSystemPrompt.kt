@@ -26,7 +26,7 @@ object AgentSystemPrompt {
 
         ### Scenes
         - createScene(name): save current state as a named preset
-        - loadScene(name): recall a saved preset
+        - loadScene(name, quantize): recall a saved preset; quantize BEAT or BAR lands it on the next beat/downbeat
 
         ### Network
         - scanNetwork: discover Art-Net/sACN nodes
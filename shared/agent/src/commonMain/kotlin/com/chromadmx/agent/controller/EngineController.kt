@@ -2,6 +2,7 @@ package com.chromadmx.agent.controller
 
 import com.chromadmx.agent.scene.Scene
 import com.chromadmx.core.model.ScenePreset
+import com.chromadmx.engine.pipeline.CueQuantize
 
 /**
  * Abstraction over the effect engine for agent tool operations.
@@ -36,4 +37,13 @@ interface EngineController {
 
     /** Apply a [ScenePreset] to the engine. */
     fun applyPreset(preset: ScenePreset)
+
+    /**
+     * Run [action] at the next [quantize] boundary of the beat clock, on the
+     * engine loop. The default runs it immediately, for controllers with no
+     * engine loop behind them.
+     */
+    fun schedule(quantize: CueQuantize, action: () -> Unit) {
+        action()
+    }
 }
@@ -6,6 +6,8 @@ import com.chromadmx.core.model.*
 import com.chromadmx.engine.effect.EffectLayer
 import com.chromadmx.engine.effect.EffectRegistry
 import com.chromadmx.engine.effect.EffectStack
+import com.chromadmx.engine.pipeline.CueQuantize
+import com.chromadmx.engine.pipeline.CueQueue
 import kotlinx.atomicfu.atomic
 import kotlinx.atomicfu.locks.SynchronizedObject
 import kotlinx.atomicfu.locks.synchronized
@@ -19,10 +21,13 @@ import kotlinx.atomicfu.locks.synchronized
  *
  * @param effectStack    The compositing effect stack.
  * @param effectRegistry Registry for looking up effects by ID.
+ * @param cueQueue       The engine's beat-quantized cue queue; without one,
+ *                       [schedule] runs actions immediately.
  */
 class RealEngineController(
     private val effectStack: EffectStack,
     private val effectRegistry: EffectRegistry,
+    private val cueQueue: CueQueue? = null,
 ) : EngineController {
 
     private val lock = SynchronizedObject()
@@ -170,4 +175,13 @@ class RealEngineController(
         effectStack.replaceLayers(newLayers)
         effectStack.masterDimmer = preset.masterDimmer
     }
+
+    override fun schedule(quantize: CueQuantize, action: () -> Unit) {
+        val queue = cueQueue
+        if (queue == null || quantize == CueQuantize.IMMEDIATE) {
+            action()
+        } else {
+            queue.schedule(quantize, action)
+        }
+    }
 }
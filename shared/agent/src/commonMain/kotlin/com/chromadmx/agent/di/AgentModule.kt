@@ -18,6 +18,7 @@ import com.chromadmx.agent.pregen.PreGenerationService
 import com.chromadmx.agent.tools.buildToolRegistry
 import com.chromadmx.core.model.Fixture3D
 import com.chromadmx.engine.effect.EffectRegistry
+import com.chromadmx.engine.pipeline.EffectEngine
 import org.koin.core.module.Module
 import org.koin.dsl.module
 
@@ -33,7 +34,7 @@ val agentModule: Module = module {
             else -> AgentConfig()
         }
     }
-    single<EngineController> { RealEngineController(get(), get()) }
+    single<EngineController> { RealEngineController(get(), get(), getOrNull<EffectEngine>()?.cueQueue) }
     single<NetworkController> { RealNetworkController(get()) }
     single<FixtureController> {
         val fixturesProvider: () -> List<Fixture3D> = getOrNull() ?: { emptyList() }
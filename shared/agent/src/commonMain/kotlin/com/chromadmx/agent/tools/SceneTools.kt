@@ -3,6 +3,7 @@ package com.chromadmx.agent.tools
 import ai.koog.agents.core.tools.SimpleTool
 import ai.koog.agents.core.tools.annotations.LLMDescription
 import com.chromadmx.agent.controller.EngineController
+import com.chromadmx.engine.pipeline.CueQuantize
 import com.chromadmx.engine.preset.PresetLibrary
 import kotlinx.serialization.Serializable
 
@@ -136,19 +137,28 @@ class LoadSceneTool(
 ) : SimpleTool<LoadSceneTool.Args>(
     argsSerializer = Args.serializer(),
     name = "loadScene",
-    description = "Load a previously saved scene by name and apply it to the engine."
+    description = "Load a previously saved scene by name and apply it to the engine, now or on the next beat/bar."
 ) {
     @Serializable
     data class Args(
         @property:LLMDescription("Name of the scene to load")
-        val name: String
+        val name: String,
+        @property:LLMDescription("When to switch: IMMEDIATE, BEAT (next beat) or BAR (next downbeat)")
+        val quantize: String = "IMMEDIATE"
     )
 
     override suspend fun execute(args: Args): String {
         val presets = presetLibrary.listPresets()
         val preset = presets.find { it.name.equals(args.name, ignoreCase = true) }
             ?: return "Scene '${args.name}' not found. Available: ${presets.joinToString(", ") { it.name }}"
-        controller.applyPreset(preset)
-        return "Loaded scene '${args.name}' with ${preset.layers.size} layers, dimmer=${preset.masterDimmer}"
+        val quantize = CueQuantize.entries.find { it.name == args.quantize.uppercase() }
+            ?: return "Error: invalid quantize '${args.quantize}'. Valid values: ${CueQuantize.entries.joinToString(", ")}"
+        controller.schedule(quantize) { controller.applyPreset(preset) }
+        val summary = "scene '${args.name}' with ${preset.layers.size} layers, dimmer=${preset.masterDimmer}"
+        return when (quantize) {
+            CueQuantize.IMMEDIATE -> "Loaded $summary"
+            CueQuantize.BEAT -> "Queued $summary for the next beat"
+            CueQuantize.BAR -> "Queued $summary for the next bar"
+        }
     }
 }
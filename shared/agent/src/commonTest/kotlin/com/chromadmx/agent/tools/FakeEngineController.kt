@@ -3,6 +3,7 @@ package com.chromadmx.agent.tools
 import com.chromadmx.agent.controller.EngineController
 import com.chromadmx.agent.scene.Scene
 import com.chromadmx.core.model.*
+import com.chromadmx.engine.pipeline.CueQuantize
 
 /**
  * Fake [EngineController] for testing tools without the real engine.
@@ -19,6 +20,16 @@ class FakeEngineController : EngineController {
     var lastBlendMode: String = "NORMAL"
     var lastBlendModeLayer: Int = -1
     var lastAppliedScene: Scene? = null
+    var lastScheduledQuantize: CueQuantize? = null
+
+    /** Quantized actions held until [fireCues]; immediate ones run at once. */
+    val pendingCues = mutableListOf<() -> Unit>()
+
+    fun fireCues() {
+        val cues = pendingCues.toList()
+        pendingCues.clear()
+        cues.forEach { it() }
+    }
 
     override fun setEffect(layer: Int, effectId: String, params: Map<String, Float>): Boolean {
         lastSetEffectId = effectId
@@ -71,4 +82,9 @@ class FakeEngineController : EngineController {
     override fun applyPreset(preset: ScenePreset) {
         lastMasterDimmer = preset.masterDimmer
     }
+
+    override fun schedule(quantize: CueQuantize, action: () -> Unit) {
+        lastScheduledQuantize = quantize
+        if (quantize == CueQuantize.IMMEDIATE) action() else pendingCues += action
+    }
 }
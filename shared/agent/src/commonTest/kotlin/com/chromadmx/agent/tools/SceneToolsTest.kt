@@ -4,6 +4,7 @@ import com.chromadmx.agent.scene.Scene
 import com.chromadmx.engine.preset.PresetLibrary
 import com.chromadmx.engine.effect.EffectRegistry
 import com.chromadmx.engine.effect.EffectStack
+import com.chromadmx.engine.pipeline.CueQuantize
 import com.chromadmx.agent.FakeFileStorage
 import kotlinx.coroutines.test.runTest
 import kotlin.test.Test
@@ -94,6 +95,29 @@ class SceneToolsTest {
         assertEquals(0.5f, controller.lastMasterDimmer)
     }
 
+    @Test
+    fun loadSceneOnBarWaitsForDownbeat() = runTest {
+        library.savePreset(controller.capturePreset("Drop").copy(masterDimmer = 0.25f))
+        val tool = LoadSceneTool(controller, library)
+        val result = tool.execute(LoadSceneTool.Args(name = "Drop", quantize = "bar"))
+        assertContains(result, "next bar")
+        assertEquals(CueQuantize.BAR, controller.lastScheduledQuantize)
+        assertEquals(1.0f, controller.lastMasterDimmer)
+
+        controller.fireCues()
+        assertEquals(0.25f, controller.lastMasterDimmer)
+    }
+
+    @Test
+    fun loadSceneRejectsUnknownQuantize() = runTest {
+        library.savePreset(controller.capturePreset("Drop").copy(masterDimmer = 0.25f))
+        val tool = LoadSceneTool(controller, library)
+        val result = tool.execute(LoadSceneTool.Args(name = "Drop", quantize = "phrase"))
+        assertContains(result, "invalid quantize 'phrase'")
+        assertContains(result, "IMMEDIATE, BEAT, BAR")
+        assertEquals(1.0f, controller.lastMasterDimmer)
+    }
+
     @Test
     fun loadSceneReturnsErrorForMissing() = runTest {
         val tool = LoadSceneTool(controller, library)
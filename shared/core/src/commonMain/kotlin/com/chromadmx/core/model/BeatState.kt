@@ -10,13 +10,16 @@ import kotlinx.serialization.Serializable
  * @property beatPhase  Phase within the current beat, 0.0 (downbeat) to 1.0.
  * @property barPhase   Phase within the current bar (4 beats), 0.0 to 1.0.
  * @property elapsed    Seconds since the clock was started.
+ * @property isPlaying  False while a synced transport is stopped; the engine
+ *                      holds its last frame until it is true again.
  */
 @Serializable
 data class BeatState(
     val bpm: Float,
     val beatPhase: Float,
     val barPhase: Float,
-    val elapsed: Float
+    val elapsed: Float,
+    val isPlaying: Boolean = true
 ) {
     companion object {
         /** Idle / default state (120 BPM, no phase). */
@@ -0,0 +1,131 @@
+package com.chromadmx.core.telemetry
+
+import kotlin.concurrent.Volatile
+
+/**
+ * Fixed-size log-linear histogram of durations in microseconds.
+ *
+ * HDR-style bucketing: values below [SUB_BUCKETS] are counted exactly, and
+ * every power of two above that is split into [SUB_BUCKETS] equal buckets,
+ * so any recorded value is reported to within 1/[SUB_BUCKETS] (12.5%) of
+ * itself across the whole range up to [MAX_MICROS] (~67 s). Larger values
+ * land in the last bucket.
+ *
+ * [record] is a handful of integer operations on a preallocated array with
+ * no allocation and no lock, so it can sit on the render and DMX loops.
+ *
+ * Single writer: each histogram is recorded from one loop only. Any thread
+ * may read; a reader racing the writer can see slightly stale bucket
+ * counts, which is fine for an overlay or a field log. [clear] belongs to
+ * the writer as well.
+ */
+class LatencyHistogram {
+
+    private val counts = LongArray(BUCKET_COUNT)
+
+    /** Number of recorded samples. */
+    @Volatile
+    var count: Long = 0L
+        private set
+
+    /** Largest recorded value in microseconds, 0 when empty. */
+    @Volatile
+    var maxMicros: Long = 0L
+        private set
+
+    @Volatile
+    private var sumMicros: Long = 0L
+
+    /** Mean of the recorded values in microseconds, 0 when empty. */
+    val meanMicros: Double
+        get() {
+            val n = count
+            return if (n == 0L) 0.0 else sumMicros.toDouble() / n
+        }
+
+    /** Record one duration; negative values count as 0. */
+    fun record(micros: Long) {
+        val value = micros.coerceIn(0L, MAX_MICROS)
+        counts[bucketOf(value)]++
+        sumMicros += value
+        if (value > maxMicros) maxMicros = value
+        count++
+    }
+
+    /**
+     * Value at or below which [fraction] (0.0-1.0) of samples fall, as the
+     * upper bound of the bucket holding it. 0 when empty.
+     */
+    fun percentile(fraction: Double): Long {
+        val n = count
+        if (n == 0L) return 0L
+        val rank = (fraction.coerceIn(0.0, 1.0) * n).toLong().coerceIn(1L, n)
+        var seen = 0L
+        for (i in 0 until BUCKET_COUNT) {
+            seen += counts[i]
+            if (seen >= rank) return minOf(upperBoundOf(i), maxMicros)
+        }
+        return maxMicros
+    }
+
+    /** Percentiles and totals at this instant. */
+    fun summary(): Summary = Summary(
+        count = count,
+        p50Micros = percentile(0.50),
+        p99Micros = percentile(0.99),
+        p999Micros = percentile(0.999),
+        maxMicros = maxMicros,
+        meanMicros = meanMicros
+    )
+
+    /** Drop every sample. Call from the recording loop. */
+    fun clear() {
+        counts.fill(0L)
+        sumMicros = 0L
+        maxMicros = 0L
+        count = 0L
+    }
+
+    /** One reading of a [LatencyHistogram], for overlays and logs. */
+    data class Summary(
+        val count: Long,
+        val p50Micros: Long,
+        val p99Micros: Long,
+        val p999Micros: Long,
+        val maxMicros: Long,
+        val meanMicros: Double
+    ) {
+        override fun toString(): String =
+            "n=$count p50=${p50Micros}us p99=${p99Micros}us p99.9=${p999Micros}us max=${maxMicros}us"
+    }
+
+    companion object {
+        /** Buckets per power of two (and exact values below it). */
+        const val SUB_BUCKETS: Int = 8
+
+        private const val SUB_BUCKET_BITS = 3
+
+        /** Largest distinguishable value, 2^26 us. */
+        const val MAX_MICROS: Long = 1L shl 26
+
+        private const val MAX_BIT = 26
+
+        private const val BUCKET_COUNT = SUB_BUCKETS + (MAX_BIT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS
+
+        internal fun bucketOf(value: Long): Int {
+            if (value < SUB_BUCKETS) return value.toInt()
+            val msb = 63 - value.countLeadingZeroBits()
+            val shift = msb - SUB_BUCKET_BITS
+            val sub = ((value shr shift) and (SUB_BUCKETS - 1).toLong()).toInt()
+            return SUB_BUCKETS + shift * SUB_BUCKETS + sub
+        }
+
+        internal fun upperBoundOf(bucket: Int): Long {
+            if (bucket < SUB_BUCKETS) return bucket.toLong()
+            val shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS
+            val sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS
+            val lower = (SUB_BUCKETS + sub).toLong() shl shift
+            return lower + (1L shl shift) - 1
+        }
+    }
+}
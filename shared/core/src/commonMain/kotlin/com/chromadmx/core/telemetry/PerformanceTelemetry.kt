@@ -0,0 +1,68 @@
+package com.chromadmx.core.telemetry
+
+import kotlin.concurrent.Volatile
+
+/**
+ * Production timing histograms for the render, DMX and Link paths.
+ *
+ * One instance is shared through DI. Each histogram has exactly one writer
+ * (named below), so recording stays lock-free; the debug overlay and field
+ * logs read [summary] from any thread.
+ */
+class PerformanceTelemetry {
+
+    /**
+     * Beat-sync error: how far past a beat boundary the first frame
+     * rendered after it was, in microseconds of timeline. Written by the
+     * effect engine loop.
+     */
+    val beatSyncError = LatencyHistogram()
+
+    /**
+     * Time from starting to encode a DMX frame's packets to the transport
+     * returning from sending them. Written by the DMX output loop.
+     */
+    val dmxPackToSend = LatencyHistogram()
+
+    /**
+     * Duration of Link session reads that cross into native code (polls
+     * made without a shared timeline anchor). Written by the Link poll loop.
+     */
+    val linkCall = LatencyHistogram()
+
+    /**
+     * Drift of the Link clock against the monotonic clock since the session
+     * was enabled, sampled on every republished timeline anchor (so
+     * resolution is the anchor tolerance, ~25us at 120 BPM). Written by the
+     * Link poll loop.
+     */
+    val linkClockDrift = LatencyHistogram()
+
+    /** Universe packets sent by the DMX output loop. */
+    @Volatile
+    var dmxUniversesSent: Long = 0L
+        private set
+
+    /**
+     * Universe packets the DMX output loop skipped because the universe had
+     * not changed since its last packet (or keepalive).
+     */
+    @Volatile
+    var dmxUniversesSkipped: Long = 0L
+        private set
+
+    /** Count one DMX frame's sent and skipped universes. Written by the DMX output loop. */
+    fun recordDmxUniverses(sent: Int, skipped: Int) {
+        dmxUniversesSent += sent
+        dmxUniversesSkipped += skipped
+    }
+
+    /** One line per histogram, for logs. */
+    fun summary(): String = buildString {
+        append("beatSync ").append(beatSyncError.summary()).append('\n')
+        append("dmxPackToSend ").append(dmxPackToSend.summary()).append('\n')
+        append("linkCall ").append(linkCall.summary()).append('\n')
+        append("linkClockDrift ").append(linkClockDrift.summary()).append('\n')
+        append("dmxUniverses sent=").append(dmxUniversesSent).append(" skipped=").append(dmxUniversesSkipped)
+    }
+}
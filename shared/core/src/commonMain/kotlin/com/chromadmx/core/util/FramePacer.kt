@@ -0,0 +1,81 @@
+package com.chromadmx.core.util
+
+import kotlinx.coroutines.delay
+import kotlin.time.Duration.Companion.nanoseconds
+import kotlin.time.TimeSource
+
+/**
+ * Drift-free pacing for fixed-rate loops (engine render, DMX output).
+ *
+ * Frame deadlines are absolute — frame n is due at `start + n * interval` —
+ * rather than "interval minus however long this frame took". `delay()` only
+ * resolves whole milliseconds and wakes late under load, but with absolute
+ * deadlines that error is corrected on the next frame instead of
+ * accumulating, so a 40Hz loop really averages 40Hz against the beat.
+ *
+ * If the loop falls more than one interval behind (GC pause, backgrounding)
+ * the missed deadlines are skipped rather than replayed in a burst.
+ *
+ * Not thread-safe: one pacer per loop.
+ *
+ * @param intervalNanos Frame interval in nanoseconds.
+ * @param nanoTime      Monotonic clock in nanoseconds; injectable for tests.
+ */
+class FramePacer(
+    val intervalNanos: Long,
+    private val nanoTime: () -> Long = defaultNanoTime
+) {
+    init {
+        require(intervalNanos > 0) { "intervalNanos must be positive, was $intervalNanos" }
+    }
+
+    private var nextDeadline: Long = nanoTime()
+
+    /** Deadlines skipped because the loop fell more than one frame behind. */
+    var missedFrames: Long = 0L
+        private set
+
+    /** Restart the deadline grid at the current time. */
+    fun reset() {
+        nextDeadline = nanoTime()
+        missedFrames = 0L
+    }
+
+    /**
+     * Advance to the next deadline and return how long to wait for it, in
+     * nanoseconds (0 if it has already passed). Separated from
+     * [awaitNextFrame] so the pacing arithmetic is testable without a clock.
+     */
+    fun advance(): Long {
+        nextDeadline += intervalNanos
+        val now = nanoTime()
+        val late = now - nextDeadline
+        if (late > intervalNanos) {
+            val skipped = late / intervalNanos
+            missedFrames += skipped
+            nextDeadline += skipped * intervalNanos
+        }
+        return (nextDeadline - now).coerceAtLeast(0L)
+    }
+
+    /** Suspend until the next frame deadline. */
+    suspend fun awaitNextFrame() {
+        val waitNanos = advance()
+        if (waitNanos > 0L) delay(waitNanos.nanoseconds)
+    }
+
+    companion object {
+        /** Build a pacer for [hz] frames per second. */
+        fun forRate(hz: Int): FramePacer {
+            require(hz > 0) { "hz must be positive, was $hz" }
+            return FramePacer(NANOS_PER_SECOND / hz)
+        }
+
+        private const val NANOS_PER_SECOND = 1_000_000_000L
+
+        private val monotonicStart = TimeSource.Monotonic.markNow()
+        private val defaultNanoTime: () -> Long = {
+            monotonicStart.elapsedNow().inWholeNanoseconds
+        }
+    }
+}
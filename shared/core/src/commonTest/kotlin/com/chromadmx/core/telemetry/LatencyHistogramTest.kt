@@ -0,0 +1,69 @@
+package com.chromadmx.core.telemetry
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class LatencyHistogramTest {
+
+    @Test
+    fun emptyHistogramReportsZero() {
+        val histogram = LatencyHistogram()
+        assertEquals(0L, histogram.count)
+        assertEquals(0L, histogram.percentile(0.99))
+        assertEquals(0.0, histogram.meanMicros)
+    }
+
+    @Test
+    fun smallValuesAreExact() {
+        val histogram = LatencyHistogram()
+        for (v in 0L until LatencyHistogram.SUB_BUCKETS) histogram.record(v)
+
+        assertEquals(3L, histogram.percentile(0.5))
+        assertEquals(7L, histogram.percentile(1.0))
+        assertEquals(3.5, histogram.meanMicros)
+    }
+
+    @Test
+    fun percentilesStayWithinBucketResolution() {
+        val histogram = LatencyHistogram()
+        for (v in 1L..1000L) histogram.record(v)
+
+        val p50 = histogram.percentile(0.5)
+        val p99 = histogram.percentile(0.99)
+        assertTrue(p50 in 500L..(500L + 500L / LatencyHistogram.SUB_BUCKETS), "p50=$p50")
+        assertTrue(p99 in 990L..1000L, "p99=$p99")
+        assertEquals(1000L, histogram.maxMicros)
+        assertEquals(1000L, histogram.count)
+    }
+
+    @Test
+    fun bucketBoundsContainTheirValues() {
+        for (v in listOf(8L, 9L, 15L, 16L, 17L, 100L, 25_000L, 1_000_000L)) {
+            val bucket = LatencyHistogram.bucketOf(v)
+            assertTrue(LatencyHistogram.upperBoundOf(bucket) >= v, "upper bound below $v")
+            assertTrue(LatencyHistogram.upperBoundOf(bucket - 1) < v, "$v belongs in a lower bucket")
+        }
+    }
+
+    @Test
+    fun outOfRangeValuesAreClamped() {
+        val histogram = LatencyHistogram()
+        histogram.record(-5L)
+        histogram.record(Long.MAX_VALUE)
+
+        assertEquals(0L, histogram.percentile(0.0))
+        assertEquals(LatencyHistogram.MAX_MICROS, histogram.maxMicros)
+    }
+
+    @Test
+    fun clearDropsSamples() {
+        val histogram = LatencyHistogram()
+        histogram.record(1234L)
+        histogram.clear()
+
+        assertEquals(0L, histogram.count)
+        assertEquals(0L, histogram.maxMicros)
+        assertEquals(0L, histogram.percentile(0.5))
+    }
+}
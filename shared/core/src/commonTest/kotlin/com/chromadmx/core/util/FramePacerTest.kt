@@ -0,0 +1,73 @@
+package com.chromadmx.core.util
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertTrue
+
+class FramePacerTest {
+
+    private var now = 0L
+    private val clock: () -> Long = { now }
+
+    @Test
+    fun waitsRemainderOfInterval() {
+        val pacer = FramePacer(25_000_000L, clock)
+        now = 4_000_000L // frame work took 4ms
+        assertEquals(21_000_000L, pacer.advance())
+    }
+
+    @Test
+    fun lateWakeupIsAbsorbedByNextFrame() {
+        val pacer = FramePacer(25_000_000L, clock)
+        pacer.advance()
+        // Woke 3ms late for the first deadline...
+        now = 28_000_000L
+        // ...so the second frame waits 22ms, landing exactly on 50ms.
+        assertEquals(22_000_000L, pacer.advance())
+    }
+
+    @Test
+    fun deadlinesDoNotDriftOverManyFrames() {
+        val pacer = FramePacer(22_727_272L, clock) // 44Hz
+        repeat(1_000) {
+            val wait = pacer.advance()
+            // delay() only has millisecond resolution and always wakes late
+            now += wait + 999_999L - (wait % 1_000_000L)
+        }
+        // After 1000 frames we are still within one ms of 1000 intervals.
+        val ideal = 1_000L * 22_727_272L
+        assertTrue(now - ideal in 0L..1_000_000L, "drifted to ${now - ideal}ns")
+        assertEquals(0L, pacer.missedFrames)
+    }
+
+    @Test
+    fun skipsDeadlinesAfterLongStall() {
+        val pacer = FramePacer(25_000_000L, clock)
+        now = 110_000_000L // stalled through four deadlines
+        val wait = pacer.advance()
+        assertEquals(3L, pacer.missedFrames)
+        assertEquals(0L, wait)
+        // Next deadline is back on the grid, not a burst of catch-up frames.
+        assertEquals(15_000_000L, pacer.advance())
+    }
+
+    @Test
+    fun resetRestartsGrid() {
+        val pacer = FramePacer(25_000_000L, clock)
+        now = 1_000_000_000L
+        pacer.reset()
+        assertEquals(25_000_000L, pacer.advance())
+    }
+
+    @Test
+    fun forRateUsesExactInterval() {
+        assertEquals(22_727_272L, FramePacer.forRate(44).intervalNanos)
+        assertEquals(25_000_000L, FramePacer.forRate(40).intervalNanos)
+    }
+
+    @Test
+    fun rejectsNonPositiveInterval() {
+        assertFailsWith<IllegalArgumentException> { FramePacer(0L, clock) }
+    }
+}
@@ -1,11 +1,13 @@
 package com.chromadmx.engine.bridge
 
 import com.chromadmx.core.model.BuiltInProfiles
+import com.chromadmx.core.model.Channel
 import com.chromadmx.core.model.ChannelType
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Fixture3D
 import com.chromadmx.core.model.FixtureOutput
 import com.chromadmx.core.model.FixtureProfile
+import com.chromadmx.engine.effect.ColorBuffer
 
 /**
  * Converts per-fixture RGB colors from the effect engine into
@@ -17,11 +19,159 @@ import com.chromadmx.core.model.FixtureProfile
  *
  * Also supports [FixtureOutput] for multi-channel fixtures with
  * pan, tilt, gobo, focus, zoom, and strobe channels.
+ *
+ * ## Per-frame cost
+ *
+ * Profiles are resolved once at construction into a patch table (universe
+ * slot and start address per fixture) and compiled into per-role channel
+ * tables. Fixtures are grouped by profile, so a conversion runs one loop
+ * per group that writes whole roles (all red channels, then all green, ...)
+ * instead of switching on the type of every channel; pure RGB layouts (RGB
+ * pars, pixel bars, the no-profile fallback) take a run writer with no
+ * role tables at all. Channels that only ever carry their default come
+ * from a per-universe template copied in at the start of the frame. The
+ * universe byte arrays are preallocated, so a conversion does no profile
+ * lookups and no allocation. Fixtures patched onto the same addresses are
+ * written group by group, not in list order. The returned map and its
+ * arrays are reused and rewritten by the next conversion: hand them
+ * straight to the DMX transport, whose `updateFrame` copies them, or copy
+ * them to keep a frame. Not thread-safe; call from one loop.
  */
 class DmxBridge(
     private val fixtures: List<Fixture3D>,
     private val profiles: Map<String, FixtureProfile> = emptyMap()
 ) {
+    /**
+     * A profile flattened into per-role offset tables so the per-frame loop
+     * never walks [FixtureProfile.channels] or dispatches on channel types.
+     */
+    private class CompiledProfile(profile: FixtureProfile) {
+        val hasRgb: Boolean = profile.hasRgb
+        val hasDimmer: Boolean = profile.channelByType(ChannelType.DIMMER) != null
+
+        val red: IntArray = offsetsOf(profile, ChannelType.RED)
+        val green: IntArray = offsetsOf(profile, ChannelType.GREEN)
+        val blue: IntArray = offsetsOf(profile, ChannelType.BLUE)
+        val dimmer: IntArray = offsetsOf(profile, ChannelType.DIMMER)
+        val white: IntArray = offsetsOf(profile, ChannelType.WHITE)
+
+        val pan: IntArray = offsetsOf(profile, ChannelType.PAN)
+        val tilt: IntArray = offsetsOf(profile, ChannelType.TILT)
+        val panFine: IntArray = offsetsOf(profile, ChannelType.PAN_FINE)
+        val tiltFine: IntArray = offsetsOf(profile, ChannelType.TILT_FINE)
+        val gobo: IntArray = offsetsOf(profile, ChannelType.GOBO)
+        val focus: IntArray = offsetsOf(profile, ChannelType.FOCUS)
+        val zoom: IntArray = offsetsOf(profile, ChannelType.ZOOM)
+        val strobe: IntArray = offsetsOf(profile, ChannelType.STROBE, ChannelType.SHUTTER)
+
+        // Channel defaults (0..1, or raw for gobo), parallel to the role tables above.
+        val panLevels: FloatArray = levelsOf(profile, ChannelType.PAN)
+        val tiltLevels: FloatArray = levelsOf(profile, ChannelType.TILT)
+        val goboDefaults: ByteArray = profile.channels.filter { it.type == ChannelType.GOBO }
+            .map { it.defaultValue.toByte() }.toByteArray()
+        val focusLevels: FloatArray = levelsOf(profile, ChannelType.FOCUS)
+        val zoomLevels: FloatArray = levelsOf(profile, ChannelType.ZOOM)
+        val strobeLevels: FloatArray = levelsOf(profile, ChannelType.STROBE, ChannelType.SHUTTER)
+
+        /** Defaults of the coarse PAN/TILT channels, used by their FINE counterparts. */
+        val panDefault: Float = profile.channelByType(ChannelType.PAN)?.defaultValue?.let { it / 255f } ?: 0f
+        val tiltDefault: Float = profile.channelByType(ChannelType.TILT)?.defaultValue?.let { it / 255f } ?: 0f
+
+        /** Channels [convert] never computes, written from the frame template instead. */
+        val colorStatic: List<Channel> = profile.channels.filter { it.type !in COLOR_ROLES }
+
+        /** Channels [convertOutputs] never computes. */
+        val outputStatic: List<Channel> = profile.channels.filter { it.type !in OUTPUT_ROLES }
+
+        /**
+         * Number of R,G,B triples at offsets 0, 3, 6, ... when red, green and
+         * blue are the only computed color channels (RGB pars, pixel bars);
+         * 0 when the layout needs the role tables.
+         */
+        val rgbRun: Int = rgbRunOf(this)
+    }
+
+    /**
+     * Fixtures that share one writer: [profile] for profiled fixtures, or
+     * null for the plain 3-channel RGB fallback.
+     */
+    private class Group(val profile: CompiledProfile?, val members: IntArray)
+
+    // ---- Patch table (parallel to fixtures) ----
+
+    private val patchSlot = IntArray(fixtures.size)
+    private val patchStart = IntArray(fixtures.size)
+
+    /** Universe IDs in first-seen fixture order; index = universe slot. */
+    private val universeIds: IntArray
+
+    /** Writer groups for [convert] and for [convertOutputs]. */
+    private val colorGroups: Array<Group>
+    private val outputGroups: Array<Group>
+
+    init {
+        val slots = LinkedHashMap<Int, Int>()
+        val compiled = HashMap<String, CompiledProfile?>()
+        val profileOf = arrayOfNulls<CompiledProfile>(fixtures.size)
+        for (i in fixtures.indices) {
+            val fixture = fixtures[i].fixture
+            patchSlot[i] = slots.getOrPut(fixture.universeId) { slots.size }
+            patchStart[i] = fixture.channelStart
+            profileOf[i] = compiled.getOrPut(fixture.profileId) {
+                (profiles[fixture.profileId] ?: BuiltInProfiles.findById(fixture.profileId))
+                    ?.let(::CompiledProfile)
+            }
+        }
+        universeIds = slots.keys.toIntArray()
+        // Profiles without RGB fall back to plain RGB for colors only.
+        colorGroups = groupFixtures { i -> profileOf[i]?.takeIf { it.hasRgb } }
+        outputGroups = groupFixtures { i -> profileOf[i] }
+    }
+
+    private inline fun groupFixtures(key: (Int) -> CompiledProfile?): Array<Group> {
+        val members = LinkedHashMap<CompiledProfile?, MutableList<Int>>()
+        for (i in fixtures.indices) members.getOrPut(key(i)) { ArrayList() }.add(i)
+        return members.map { (profile, list) -> Group(profile, list.toIntArray()) }.toTypedArray()
+    }
+
+    // ---- Preallocated output frame ----
+
+    private val frameData: Array<ByteArray> = Array(universeIds.size) { ByteArray(DMX_UNIVERSE_SIZE) }
+
+    /** Read-only map view over [frameData], built once so returning a frame is free. */
+    private val frameView: Map<Int, ByteArray> = LinkedHashMap<Int, ByteArray>(universeIds.size * 2).also { view ->
+        for (slot in universeIds.indices) view[universeIds[slot]] = frameData[slot]
+    }
+
+    /** Every universe's static channels at their defaults, one template per conversion kind. */
+    private val colorTemplate: Array<ByteArray> = buildTemplate(colorGroups) { it.colorStatic }
+    private val outputTemplate: Array<ByteArray> = buildTemplate(outputGroups) { it.outputStatic }
+
+    private inline fun buildTemplate(groups: Array<Group>, static: (CompiledProfile) -> List<Channel>): Array<ByteArray> {
+        val template = Array(universeIds.size) { ByteArray(DMX_UNIVERSE_SIZE) }
+        for (group in groups) {
+            val channels = static(group.profile ?: continue)
+            for (i in group.members) {
+                val data = template[patchSlot[i]]
+                for (channel in channels) {
+                    val addr = patchStart[i] + channel.offset
+                    if (addr in 0 until DMX_UNIVERSE_SIZE) data[addr] = channel.defaultValue.toByte()
+                }
+            }
+        }
+        return template
+    }
+
+    /** Unpacked input of [convert] for callers passing [Color] objects. */
+    private val colorScratch = ColorBuffer(fixtures.size)
+
+    /** Reset the frame's universes to [template]. */
+    private fun beginFrame(template: Array<ByteArray>): Array<ByteArray> {
+        val universes = frameData
+        for (slot in universes.indices) template[slot].copyInto(universes[slot])
+        return universes
+    }
+
     /**
      * Convert an array of per-fixture colors into per-universe DMX data.
      *
@@ -31,24 +181,35 @@ class DmxBridge(
     fun convert(colors: Array<Color>): Map<Int, ByteArray> {
         if (fixtures.isEmpty()) return emptyMap()
 
-        val universes = mutableMapOf<Int, ByteArray>()
+        val buffer = colorScratch
+        for (i in fixtures.indices) buffer[i] = colors.getOrElse(i) { Color.BLACK }
+        return convert(buffer)
+    }
 
-        for (i in fixtures.indices) {
-            val fixture = fixtures[i].fixture
-            val color = colors.getOrElse(i) { Color.BLACK }
-            val data = universes.getOrPut(fixture.universeId) { ByteArray(512) }
-            val profile = profiles[fixture.profileId]
-                ?: BuiltInProfiles.findById(fixture.profileId)
+    /**
+     * Convert a primitive [ColorBuffer] (the engine's `colorFrames`) into
+     * per-universe DMX data. Same output as [convert] on the equivalent
+     * [Color] array, without reading a single per-fixture object.
+     *
+     * @param colors One entry per fixture, parallel to the [fixtures] list;
+     *               fixtures beyond its size are black.
+     * @return Map of universe ID to 512-byte DMX channel data.
+     */
+    fun convert(colors: ColorBuffer): Map<Int, ByteArray> {
+        if (fixtures.isEmpty()) return emptyMap()
 
-            if (profile != null && profile.hasRgb) {
-                writeProfileChannels(data, fixture.channelStart, profile, color)
-            } else {
-                // Fallback: write as simple 3-channel RGB
-                writeSimpleRgb(data, fixture.channelStart, color)
+        val universes = beginFrame(colorTemplate)
+
+        for (group in colorGroups) {
+            val profile = group.profile
+            when {
+                profile == null -> writeRgbRuns(universes, group.members, 1, colors)
+                profile.rgbRun > 0 -> writeRgbRuns(universes, group.members, profile.rgbRun, colors)
+                else -> writeColorRoles(universes, group.members, profile, colors)
             }
         }
 
-        return universes
+        return frameView
     }
 
     /**
@@ -62,171 +223,180 @@ class DmxBridge(
     fun convertOutputs(outputs: Array<FixtureOutput>): Map<Int, ByteArray> {
         if (fixtures.isEmpty()) return emptyMap()
 
-        val universes = mutableMapOf<Int, ByteArray>()
+        val universes = beginFrame(outputTemplate)
 
-        for (i in fixtures.indices) {
-            val fixture = fixtures[i].fixture
-            val output = outputs.getOrElse(i) { FixtureOutput.DEFAULT }
-            val data = universes.getOrPut(fixture.universeId) { ByteArray(512) }
-            val profile = profiles[fixture.profileId]
-                ?: BuiltInProfiles.findById(fixture.profileId)
-
-            if (profile != null) {
-                writeProfileChannelsWithOutput(data, fixture.channelStart, profile, output)
-            } else {
-                // Fallback: write color as simple 3-channel RGB
-                writeSimpleRgb(data, fixture.channelStart, output.color)
+        for (group in outputGroups) {
+            val profile = group.profile
+            for (i in group.members) {
+                val output = outputs.getOrElse(i) { FixtureOutput.DEFAULT }
+                val data = universes[patchSlot[i]]
+                if (profile != null) {
+                    writeOutputRoles(data, patchStart[i], profile, output)
+                } else {
+                    // Fallback: write color as simple 3-channel RGB
+                    writeSimpleRgb(data, patchStart[i], output.color.r, output.color.g, output.color.b)
+                }
             }
         }
 
-        return universes
+        return frameView
     }
 
-    private fun writeProfileChannels(
-        data: ByteArray,
-        channelStart: Int,
-        profile: FixtureProfile,
-        color: Color
-    ) {
-        // Optimization: bypass clamped() to prevent allocating a Color object per fixture per frame
-        val cr = color.r.coerceIn(0f, 1f)
-        val cg = color.g.coerceIn(0f, 1f)
-        val cb = color.b.coerceIn(0f, 1f)
+    // ---- Writers ----
 
-        val hasDimmer = profile.channelByType(ChannelType.DIMMER) != null
-        val brightness = maxOf(cr, cg, cb)
+    /** R,G,B written [cells] times over, for each fixture in [members]. */
+    private fun writeRgbRuns(universes: Array<ByteArray>, members: IntArray, cells: Int, colors: ColorBuffer) {
+        val r = colors.r
+        val g = colors.g
+        val b = colors.b
+        val count = colors.size
+        val footprint = cells * 3
 
-        for (channel in profile.channels) {
-            val addr = channelStart + channel.offset
-            if (addr < 0 || addr >= 512) continue
+        for (i in members) {
+            val data = universes[patchSlot[i]]
+            val start = patchStart[i]
+            // Optimization: bypass clamped() to prevent allocating a Color object per fixture per frame
+            val dr: Byte = if (i < count) toDmx(r[i].coerceIn(0f, 1f)) else 0
+            val dg: Byte = if (i < count) toDmx(g[i].coerceIn(0f, 1f)) else 0
+            val db: Byte = if (i < count) toDmx(b[i].coerceIn(0f, 1f)) else 0
 
-            data[addr] = when (channel.type) {
-                ChannelType.RED -> {
-                    val value = if (hasDimmer && brightness > 0f) cr / brightness else cr
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.GREEN -> {
-                    val value = if (hasDimmer && brightness > 0f) cg / brightness else cg
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.BLUE -> {
-                    val value = if (hasDimmer && brightness > 0f) cb / brightness else cb
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.DIMMER -> {
-                    (brightness * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+            if (start >= 0 && start + footprint <= DMX_UNIVERSE_SIZE) {
+                var addr = start
+                repeat(cells) {
+                    data[addr] = dr
+                    data[addr + 1] = dg
+                    data[addr + 2] = db
+                    addr += 3
                 }
-                ChannelType.WHITE -> {
-                    // White = minimum of RGB (conservative approach)
-                    val white = minOf(cr, cg, cb)
-                    (white * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+            } else {
+                for (cell in 0 until cells) {
+                    val addr = start + cell * 3
+                    putAt(data, addr, dr)
+                    putAt(data, addr + 1, dg)
+                    putAt(data, addr + 2, db)
                 }
-                ChannelType.STROBE -> channel.defaultValue.toByte()
-                else -> channel.defaultValue.toByte()
             }
         }
     }
 
-    private fun writeProfileChannelsWithOutput(
-        data: ByteArray,
-        channelStart: Int,
-        profile: FixtureProfile,
-        output: FixtureOutput
-    ) {
-        // Optimization: bypass clamped() to prevent allocating a Color object per fixture per frame
-        val cr = output.color.r.coerceIn(0f, 1f)
-        val cg = output.color.g.coerceIn(0f, 1f)
-        val cb = output.color.b.coerceIn(0f, 1f)
+    /** Red, green, blue, dimmer and white roles for each fixture in [members]. */
+    private fun writeColorRoles(universes: Array<ByteArray>, members: IntArray, profile: CompiledProfile, colors: ColorBuffer) {
+        val count = colors.size
+        for (i in members) {
+            val inRange = i < count
+            writeColorRoles(
+                universes[patchSlot[i]], patchStart[i], profile,
+                if (inRange) colors.r[i] else 0f,
+                if (inRange) colors.g[i] else 0f,
+                if (inRange) colors.b[i] else 0f
+            )
+        }
+    }
 
-        val hasDimmer = profile.channelByType(ChannelType.DIMMER) != null
+    private fun writeColorRoles(data: ByteArray, start: Int, profile: CompiledProfile, r: Float, g: Float, b: Float) {
+        // Optimization: bypass clamped() to prevent allocating a Color object per fixture per frame
+        val cr = r.coerceIn(0f, 1f)
+        val cg = g.coerceIn(0f, 1f)
+        val cb = b.coerceIn(0f, 1f)
         val brightness = maxOf(cr, cg, cb)
+        val normalize = profile.hasDimmer && brightness > 0f
 
-        for (channel in profile.channels) {
-            val addr = channelStart + channel.offset
-            if (addr < 0 || addr >= 512) continue
+        putAll(data, start, profile.red, toDmx(if (normalize) cr / brightness else cr))
+        putAll(data, start, profile.green, toDmx(if (normalize) cg / brightness else cg))
+        putAll(data, start, profile.blue, toDmx(if (normalize) cb / brightness else cb))
+        putAll(data, start, profile.dimmer, toDmx(brightness))
+        // White = minimum of RGB (conservative approach)
+        putAll(data, start, profile.white, toDmx(minOf(cr, cg, cb)))
+    }
 
-            data[addr] = when (channel.type) {
-                ChannelType.RED -> {
-                    val value = if (hasDimmer && brightness > 0f) cr / brightness else cr
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.GREEN -> {
-                    val value = if (hasDimmer && brightness > 0f) cg / brightness else cg
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.BLUE -> {
-                    val value = if (hasDimmer && brightness > 0f) cb / brightness else cb
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.DIMMER -> {
-                    (brightness * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.WHITE -> {
-                    val white = minOf(cr, cg, cb)
-                    (white * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.PAN -> {
-                    // Compute full 16-bit value; coarse channel = MSB
-                    val coarseDefault = channel.defaultValue / 255f
-                    val value = output.pan ?: coarseDefault
-                    val full16 = (value * 65535f + 0.5f).toInt().coerceIn(0, 65535)
-                    (full16 shr 8 and 0xFF).toByte()
-                }
-                ChannelType.TILT -> {
-                    // Compute full 16-bit value; coarse channel = MSB
-                    val coarseDefault = channel.defaultValue / 255f
-                    val value = output.tilt ?: coarseDefault
-                    val full16 = (value * 65535f + 0.5f).toInt().coerceIn(0, 65535)
-                    (full16 shr 8 and 0xFF).toByte()
-                }
-                ChannelType.PAN_FINE -> {
-                    // Fine channel = LSB of 16-bit value; derive default from coarse PAN channel
-                    val coarseDefault = profile.channelByType(ChannelType.PAN)?.defaultValue?.let { it / 255f } ?: 0f
-                    val value = output.pan ?: coarseDefault
-                    val full16 = (value * 65535f + 0.5f).toInt().coerceIn(0, 65535)
-                    (full16 and 0xFF).toByte()
-                }
-                ChannelType.TILT_FINE -> {
-                    // Fine channel = LSB of 16-bit value; derive default from coarse TILT channel
-                    val coarseDefault = profile.channelByType(ChannelType.TILT)?.defaultValue?.let { it / 255f } ?: 0f
-                    val value = output.tilt ?: coarseDefault
-                    val full16 = (value * 65535f + 0.5f).toInt().coerceIn(0, 65535)
-                    (full16 and 0xFF).toByte()
-                }
-                ChannelType.GOBO -> {
-                    output.gobo?.coerceIn(0, 255)?.toByte() ?: channel.defaultValue.toByte()
-                }
-                ChannelType.FOCUS -> {
-                    val value = output.focus ?: (channel.defaultValue / 255f)
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.ZOOM -> {
-                    val value = output.zoom ?: (channel.defaultValue / 255f)
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                ChannelType.STROBE, ChannelType.SHUTTER -> {
-                    val value = output.strobeRate ?: (channel.defaultValue / 255f)
-                    (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
-                }
-                else -> channel.defaultValue.toByte()
-            }
+    private fun writeOutputRoles(data: ByteArray, start: Int, profile: CompiledProfile, output: FixtureOutput) {
+        val color = output.color
+        writeColorRoles(data, start, profile, color.r, color.g, color.b)
+
+        // 16-bit movement: coarse channel = MSB, fine channel = LSB.
+        // Fine channels default from their coarse channel.
+        val pan = output.pan
+        val tilt = output.tilt
+        val panCoarse = profile.pan
+        for (k in panCoarse.indices) {
+            putAt(data, start + panCoarse[k], (toDmx16(pan ?: profile.panLevels[k]) shr 8).toByte())
+        }
+        val tiltCoarse = profile.tilt
+        for (k in tiltCoarse.indices) {
+            putAt(data, start + tiltCoarse[k], (toDmx16(tilt ?: profile.tiltLevels[k]) shr 8).toByte())
         }
+        putAll(data, start, profile.panFine, (toDmx16(pan ?: profile.panDefault) and 0xFF).toByte())
+        putAll(data, start, profile.tiltFine, (toDmx16(tilt ?: profile.tiltDefault) and 0xFF).toByte())
+
+        val gobo = output.gobo?.coerceIn(0, 255)?.toByte()
+        val goboChannels = profile.gobo
+        for (k in goboChannels.indices) putAt(data, start + goboChannels[k], gobo ?: profile.goboDefaults[k])
+
+        putLevels(data, start, profile.focus, profile.focusLevels, output.focus)
+        putLevels(data, start, profile.zoom, profile.zoomLevels, output.zoom)
+        putLevels(data, start, profile.strobe, profile.strobeLevels, output.strobeRate)
     }
 
-    private fun writeSimpleRgb(data: ByteArray, channelStart: Int, color: Color) {
+    private fun writeSimpleRgb(data: ByteArray, channelStart: Int, r: Float, g: Float, b: Float) {
         // Optimization: prevent allocating a ByteArray and Color per fixture per frame by manually coercing
-        val cr = color.r.coerceIn(0f, 1f)
-        val cg = color.g.coerceIn(0f, 1f)
-        val cb = color.b.coerceIn(0f, 1f)
+        putAt(data, channelStart, toDmx(r.coerceIn(0f, 1f)))
+        putAt(data, channelStart + 1, toDmx(g.coerceIn(0f, 1f)))
+        putAt(data, channelStart + 2, toDmx(b.coerceIn(0f, 1f)))
+    }
 
-        if (channelStart in 0 until 512) {
-            data[channelStart] = (cr * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+    companion object {
+        /** Channels per DMX universe. */
+        private const val DMX_UNIVERSE_SIZE = 512
+
+        /** Channel types [convert] computes from the color. */
+        private val COLOR_ROLES = setOf(
+            ChannelType.RED, ChannelType.GREEN, ChannelType.BLUE, ChannelType.DIMMER, ChannelType.WHITE
+        )
+
+        /** Channel types [convertOutputs] computes from a [FixtureOutput]. */
+        private val OUTPUT_ROLES = COLOR_ROLES + setOf(
+            ChannelType.PAN, ChannelType.TILT, ChannelType.PAN_FINE, ChannelType.TILT_FINE,
+            ChannelType.GOBO, ChannelType.FOCUS, ChannelType.ZOOM, ChannelType.STROBE, ChannelType.SHUTTER
+        )
+
+        private fun offsetsOf(profile: FixtureProfile, vararg types: ChannelType): IntArray =
+            profile.channels.filter { it.type in types }.map { it.offset }.toIntArray()
+
+        private fun levelsOf(profile: FixtureProfile, vararg types: ChannelType): FloatArray =
+            profile.channels.filter { it.type in types }.map { it.defaultValue / 255f }.toFloatArray()
+
+        private fun rgbRunOf(profile: CompiledProfile): Int {
+            val cells = profile.red.size
+            if (profile.hasDimmer || profile.white.isNotEmpty()) return 0
+            if (cells == 0 || profile.green.size != cells || profile.blue.size != cells) return 0
+            for (cell in 0 until cells) {
+                if (profile.red[cell] != cell * 3 ||
+                    profile.green[cell] != cell * 3 + 1 ||
+                    profile.blue[cell] != cell * 3 + 2
+                ) return 0
+            }
+            return cells
         }
-        if (channelStart + 1 in 0 until 512) {
-            data[channelStart + 1] = (cg * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+
+        private fun putAt(data: ByteArray, addr: Int, value: Byte) {
+            if (addr in 0 until DMX_UNIVERSE_SIZE) data[addr] = value
+        }
+
+        private fun putAll(data: ByteArray, start: Int, offsets: IntArray, value: Byte) {
+            for (k in offsets.indices) putAt(data, start + offsets[k], value)
         }
-        if (channelStart + 2 in 0 until 512) {
-            data[channelStart + 2] = (cb * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+
+        /** Write [value], or each channel's own default level when it is null. */
+        private fun putLevels(data: ByteArray, start: Int, offsets: IntArray, defaults: FloatArray, value: Float?) {
+            for (k in offsets.indices) putAt(data, start + offsets[k], toDmx(value ?: defaults[k]))
         }
+
+        /** Quantize a 0..1 value to an 8-bit DMX level. */
+        private fun toDmx(value: Float): Byte =
+            (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+
+        /** Quantize a 0..1 value to a 16-bit coarse/fine DMX pair. */
+        private fun toDmx16(value: Float): Int =
+            (value * 65535f + 0.5f).toInt().coerceIn(0, 65535)
     }
 }
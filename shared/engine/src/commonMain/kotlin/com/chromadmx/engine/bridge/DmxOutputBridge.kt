@@ -1,6 +1,6 @@
 package com.chromadmx.engine.bridge
 
-import com.chromadmx.core.model.Color
+import com.chromadmx.engine.effect.ColorBuffer
 import com.chromadmx.engine.pipeline.TripleBuffer
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
@@ -14,17 +14,29 @@ import kotlinx.coroutines.launch
  * and feeds converted DMX data to an output callback.
  *
  * Runs at a configurable rate (default 40Hz to match DMX output).
+ *
+ * When [colorFramesProvider] is set (the engine's `colorFrames`), frames
+ * are read from it instead of [colorOutputProvider], leaving the engine's
+ * `colorOutput` to its other reader (the UI). Both are primitive
+ * [ColorBuffer] triple buffers, so no per-fixture objects cross from the
+ * engine loop to the DMX loop.
+ *
+ * When [dmxBridgeProvider] is set, it supplies the bridge for each frame
+ * instead of [dmxBridge], so the patch can follow an engine whose
+ * fixture list changes (e.g. a render shard being re-assigned).
  */
 class DmxOutputBridge(
-    private val colorOutputProvider: () -> TripleBuffer<Array<Color>>,
+    private val colorOutputProvider: () -> TripleBuffer<ColorBuffer>,
     private val dmxBridge: DmxBridge,
     private val onFrame: (Map<Int, ByteArray>) -> Unit,
     private val scope: CoroutineScope,
-    private val intervalMs: Long = 25L // 40Hz
+    private val intervalMs: Long = 25L, // 40Hz
+    private val colorFramesProvider: (() -> TripleBuffer<ColorBuffer>)? = null,
+    private val dmxBridgeProvider: (() -> DmxBridge)? = null
 ) {
     @Deprecated("Use the provider overload", level = DeprecationLevel.HIDDEN)
     constructor(
-        colorOutput: TripleBuffer<Array<Color>>,
+        colorOutput: TripleBuffer<ColorBuffer>,
         dmxBridge: DmxBridge,
         onFrame: (Map<Int, ByteArray>) -> Unit,
         scope: CoroutineScope,
@@ -38,19 +50,27 @@ class DmxOutputBridge(
         if (isRunning) return
         job = scope.launch(Dispatchers.Default) {
             while (isActive) {
-                val colorOutput = colorOutputProvider()
-                if (colorOutput.swapRead()) {
-                    val colors = colorOutput.readSlot()
-                    val frame = dmxBridge.convert(colors)
-                    if (frame.isNotEmpty()) {
-                        onFrame(frame)
-                    }
+                val frame = nextFrame()
+                if (frame != null && frame.isNotEmpty()) {
+                    onFrame(frame)
                 }
                 delay(intervalMs)
             }
         }
     }
 
+    /** Convert the engine's latest frame, or null if nothing new was published. */
+    private fun nextFrame(): Map<Int, ByteArray>? {
+        val bridge = dmxBridgeProvider?.invoke() ?: dmxBridge
+        val framesProvider = colorFramesProvider
+        if (framesProvider != null) {
+            val colorFrames = framesProvider()
+            return if (colorFrames.swapRead()) bridge.convert(colorFrames.readSlot()) else null
+        }
+        val colorOutput = colorOutputProvider()
+        return if (colorOutput.swapRead()) bridge.convert(colorOutput.readSlot()) else null
+    }
+
     fun stop() {
         job?.cancel()
         job = null
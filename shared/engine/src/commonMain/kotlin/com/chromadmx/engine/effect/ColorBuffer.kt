@@ -0,0 +1,166 @@
+package com.chromadmx.engine.effect
+
+import com.chromadmx.core.model.BlendMode
+import com.chromadmx.core.model.Color
+
+/**
+ * Per-fixture RGB colors laid out as structure-of-arrays.
+ *
+ * Batch evaluation writes each layer into a [ColorBuffer] and composites
+ * it onto an accumulator with [blendFrom], so a frame allocates no [Color]
+ * objects until the caller reads results back out.
+ *
+ * Not thread-safe: one buffer per evaluating loop.
+ *
+ * @property size Number of colors.
+ */
+class ColorBuffer(val size: Int) {
+
+    val r: FloatArray = FloatArray(size)
+    val g: FloatArray = FloatArray(size)
+    val b: FloatArray = FloatArray(size)
+
+    operator fun get(index: Int): Color = Color(r[index], g[index], b[index])
+
+    operator fun set(index: Int, color: Color) {
+        r[index] = color.r
+        g[index] = color.g
+        b[index] = color.b
+    }
+
+    fun set(index: Int, red: Float, green: Float, blue: Float) {
+        r[index] = red
+        g[index] = green
+        b[index] = blue
+    }
+
+    /** Copy the first `min(size, other.size)` entries of [other] into this buffer. */
+    fun copyFrom(other: ColorBuffer) {
+        val n = minOf(size, other.size)
+        other.r.copyInto(r, endIndex = n)
+        other.g.copyInto(g, endIndex = n)
+        other.b.copyInto(b, endIndex = n)
+    }
+
+    /** Every entry as a [Color], allocating one per entry; for readers off the frame loop (e.g. the UI). */
+    fun toList(): List<Color> = List(size) { get(it) }
+
+    /** Set every entry to [color]. */
+    fun fill(color: Color) {
+        r.fill(color.r)
+        g.fill(color.g)
+        b.fill(color.b)
+    }
+
+    /** Set entry [index] to `color * scalar`, matching [Color.times]. */
+    fun setScaled(index: Int, color: Color, scalar: Float) {
+        r[index] = color.r * scalar
+        g[index] = color.g * scalar
+        b[index] = color.b * scalar
+    }
+
+    /** Set entry [index] to `from.lerp(to, t)`, matching [Color.lerp]. */
+    fun setLerp(index: Int, from: Color, to: Color, t: Float) {
+        val ct = t.coerceIn(0f, 1f)
+        r[index] = from.r + (to.r - from.r) * ct
+        g[index] = from.g + (to.g - from.g) * ct
+        b[index] = from.b + (to.b - from.b) * ct
+    }
+
+    /**
+     * Set entry [index] to a palette sample at [t], matching
+     * `ColorUtils.samplePalette` without allocating the result.
+     */
+    fun setPaletteSample(index: Int, palette: List<Color>, t: Float) {
+        if (palette.isEmpty()) {
+            set(index, 0f, 0f, 0f)
+            return
+        }
+        if (palette.size == 1) {
+            set(index, palette[0])
+            return
+        }
+        val clamped = t.coerceIn(0f, 1f)
+        val maxIdx = palette.size - 1
+        val scaled = clamped * maxIdx
+        val lo = scaled.toInt().coerceIn(0, maxIdx - 1)
+        val hi = (lo + 1).coerceAtMost(maxIdx)
+        setLerp(index, palette[lo], palette[hi], scaled - lo)
+    }
+
+    /**
+     * Composite [overlay] onto this buffer in place, entry by entry.
+     *
+     * Produces exactly what `ColorBlending.blend(this[i], overlay[i], mode, opacity)`
+     * would, so batch and per-pixel evaluation render identically.
+     */
+    fun blendFrom(overlay: ColorBuffer, mode: BlendMode, opacity: Float) {
+        if (opacity <= 0f) return
+        val op = opacity.coerceIn(0f, 1f)
+        val n = minOf(size, overlay.size)
+        val ovR = overlay.r
+        val ovG = overlay.g
+        val ovB = overlay.b
+
+        if (mode == BlendMode.NORMAL && op >= 1f) {
+            for (i in 0 until n) {
+                r[i] = ovR[i].coerceIn(0f, 1f)
+                g[i] = ovG[i].coerceIn(0f, 1f)
+                b[i] = ovB[i].coerceIn(0f, 1f)
+            }
+            return
+        }
+
+        for (i in 0 until n) {
+            val br = r[i]
+            val bg = g[i]
+            val bb = b[i]
+            val mr: Float
+            val mg: Float
+            val mb: Float
+            when (mode) {
+                BlendMode.NORMAL -> {
+                    mr = ovR[i]
+                    mg = ovG[i]
+                    mb = ovB[i]
+                }
+                BlendMode.ADDITIVE -> {
+                    mr = br + ovR[i]
+                    mg = bg + ovG[i]
+                    mb = bb + ovB[i]
+                }
+                BlendMode.MULTIPLY -> {
+                    mr = br * ovR[i]
+                    mg = bg * ovG[i]
+                    mb = bb * ovB[i]
+                }
+                BlendMode.OVERLAY -> {
+                    mr = overlayChannel(br, ovR[i])
+                    mg = overlayChannel(bg, ovG[i])
+                    mb = overlayChannel(bb, ovB[i])
+                }
+            }
+            r[i] = (br + (mr - br) * op).coerceIn(0f, 1f)
+            g[i] = (bg + (mg - bg) * op).coerceIn(0f, 1f)
+            b[i] = (bb + (mb - bb) * op).coerceIn(0f, 1f)
+        }
+    }
+
+    /** Multiply every entry by [dimmer], matching the stack's master dimmer. */
+    fun applyDimmer(dimmer: Float) {
+        if (dimmer >= 1f) return
+        if (dimmer <= 0f) {
+            fill(Color.BLACK)
+            return
+        }
+        for (i in 0 until size) {
+            r[i] *= dimmer
+            g[i] *= dimmer
+            b[i] *= dimmer
+        }
+    }
+
+    private fun overlayChannel(base: Float, overlay: Float): Float =
+        if (base < 0.5f) 2f * base * overlay
+        else 1f - 2f * (1f - base) * (1f - overlay)
+}
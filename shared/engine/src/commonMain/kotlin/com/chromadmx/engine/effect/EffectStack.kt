@@ -143,34 +143,78 @@ class EffectStack(
      * The returned [FrameEvaluator] can then be used to compute colors for
      * multiple positions very efficiently.
      */
-    fun buildFrame(time: Float, beat: BeatState): FrameEvaluator {
-        val colorSnapshot = _layersRef.value
-        val colorContexts = colorSnapshot.map { layer ->
-            if (layer.enabled) layer.effect.prepare(layer.params, time, beat) else null
-        }
+    fun buildFrame(time: Float, beat: BeatState): FrameEvaluator = buildFrame(time, beat, FrameEvaluator())
 
+    /**
+     * Like [buildFrame], but refills [into] instead of allocating a new
+     * evaluator, so a loop that keeps one evaluator (the engine's
+     * [com.chromadmx.engine.pipeline.FrameWorkspace]) prepares each frame
+     * without allocating anything beyond what the effects' `prepare` does.
+     * Whatever [into] held for the previous frame is discarded.
+     */
+    fun buildFrame(time: Float, beat: BeatState, into: FrameEvaluator): FrameEvaluator {
+        val colorSnapshot = _layersRef.value
         val movementSnapshot = _movementLayersRef.value
-        val movementContexts = movementSnapshot.map { layer ->
-            if (layer.enabled) layer.effect.prepare(layer.params, time, beat) else null
-        }
+        into.reset(colorSnapshot, movementSnapshot, _masterDimmer.value)
 
-        return FrameEvaluator(
-            colorSnapshot, colorContexts,
-            movementSnapshot, movementContexts,
-            _masterDimmer.value
-        )
+        for (i in colorSnapshot.indices) {
+            val layer = colorSnapshot[i]
+            into.colorContexts.add(if (layer.enabled) layer.effect.prepare(layer.params, time, beat) else null)
+        }
+        for (i in movementSnapshot.indices) {
+            val layer = movementSnapshot[i]
+            into.movementContexts.add(if (layer.enabled) layer.effect.prepare(layer.params, time, beat) else null)
+        }
+        return into
     }
 
     /**
      * Evaluator for a single frame. Contains pre-calculated contexts for all layers.
+     *
+     * An evaluator may be refilled for the next frame with
+     * [EffectStack.buildFrame]; its context lists keep their capacity, so
+     * reuse allocates nothing once the layer count has been seen.
      */
-    class FrameEvaluator(
-        private val colorLayers: List<EffectLayer>,
-        private val colorContexts: List<Any?>,
-        private val movementLayers: List<MovementLayer>,
-        private val movementContexts: List<Any?>,
-        private val masterDimmer: Float
-    ) {
+    class FrameEvaluator() {
+        private var colorLayers: List<EffectLayer> = emptyList()
+        internal val colorContexts = ArrayList<Any?>()
+        private var movementLayers: List<MovementLayer> = emptyList()
+        internal val movementContexts = ArrayList<Any?>()
+        private var masterDimmer = 1f
+
+        /** Whether this frame has any movement layers. */
+        var hasMovementLayers: Boolean = false
+            private set
+
+        constructor(
+            colorLayers: List<EffectLayer>,
+            colorContexts: List<Any?>,
+            movementLayers: List<MovementLayer>,
+            movementContexts: List<Any?>,
+            masterDimmer: Float
+        ) : this() {
+            reset(colorLayers, movementLayers, masterDimmer)
+            this.colorContexts.addAll(colorContexts)
+            this.movementContexts.addAll(movementContexts)
+        }
+
+        /** Start a new frame over these layers; contexts are added by the caller. */
+        internal fun reset(colorLayers: List<EffectLayer>, movementLayers: List<MovementLayer>, masterDimmer: Float) {
+            this.colorLayers = colorLayers
+            this.movementLayers = movementLayers
+            this.masterDimmer = masterDimmer
+            colorContexts.clear()
+            movementContexts.clear()
+            var movement = false
+            for (i in movementLayers.indices) {
+                if (movementLayers[i].enabled) {
+                    movement = true
+                    break
+                }
+            }
+            hasMovementLayers = movement
+        }
+
         /**
          * Evaluate the color stack only. Backward-compatible method.
          */
@@ -203,15 +247,57 @@ class EffectStack(
             )
         }
 
+        /**
+         * Evaluate the color stack for every position at once.
+         *
+         * Each enabled layer is computed with [SpatialEffect.computeBatch]
+         * into [scratch] and composited onto [out], giving the same colors
+         * as calling [evaluate] per position with no per-pixel allocation.
+         *
+         * @param positions Fixture positions, structure-of-arrays.
+         * @param out       Receives the final colors; at least `positions.size` entries.
+         * @param scratch   Per-layer working buffer, same size as [out].
+         */
+        fun evaluateBatch(positions: PositionBuffer, out: ColorBuffer, scratch: ColorBuffer) {
+            out.fill(Color.BLACK)
+
+            for (i in colorLayers.indices) {
+                val layer = colorLayers[i]
+                if (!layer.enabled || layer.opacity <= 0f) continue
+
+                layer.effect.computeBatch(positions, colorContexts[i], scratch)
+                out.blendFrom(scratch, layer.blendMode, layer.opacity)
+            }
+
+            out.applyDimmer(masterDimmer)
+        }
+
         /**
          * Evaluate the full fixture output including color and movement layers.
          *
          * Color layers are composited first, then movement layers are
          * composited onto a [FixtureOutput] that starts with the computed color.
          */
-        fun evaluateFixtureOutput(pos: Vec3): FixtureOutput {
-            // First evaluate color stack
-            val color = evaluate(pos)
+        fun evaluateFixtureOutput(pos: Vec3): FixtureOutput = composeOutput(pos, evaluate(pos), null)
+
+        /**
+         * Composite the movement layers at [pos] onto entry [index] of
+         * [colors], e.g. a buffer filled by [evaluateBatch].
+         *
+         * [previous] is the output this fixture's slot held before. It is
+         * returned as is when nothing changed, and its [Color] is kept when
+         * only movement did, so a held look allocates nothing per fixture.
+         */
+        fun evaluateFixtureOutput(pos: Vec3, colors: ColorBuffer, index: Int, previous: FixtureOutput): FixtureOutput {
+            val held = previous.color
+            val r = colors.r[index]
+            val g = colors.g[index]
+            val b = colors.b[index]
+            val color = if (held.r == r && held.g == g && held.b == b) held else Color(r, g, b)
+            return composeOutput(pos, color, previous)
+        }
+
+        private fun composeOutput(pos: Vec3, color: Color, previous: FixtureOutput?): FixtureOutput {
 
             // Optimization: Avoid allocating intermediate FixtureOutput instances per movement layer
             // by accumulating properties individually and constructing the final object once.
@@ -239,6 +325,11 @@ class EffectStack(
                 strobeRate = FixtureOutput.blendFloat(strobeRate, layerOutput.strobeRate, mode, op)
             }
 
+            if (previous != null && previous.color === color && previous.pan == pan &&
+                previous.tilt == tilt && previous.gobo == gobo && previous.focus == focus &&
+                previous.zoom == zoom && previous.strobeRate == strobeRate
+            ) return previous
+
             return FixtureOutput(
                 color = color,
                 pan = pan,
@@ -249,9 +340,6 @@ class EffectStack(
                 strobeRate = strobeRate
             )
         }
-
-        /** Whether this frame has any movement layers. */
-        val hasMovementLayers: Boolean get() = movementLayers.any { it.enabled }
     }
 
     /**
@@ -0,0 +1,36 @@
+package com.chromadmx.engine.effect
+
+import com.chromadmx.core.model.Vec3
+
+/**
+ * Fixture positions laid out as structure-of-arrays for batch evaluation.
+ *
+ * [x], [y] and [z] hold one coordinate per fixture, so the inner loop of a
+ * [SpatialEffect.computeBatch] override streams through flat float arrays
+ * instead of chasing one [Vec3] object per pixel. [points] keeps the
+ * original vectors for effects that fall back to per-pixel [SpatialEffect.compute].
+ *
+ * Built once per fixture snapshot and never mutated.
+ *
+ * @property points Positions as vectors, parallel to the coordinate arrays.
+ */
+class PositionBuffer(val points: List<Vec3>) {
+
+    /** Number of positions. */
+    val size: Int = points.size
+
+    val x: FloatArray = FloatArray(size) { points[it].x }
+    val y: FloatArray = FloatArray(size) { points[it].y }
+    val z: FloatArray = FloatArray(size) { points[it].z }
+
+    /** Coordinate array for a named axis ("x", "y" or "z"; anything else is x). */
+    fun axis(name: String): FloatArray = when (name) {
+        "y" -> y
+        "z" -> z
+        else -> x
+    }
+
+    companion object {
+        val EMPTY = PositionBuffer(emptyList())
+    }
+}
@@ -43,4 +43,24 @@ interface SpatialEffect {
         pos: Vec3,
         context: Any?
     ): Color
+
+    /**
+     * Compute this effect for every position in [positions], writing
+     * entry `i` of [out] for position `i`.
+     *
+     * The default calls [compute] per position. Built-in effects override
+     * it with a loop over the flat coordinate arrays that produces
+     * identical colors without per-pixel allocation; custom effects get
+     * the fallback for free.
+     *
+     * @param positions Fixture positions, structure-of-arrays.
+     * @param context   The context object returned by [prepare].
+     * @param out       Destination, at least `positions.size` entries.
+     */
+    fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val points = positions.points
+        for (i in 0 until positions.size) {
+            out[i] = compute(points[i], context)
+        }
+    }
 }
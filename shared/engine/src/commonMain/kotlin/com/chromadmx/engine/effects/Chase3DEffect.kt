@@ -5,6 +5,8 @@ import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
 import com.chromadmx.core.util.MathUtils
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import kotlin.math.abs
 import kotlin.math.max
@@ -72,6 +74,17 @@ class Chase3DEffect : SpatialEffect {
         return ctx.color * brightness
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        val axis = positions.axis(ctx.axis)
+        val headPos = MathUtils.wrap(ctx.time * ctx.speed, 1f)
+        for (i in 0 until positions.size) {
+            val wrappedDist = MathUtils.wrap(axis[i] - headPos, 1f)
+            val brightness = if (wrappedDist <= ctx.tail) 1f - (wrappedDist / ctx.tail) else 0f
+            out.setScaled(i, ctx.color, brightness)
+        }
+    }
+
     companion object {
         const val ID = "chase-3d"
     }
@@ -5,6 +5,8 @@ import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
 import com.chromadmx.core.util.MathUtils
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import com.chromadmx.engine.util.ColorUtils
 
@@ -55,6 +57,15 @@ class GradientSweep3DEffect : SpatialEffect {
         return ColorUtils.samplePalette(ctx.palette, t)
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        val axis = positions.axis(ctx.axis)
+        val offset = ctx.time * ctx.speed
+        for (i in 0 until positions.size) {
+            out.setPaletteSample(i, ctx.palette, MathUtils.wrap(axis[i] + offset, 1f))
+        }
+    }
+
     companion object {
         const val ID = "gradient-sweep-3d"
         val DEFAULT_PALETTE = listOf(Color.RED, Color.BLUE)
@@ -4,6 +4,8 @@ import com.chromadmx.core.EffectParams
 import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import kotlin.math.cos
 import kotlin.math.max
@@ -36,7 +38,12 @@ class ParticleBurst3DEffect : SpatialEffect {
         val color: Color,
         val fade: Float,
         val lifeMultiplier: Float
-    )
+    ) {
+        // Particle coordinates as flat arrays for the batch loop
+        val particleX = FloatArray(particlePositions.size) { particlePositions[it].x }
+        val particleY = FloatArray(particlePositions.size) { particlePositions[it].y }
+        val particleZ = FloatArray(particlePositions.size) { particlePositions[it].z }
+    }
 
     override fun prepare(params: EffectParams, time: Float, beat: BeatState): Any {
         val center = Vec3(
@@ -80,6 +87,34 @@ class ParticleBurst3DEffect : SpatialEffect {
         return ctx.color * totalBrightness
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        if (ctx.lifeMultiplier <= 0f) return out.fill(Color.BLACK)
+
+        val xs = positions.x
+        val ys = positions.y
+        val zs = positions.z
+        val px = ctx.particleX
+        val py = ctx.particleY
+        val pz = ctx.particleZ
+        for (i in 0 until positions.size) {
+            val x = xs[i]
+            val y = ys[i]
+            val z = zs[i]
+            var totalBrightness = 0f
+            for (p in px.indices) {
+                val dx = x - px[p]
+                val dy = y - py[p]
+                val dz = z - pz[p]
+                val dist = sqrt(dx * dx + dy * dy + dz * dz)
+                if (dist < ctx.fade) {
+                    totalBrightness += (1f - dist / ctx.fade) * ctx.lifeMultiplier
+                }
+            }
+            out.setScaled(i, ctx.color, totalBrightness.coerceIn(0f, 1f))
+        }
+    }
+
     companion object {
         const val ID = "particle-burst-3d"
 
@@ -4,6 +4,8 @@ import com.chromadmx.core.EffectParams
 import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import com.chromadmx.engine.util.ColorUtils
 import com.chromadmx.engine.util.PerlinNoise
@@ -18,6 +20,7 @@ import com.chromadmx.engine.util.PerlinNoise
  * **Params:**
  * - `scale`   (Float)       — spatial frequency (higher = more detail). Default: 1.0.
  * - `speed`   (Float)       — time scroll speed. Default: 0.5.
+ * - `octaves` (Int)         — fBm octaves (1 = plain noise, max 8). Default: 1.
  * - `palette` (List<Color>) — color palette mapped across noise range. Default: black->white.
  */
 class PerlinNoise3DEffect : SpatialEffect {
@@ -28,35 +31,56 @@ class PerlinNoise3DEffect : SpatialEffect {
     private data class Context(
         val scale: Float,
         val zOffset: Float,
-        val palette: List<Color>
+        val palette: List<Color>,
+        val octaves: Int
     )
 
     override fun prepare(params: EffectParams, time: Float, beat: BeatState): Any {
         val scale = params.getFloat("scale", 1.0f)
         val speed = params.getFloat("speed", 0.5f)
         val palette = params.getColorList("palette", DEFAULT_PALETTE)
+        val octaves = params.getInt("octaves", 1).coerceIn(1, MAX_OCTAVES)
 
         // Scale animation time by BPM ratio (1.0x at 120 BPM baseline)
         val beatTime = if (beat.bpm > 0f) time * (beat.bpm / 120f) else time
         val zOffset = beatTime * speed
 
-        return Context(scale, zOffset, palette)
+        return Context(scale, zOffset, palette, octaves)
     }
 
     override fun compute(pos: Vec3, context: Any?): Color {
         val ctx = context as? Context ?: return Color.BLACK
 
-        val noiseVal = PerlinNoise.noise01(
+        val noiseVal = PerlinNoise.fbm01(
             pos.x * ctx.scale,
             pos.y * ctx.scale,
-            pos.z * ctx.scale + ctx.zOffset
+            pos.z * ctx.scale + ctx.zOffset,
+            ctx.octaves
         )
 
         return ColorUtils.samplePalette(ctx.palette, noiseVal.coerceIn(0f, 1f))
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        val count = positions.size
+        // Stage the noise field in the red channel, then map it through the
+        // palette in place (each entry is read before it is overwritten).
+        val noise = out.r
+        PerlinNoise.fbm01Batch(
+            positions.x, positions.y, positions.z, noise, count,
+            scale = ctx.scale, zOffset = ctx.zOffset, octaves = ctx.octaves
+        )
+        for (i in 0 until count) {
+            out.setPaletteSample(i, ctx.palette, noise[i].coerceIn(0f, 1f))
+        }
+    }
+
     companion object {
         const val ID = "perlin-noise-3d"
         val DEFAULT_PALETTE = listOf(Color.BLACK, Color.WHITE)
+
+        /** Octaves beyond this add detail finer than any rig can show. */
+        const val MAX_OCTAVES = 8
     }
 }
@@ -5,8 +5,11 @@ import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
 import com.chromadmx.core.util.MathUtils
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import kotlin.math.abs
+import kotlin.math.sqrt
 
 /**
  * Expanding spherical pulse radiating outward from a center point.
@@ -74,6 +77,24 @@ class RadialPulse3DEffect : SpatialEffect {
         return ctx.color * brightness
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        val xs = positions.x
+        val ys = positions.y
+        val zs = positions.z
+        val cx = ctx.center.x
+        val cy = ctx.center.y
+        val cz = ctx.center.z
+        for (i in 0 until positions.size) {
+            val dx = xs[i] - cx
+            val dy = ys[i] - cy
+            val dz = zs[i] - cz
+            val shellDist = abs(sqrt(dx * dx + dy * dy + dz * dz) - ctx.radius)
+            val brightness = if (shellDist < ctx.halfWidth) 1f - (shellDist / ctx.halfWidth) else 0f
+            out.setScaled(i, ctx.color, brightness)
+        }
+    }
+
     companion object {
         const val ID = "radial-pulse-3d"
     }
@@ -4,6 +4,8 @@ import com.chromadmx.core.EffectParams
 import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 
 /**
@@ -25,6 +27,10 @@ class SolidColorEffect : SpatialEffect {
         return context as? Color ?: Color.WHITE
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        out.fill(context as? Color ?: Color.WHITE)
+    }
+
     companion object {
         const val ID = "solid-color"
     }
@@ -4,6 +4,8 @@ import com.chromadmx.core.EffectParams
 import com.chromadmx.core.model.BeatState
 import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.PositionBuffer
 import com.chromadmx.engine.effect.SpatialEffect
 import kotlin.math.PI
 import kotlin.math.sin
@@ -64,6 +66,15 @@ class WaveEffect3DEffect : SpatialEffect {
         return ctx.colorA.lerp(ctx.colorB, t)
     }
 
+    override fun computeBatch(positions: PositionBuffer, context: Any?, out: ColorBuffer) {
+        val ctx = context as? Context ?: return out.fill(Color.BLACK)
+        val axis = positions.axis(ctx.axis)
+        for (i in 0 until positions.size) {
+            val phase = (2.0 * PI * (axis[i] / ctx.wavelength - ctx.timeOffset)).toFloat()
+            out.setLerp(i, ctx.colorA, ctx.colorB, (sin(phase) + 1f) * 0.5f)
+        }
+    }
+
     companion object {
         const val ID = "wave-3d"
         val DEFAULT_COLORS = listOf(Color.BLACK, Color.WHITE)
@@ -0,0 +1,111 @@
+package com.chromadmx.engine.pipeline
+
+import com.chromadmx.core.model.BeatState
+import kotlinx.atomicfu.atomic
+import kotlinx.atomicfu.update
+
+/** Musical boundary a queued cue waits for. */
+enum class CueQuantize {
+    /** Fire on the next engine frame. */
+    IMMEDIATE,
+
+    /** Fire on the next beat. */
+    BEAT,
+
+    /** Fire on the next downbeat (4-beat bar). */
+    BAR
+}
+
+/**
+ * Cues (scene or preset changes) held until a beat or bar boundary.
+ *
+ * The engine loop calls [advance] with each frame's [BeatState] before it
+ * builds the frame. A boundary is a wrap of [BeatState.beatPhase] or
+ * [BeatState.barPhase], so a cue fires on exactly the frame rendered for the
+ * downbeat — and, with a Link clock, on the same downbeat as every other
+ * device in the session, since they all share that phase.
+ *
+ * A cue waits for the first boundary after the frame that first sees it:
+ * scheduling "on the next bar" mid-bar fires at that bar's end, never
+ * retroactively at a boundary that already passed. While the clock is
+ * stopped the phase does not wrap, so quantized cues stay queued.
+ *
+ * [schedule] may be called from any thread and never blocks the engine
+ * loop; [advance] must only be called from the engine loop.
+ */
+class CueQueue {
+
+    private class Cue(val quantize: CueQuantize, val action: () -> Unit) {
+        /** Boundary count this cue fires at; -1 until the loop first sees it. Loop-only. */
+        var target: Long = -1L
+    }
+
+    private val pending = atomic(emptyList<Cue>())
+
+    // Loop-only state
+    private var beats = 0L
+    private var bars = 0L
+    private var lastBeatPhase = -1f
+    private var lastBarPhase = -1f
+
+    /** Number of cues waiting to fire. */
+    val size: Int get() = pending.value.size
+
+    /** Queue [action] to run on the engine loop at the next [quantize] boundary. */
+    fun schedule(quantize: CueQuantize, action: () -> Unit) {
+        val cue = Cue(quantize, action)
+        pending.update { it + cue }
+    }
+
+    /** Drop every queued cue without running it. */
+    fun clear() {
+        pending.value = emptyList()
+    }
+
+    /**
+     * Count boundaries crossed since the previous frame and run every cue
+     * now due, in scheduling order.
+     *
+     * @return number of cues fired
+     */
+    fun advance(beat: BeatState): Int {
+        if (lastBeatPhase >= 0f) {
+            if (wrapped(lastBeatPhase, beat.beatPhase)) beats++
+            if (wrapped(lastBarPhase, beat.barPhase)) bars++
+        }
+        lastBeatPhase = beat.beatPhase
+        lastBarPhase = beat.barPhase
+
+        val queued = pending.value
+        if (queued.isEmpty()) return 0
+
+        var due: MutableList<Cue>? = null
+        for (cue in queued) {
+            val count = when (cue.quantize) {
+                CueQuantize.IMMEDIATE -> 0L
+                CueQuantize.BEAT -> beats
+                CueQuantize.BAR -> bars
+            }
+            if (cue.target < 0L) {
+                cue.target = if (cue.quantize == CueQuantize.IMMEDIATE) 0L else count + 1
+            }
+            if (count >= cue.target) {
+                (due ?: ArrayList<Cue>().also { due = it }).add(cue)
+            }
+        }
+        val fired = due ?: return 0
+
+        // Remove by identity; cues scheduled meanwhile are kept.
+        pending.update { current -> current.filter { cue -> fired.none { it === cue } } }
+        for (cue in fired) cue.action()
+        return fired.size
+    }
+
+    private companion object {
+        /**
+         * A phase wrap is a drop of more than half a cycle, so small
+         * backwards corrections from a Link tempo change are not boundaries.
+         */
+        fun wrapped(previous: Float, current: Float): Boolean = current < previous - 0.5f
+    }
+}
@@ -5,12 +5,15 @@ import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Fixture3D
 import com.chromadmx.core.model.FixtureOutput
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.core.telemetry.PerformanceTelemetry
+import com.chromadmx.core.util.FramePacer
+import com.chromadmx.engine.effect.ColorBuffer
 import com.chromadmx.engine.effect.EffectStack
+import com.chromadmx.engine.effect.PositionBuffer
 import kotlinx.atomicfu.atomic
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
-import kotlinx.coroutines.delay
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlin.time.TimeSource
@@ -19,17 +22,27 @@ import kotlin.time.TimeSource
  * The main effect engine loop.
  *
  * Each frame (targeting 60 fps / ~16.67 ms):
- * 1. Read the current [BeatState] from [beatStateProvider].
- * 2. Evaluate the [effectStack] at every fixture position.
- * 3. Write the resulting color array into the [colorOutput] triple buffer.
+ * 1. Read the current [BeatState] from [beatStateProvider] and fire any
+ *    [cueQueue] cues due at this beat or bar boundary. While the beat
+ *    state reports a stopped transport the frame ends here: the last frame
+ *    stays published and the DMX bridge, seeing nothing new, sends nothing.
+ * 2. Evaluate the [effectStack] over all fixture positions in one batch.
+ * 3. Publish the colors to the [colorFrames] (read by the DMX bridge) and
+ *    [colorOutput] (read by the UI) triple buffers. Both hold primitive
+ *    [ColorBuffer]s, so a frame allocates no [Color] for either.
  * 4. If movement layers are present, write [FixtureOutput] into [fixtureOutputBuffer].
  *
  * The engine runs on [Dispatchers.Default] to avoid blocking the UI thread.
  * The DMX output thread reads from the other side of the triple buffer.
+ *
+ * With [telemetry], the first frame after each beat boundary records how
+ * far past the beat it was rendered into
+ * [PerformanceTelemetry.beatSyncError].
  */
 class EffectEngine(
     private val scope: CoroutineScope,
-    initialFixtures: List<Fixture3D> = emptyList()
+    initialFixtures: List<Fixture3D> = emptyList(),
+    private val telemetry: PerformanceTelemetry? = null
 ) {
     /** The compositing effect stack evaluated each frame. */
     val effectStack: EffectStack = EffectStack()
@@ -42,12 +55,26 @@ class EffectEngine(
      * Using an atomic reference prevents a race where [tick] could see
      * the new TripleBuffer but the old (empty) fixture list, causing a
      * permanent early-return on `curFixtures.isEmpty()`.
+     *
+     * [positionBuffer] mirrors [normalizedPositions] as structure-of-arrays.
+     * Batch evaluation writes straight into the [colorFrames] write slot,
+     * using the [workspace] for everything in between; all of these are
+     * sized once here so a frame allocates nothing for them. The
+     * [workspace] is only touched by [tick], which runs on the single
+     * engine loop.
      */
     data class Snapshot(
         val fixtures: List<Fixture3D>,
         val normalizedPositions: List<Vec3>,
-        val colorOutput: TripleBuffer<Array<Color>>,
+        val colorOutput: TripleBuffer<ColorBuffer>,
         val fixtureOutputBuffer: TripleBuffer<Array<FixtureOutput>>,
+        val positionBuffer: PositionBuffer = PositionBuffer(normalizedPositions),
+        val colorFrames: TripleBuffer<ColorBuffer> = TripleBuffer(
+            initialA = ColorBuffer(normalizedPositions.size),
+            initialB = ColorBuffer(normalizedPositions.size),
+            initialC = ColorBuffer(normalizedPositions.size)
+        ),
+        val workspace: FrameWorkspace = FrameWorkspace(normalizedPositions.size),
     )
 
     private val _snapshot = atomic(buildSnapshot(initialFixtures))
@@ -55,8 +82,20 @@ class EffectEngine(
     /** Current fixture list. Updated via [updateFixtures]. */
     val fixtures: List<Fixture3D> get() = _snapshot.value.fixtures
 
-    /** Triple-buffered color output: one [Color] per fixture. */
-    val colorOutput: TripleBuffer<Array<Color>> get() = _snapshot.value.colorOutput
+    /**
+     * Triple-buffered color output, parallel to [fixtures], for a second
+     * reader such as the UI (a triple buffer has one reader; [colorFrames]
+     * belongs to the DMX path). Each frame is copied in as primitives, so
+     * a [Color] is only created when the reader asks for one.
+     */
+    val colorOutput: TripleBuffer<ColorBuffer> get() = _snapshot.value.colorOutput
+
+    /**
+     * Triple-buffered color output as flat float arrays, parallel to [fixtures].
+     * The DMX path reads this one: it holds no per-fixture objects, and
+     * the slots are reused every frame.
+     */
+    val colorFrames: TripleBuffer<ColorBuffer> get() = _snapshot.value.colorFrames
 
     /** Triple-buffered fixture output: one [FixtureOutput] per fixture (includes movement data). */
     val fixtureOutputBuffer: TripleBuffer<Array<FixtureOutput>> get() = _snapshot.value.fixtureOutputBuffer
@@ -72,12 +111,43 @@ class EffectEngine(
         _snapshot.value = buildSnapshot(newFixtures)
     }
 
+    /**
+     * Render only [newFixtures], a subset of [rig], with positions
+     * normalized over the whole rig. Each fixture then gets the same color
+     * it would in a render of the full rig, which is what lets several
+     * devices each render their share of one show (see
+     * [com.chromadmx.engine.shard.RenderShardController]).
+     */
+    fun updateFixtures(newFixtures: List<Fixture3D>, rig: List<Fixture3D>) {
+        _snapshot.value = buildSnapshot(newFixtures, rig)
+    }
+
+    /**
+     * Scene/preset changes waiting for a beat or bar boundary. Drained at the
+     * start of every [tick], before the frame is built.
+     */
+    val cueQueue: CueQueue = CueQueue()
+
     /** Provider for the current beat state. Defaults to [BeatState.IDLE]. */
     var beatStateProvider: () -> BeatState = { BeatState.IDLE }
 
-    /** Target frame interval in milliseconds. ~60 fps. */
+    /**
+     * Effect time, in seconds, for each frame of the loop; null uses the
+     * time since [start]. Devices sharing a Link session set this to the
+     * session's beat time so they all compute the same frame for the same
+     * beat ([com.chromadmx.engine.shard.RenderShardController.linkEffectTime]).
+     */
+    var effectTimeProvider: (() -> Float)? = null
+
+    /**
+     * Target frame interval in milliseconds. ~60 fps. Read on [start];
+     * frames are paced against absolute deadlines, so the rate does not drift.
+     */
     var frameIntervalMs: Long = 16L
 
+    /** Beat phase of the previous [tick], for beat-sync telemetry; loop-only. */
+    private var lastBeatPhase = -1f
+
     private var engineJob: Job? = null
     private val timeSource = TimeSource.Monotonic
     private var startMark: TimeSource.Monotonic.ValueTimeMark? = null
@@ -92,15 +162,11 @@ class EffectEngine(
         if (isRunning) return
         startMark = timeSource.markNow()
 
+        val pacer = FramePacer(frameIntervalMs * NANOS_PER_MS)
         engineJob = scope.launch(Dispatchers.Default) {
             while (isActive) {
-                val frameStartMark = timeSource.markNow()
                 tick()
-                val elapsedMs = frameStartMark.elapsedNow().inWholeMilliseconds
-                val remaining = frameIntervalMs - elapsedMs
-                if (remaining > 0) {
-                    delay(remaining)
-                }
+                pacer.awaitNextFrame()
             }
         }
     }
@@ -118,9 +184,24 @@ class EffectEngine(
      * directly in tests without starting the coroutine loop.
      */
     fun tick() {
+        val provider = effectTimeProvider
+        if (provider != null) {
+            tick(provider())
+            return
+        }
         val mark = startMark ?: timeSource.markNow().also { startMark = it }
-        val time = mark.elapsedNow().inWholeMilliseconds / 1000f
+        tick(mark.elapsedNow().inWholeMilliseconds / 1000f)
+    }
+
+    /**
+     * Execute one frame at effect time [time] (seconds) instead of the
+     * wall clock, so frames are reproducible; see [OfflineRenderer].
+     */
+    fun tick(time: Float) {
         val beat = beatStateProvider()
+        cueQueue.advance(beat)
+        if (telemetry != null) recordBeatSync(beat)
+        if (!beat.isPlaying) return
 
         // Read one atomic snapshot — fixtures and buffers are always consistent.
         val snap = _snapshot.value
@@ -131,8 +212,9 @@ class EffectEngine(
 
         if (curFixtures.isEmpty()) return
 
-        // Prepare frame once (O(Layers * Params))
-        val evaluator = effectStack.buildFrame(time, beat)
+        // Prepare frame once (O(Layers * Params)), reusing the snapshot's evaluator
+        val workspace = snap.workspace
+        val evaluator = effectStack.buildFrame(time, beat, workspace.evaluator)
 
         val colorSlot = curColorOutput.writeSlot()
         val hasMovement = evaluator.hasMovementLayers
@@ -142,23 +224,35 @@ class EffectEngine(
         // and here (impossible with the snapshot design, but defensive).
         val count = minOf(curFixtures.size, colorSlot.size)
 
+        // All color layers in one pass over the SoA positions, directly
+        // into the primitive frame the DMX bridge reads
+        val colorFrames = snap.colorFrames
+        val colors = colorFrames.writeSlot()
+        evaluator.evaluateBatch(snap.positionBuffer, colors, workspace.layerScratch)
+
         if (hasMovement) {
+            // Colors go in by index; the slot's previous output is reused when unchanged
             val fixtureSlot = curFixtureOutput.writeSlot()
             val fixtureCount = minOf(count, fixtureSlot.size)
             for (i in 0 until fixtureCount) {
-                val output = evaluator.evaluateFixtureOutput(positions[i])
-                colorSlot[i] = output.color
-                fixtureSlot[i] = output
+                fixtureSlot[i] = evaluator.evaluateFixtureOutput(positions[i], colors, i, fixtureSlot[i])
             }
             curFixtureOutput.swapWrite()
-        } else {
-            for (i in 0 until count) {
-                colorSlot[i] = evaluator.evaluate(positions[i])
-            }
         }
+        colorSlot.copyFrom(colors)
+        colorFrames.swapWrite()
         curColorOutput.swapWrite()
     }
 
+    /** On a beat wrap, record how far into the new beat this frame already is. */
+    private fun recordBeatSync(beat: BeatState) {
+        val previous = lastBeatPhase
+        lastBeatPhase = beat.beatPhase
+        if (previous < 0f || beat.beatPhase >= previous - 0.5f || beat.bpm <= 0f) return
+        val beatMicros = MICROS_PER_MINUTE / beat.bpm
+        telemetry?.beatSyncError?.record((beat.beatPhase * beatMicros).toLong())
+    }
+
     /**
      * Evaluate a single frame at the given [time] and [beat], returning
      * the color array directly. Useful for benchmarking and testing
@@ -166,11 +260,12 @@ class EffectEngine(
      */
     fun evaluateFrame(time: Float, beat: BeatState): Array<Color> {
         val snap = _snapshot.value
-        val positions = snap.normalizedPositions
+        val positions = snap.positionBuffer
         val evaluator = effectStack.buildFrame(time, beat)
-        return Array(positions.size) { i ->
-            evaluator.evaluate(positions[i])
-        }
+        // Own buffers: this may run alongside tick() on another thread
+        val colors = ColorBuffer(positions.size)
+        evaluator.evaluateBatch(positions, colors, ColorBuffer(positions.size))
+        return Array(positions.size) { i -> colors[i] }
     }
 
     /**
@@ -187,6 +282,9 @@ class EffectEngine(
     }
 
     companion object {
+        private const val NANOS_PER_MS = 1_000_000L
+        private const val MICROS_PER_MINUTE = 60_000_000f
+
         /**
          * Build a [Snapshot] from a fixture list, normalizing positions to [0, 1]
          * on each axis so spatial effects work at any venue scale.
@@ -194,15 +292,15 @@ class EffectEngine(
          * Degenerate axes (all fixtures share the same coordinate) are mapped to 0
          * so effects centered at origin still light them.
          */
-        internal fun buildSnapshot(fixtures: List<Fixture3D>): Snapshot {
+        internal fun buildSnapshot(fixtures: List<Fixture3D>, rig: List<Fixture3D> = fixtures): Snapshot {
             val size = fixtures.size
             return Snapshot(
                 fixtures = fixtures,
-                normalizedPositions = normalizePositions(fixtures),
+                normalizedPositions = normalizePositions(fixtures, rig),
                 colorOutput = TripleBuffer(
-                    initialA = Array(size) { Color.BLACK },
-                    initialB = Array(size) { Color.BLACK },
-                    initialC = Array(size) { Color.BLACK }
+                    initialA = ColorBuffer(size),
+                    initialB = ColorBuffer(size),
+                    initialC = ColorBuffer(size)
                 ),
                 fixtureOutputBuffer = TripleBuffer(
                     initialA = Array(size) { FixtureOutput.DEFAULT },
@@ -213,20 +311,21 @@ class EffectEngine(
         }
 
         /**
-         * Normalize fixture positions to [0, 1] on each active axis.
-         * Axes where all fixtures share the same value ("degenerate") are
+         * Normalize fixture positions to [0, 1] on each active axis of the
+         * [rig]'s bounding box (by default the fixtures' own).
+         * Axes where all rig fixtures share the same value ("degenerate") are
          * mapped to 0 to keep them at the effect origin.
          */
-        internal fun normalizePositions(fixtures: List<Fixture3D>): List<Vec3> {
+        internal fun normalizePositions(fixtures: List<Fixture3D>, rig: List<Fixture3D> = fixtures): List<Vec3> {
             if (fixtures.isEmpty()) return emptyList()
-            if (fixtures.size == 1) return listOf(Vec3(0f, 0f, 0f))
-
-            val minX = fixtures.minOf { it.position.x }
-            val maxX = fixtures.maxOf { it.position.x }
-            val minY = fixtures.minOf { it.position.y }
-            val maxY = fixtures.maxOf { it.position.y }
-            val minZ = fixtures.minOf { it.position.z }
-            val maxZ = fixtures.maxOf { it.position.z }
+            if (rig.size <= 1) return fixtures.map { Vec3(0f, 0f, 0f) }
+
+            val minX = rig.minOf { it.position.x }
+            val maxX = rig.maxOf { it.position.x }
+            val minY = rig.minOf { it.position.y }
+            val maxY = rig.maxOf { it.position.y }
+            val minZ = rig.minOf { it.position.z }
+            val maxZ = rig.maxOf { it.position.z }
 
             val rangeX = maxX - minX
             val rangeY = maxY - minY
@@ -0,0 +1,24 @@
+package com.chromadmx.engine.pipeline
+
+import com.chromadmx.engine.effect.ColorBuffer
+import com.chromadmx.engine.effect.EffectStack
+
+/**
+ * Per-frame working memory of the engine loop, sized once from a fixture
+ * snapshot.
+ *
+ * Built by [EffectEngine.buildSnapshot] alongside the output buffers, so
+ * [EffectEngine.updateFixtures] is the only point where it is allocated;
+ * a steady-state [EffectEngine.tick] overwrites these regions in place
+ * instead of allocating. Only the engine loop may touch a workspace.
+ *
+ * @property fixtureCount Fixtures the workspace was sized for.
+ */
+class FrameWorkspace(val fixtureCount: Int) {
+
+    /** Each color layer's batch output before it is composited. */
+    val layerScratch: ColorBuffer = ColorBuffer(fixtureCount)
+
+    /** Refilled by [EffectStack.buildFrame] every frame. */
+    val evaluator: EffectStack.FrameEvaluator = EffectStack.FrameEvaluator()
+}
@@ -0,0 +1,175 @@
+package com.chromadmx.engine.pipeline
+
+import com.chromadmx.core.model.BeatState
+import com.chromadmx.engine.effect.ColorBuffer
+
+/**
+ * Renders an [EffectEngine] frame by frame on a virtual timeline, as fast
+ * as the CPU allows, for preset regression tests and golden files.
+ *
+ * Frame `i` is rendered at `i / frameRateHz` seconds: [EffectEngine.tick]
+ * gets that effect time, and the beat comes from `beatAt` at the same
+ * instant (e.g. `VirtualLinkSession.beatStateAt`), so the output depends
+ * only on the effect stack, the fixtures and the tempo script. Cues queued
+ * on [EffectEngine.cueQueue] fire on their beat as they would live.
+ *
+ * The engine must not be running its own loop while rendering offline.
+ *
+ * @param engine      Engine to render; its [EffectEngine.beatStateProvider]
+ *                    is replaced for the duration of each render.
+ * @param frameRateHz Virtual frame rate (default 40Hz, the DMX output rate).
+ */
+class OfflineRenderer(
+    private val engine: EffectEngine,
+    val frameRateHz: Int = DEFAULT_FRAME_RATE_HZ
+) {
+    init {
+        require(frameRateHz > 0) { "frameRateHz must be > 0, got $frameRateHz" }
+    }
+
+    /** Virtual time of frame [index] in microseconds. */
+    fun frameTimeMicros(index: Int): Long = index.toLong() * MICROS_PER_SECOND / frameRateHz
+
+    /**
+     * Render [frameCount] frames and hand each to [onFrame].
+     *
+     * [onFrame] receives the engine's published frame, which is only valid
+     * during the callback; a frame the engine did not publish (transport
+     * stopped) repeats the previous one.
+     *
+     * @param beatAt Beat state at a virtual time in microseconds.
+     */
+    fun render(
+        frameCount: Int,
+        beatAt: (timeMicros: Long) -> BeatState,
+        onFrame: (index: Int, timeMicros: Long, frame: ColorBuffer) -> Unit
+    ) {
+        require(frameCount >= 0) { "frameCount must be >= 0, got $frameCount" }
+        check(!engine.isRunning) { "Stop the engine loop before rendering offline" }
+
+        val previousProvider = engine.beatStateProvider
+        var timeMicros = 0L
+        engine.beatStateProvider = { beatAt(timeMicros) }
+        try {
+            for (index in 0 until frameCount) {
+                timeMicros = frameTimeMicros(index)
+                engine.tick((timeMicros / MICROS_PER_SECOND_F).toFloat())
+                val frames = engine.colorFrames
+                frames.swapRead()
+                onFrame(index, timeMicros, frames.readSlot())
+            }
+        } finally {
+            engine.beatStateProvider = previousProvider
+        }
+    }
+
+    /**
+     * Render [frameCount] frames into the [GoldenFrames] format, for
+     * comparison against a checked-in file.
+     */
+    fun renderGolden(frameCount: Int, beatAt: (timeMicros: Long) -> BeatState): ByteArray {
+        val fixtureCount = engine.fixtures.size
+        val out = GoldenFrames.allocate(fixtureCount, frameRateHz, frameCount)
+        var offset = GoldenFrames.HEADER_SIZE
+        render(frameCount, beatAt) { _, _, frame ->
+            val count = minOf(fixtureCount, frame.size)
+            for (i in 0 until count) {
+                out[offset] = GoldenFrames.quantize(frame.r[i])
+                out[offset + 1] = GoldenFrames.quantize(frame.g[i])
+                out[offset + 2] = GoldenFrames.quantize(frame.b[i])
+                offset += 3
+            }
+            offset += (fixtureCount - count) * 3
+        }
+        return out
+    }
+
+    companion object {
+        const val DEFAULT_FRAME_RATE_HZ: Int = 40
+
+        private const val MICROS_PER_SECOND = 1_000_000L
+        private const val MICROS_PER_SECOND_F = 1_000_000.0
+    }
+}
+
+/**
+ * Compact binary form of an offline render, for golden comparisons.
+ *
+ * Layout (little-endian):
+ * - 4 bytes magic `CDXF`, 1 byte [VERSION], 3 bytes padding
+ * - Int32 fixture count, Int32 frame rate (Hz), Int32 frame count
+ * - per frame, per fixture: R, G, B as DMX bytes (0-255, rounded like the
+ *   DMX bridge)
+ *
+ * Colors are stored at DMX resolution, so float noise below what a
+ * fixture can show never fails a comparison. A 10-minute, 100-fixture
+ * show at 40Hz is about 7 MB.
+ */
+object GoldenFrames {
+    const val VERSION: Int = 1
+    const val HEADER_SIZE: Int = 20
+
+    private val MAGIC = byteArrayOf('C'.code.toByte(), 'D'.code.toByte(), 'X'.code.toByte(), 'F'.code.toByte())
+
+    /** Header plus zeroed frames for [frameCount] frames of [fixtureCount] fixtures. */
+    internal fun allocate(fixtureCount: Int, frameRateHz: Int, frameCount: Int): ByteArray {
+        val size = HEADER_SIZE.toLong() + frameCount.toLong() * fixtureCount * 3
+        require(size <= Int.MAX_VALUE) { "Render of $frameCount x $fixtureCount fixtures is too large" }
+        val out = ByteArray(size.toInt())
+        MAGIC.copyInto(out)
+        out[4] = VERSION.toByte()
+        writeInt(out, 8, fixtureCount)
+        writeInt(out, 12, frameRateHz)
+        writeInt(out, 16, frameCount)
+        return out
+    }
+
+    /** Fixture count stored in [golden]. */
+    fun fixtureCount(golden: ByteArray): Int = readInt(checked(golden), 8)
+
+    /** Frame rate stored in [golden]. */
+    fun frameRateHz(golden: ByteArray): Int = readInt(checked(golden), 12)
+
+    /** Frame count stored in [golden]. */
+    fun frameCount(golden: ByteArray): Int = readInt(checked(golden), 16)
+
+    /**
+     * Index of the first frame where [actual] differs from [expected], or
+     * -1 if they match. A header mismatch (different rig, rate or length)
+     * reports frame 0.
+     */
+    fun firstMismatch(expected: ByteArray, actual: ByteArray): Int {
+        checked(expected)
+        checked(actual)
+        if (expected.size != actual.size) return 0
+        for (i in 0 until HEADER_SIZE) if (expected[i] != actual[i]) return 0
+        val frameSize = fixtureCount(expected) * 3
+        if (frameSize == 0) return -1
+        for (i in HEADER_SIZE until expected.size) {
+            if (expected[i] != actual[i]) return (i - HEADER_SIZE) / frameSize
+        }
+        return -1
+    }
+
+    /** 0.0-1.0 to a DMX byte, matching the DMX bridge's rounding. */
+    internal fun quantize(value: Float): Byte =
+        (value * 255f + 0.5f).toInt().coerceIn(0, 255).toByte()
+
+    private fun checked(golden: ByteArray): ByteArray {
+        require(golden.size >= HEADER_SIZE && (0 until 4).all { golden[it] == MAGIC[it] }) {
+            "Not a golden frame file"
+        }
+        require(golden[4].toInt() == VERSION) { "Unsupported golden frame version ${golden[4]}" }
+        return golden
+    }
+
+    private fun writeInt(out: ByteArray, offset: Int, value: Int) {
+        for (i in 0 until 4) out[offset + i] = (value shr (8 * i)).toByte()
+    }
+
+    private fun readInt(bytes: ByteArray, offset: Int): Int {
+        var value = 0
+        for (i in 0 until 4) value = value or ((bytes[offset + i].toInt() and 0xFF) shl (8 * i))
+        return value
+    }
+}
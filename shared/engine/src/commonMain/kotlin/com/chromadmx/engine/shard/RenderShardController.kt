@@ -0,0 +1,165 @@
+package com.chromadmx.engine.shard
+
+import com.chromadmx.core.model.Fixture3D
+import com.chromadmx.core.model.FixtureProfile
+import com.chromadmx.engine.bridge.DmxBridge
+import com.chromadmx.engine.pipeline.EffectEngine
+import com.chromadmx.tempo.link.LinkSessionApi
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import kotlin.concurrent.Volatile
+import kotlin.time.TimeSource
+
+/**
+ * Renders and sends only this device's share of a rig that several
+ * devices on one Link session drive together.
+ *
+ * Universes are split by [ShardAssignment]. The engine is given just the
+ * fixtures on this device's universes, normalized over the whole [rig],
+ * and with [linkEffectTime] as its effect time every device computes the
+ * same frame for the same beat, so the shards line up on stage. Pass
+ * [dmxBridge] to the DMX output bridge as its bridge provider so only the
+ * owned universes are converted and sent.
+ *
+ * Failover: Link only reports a peer count, not who left, so when
+ * [peerCount] falls below [expectedPeers] this device takes back the
+ * whole rig at once. Duplicate senders are harmless because every device
+ * renders identical frames. Sharding resumes once the peers have been back
+ * for [recoverAfterMs]. The controller also starts out rendering the whole
+ * rig until the peers are found.
+ *
+ * @param rig           Every fixture of the show, identical on all devices
+ * @param deviceIndex   This device's index, 0 until [deviceCount]
+ * @param deviceCount   Devices sharing the rig
+ * @param peerCount     Current Link peer count, e.g. [LinkSessionApi.peerCount]
+ * @param expectedPeers Link peers while every device is present; more if
+ *                      other apps join the session
+ * @param profiles      Fixture profiles for the DMX bridges, by profile ID
+ */
+class RenderShardController(
+    private val engine: EffectEngine,
+    private val rig: List<Fixture3D>,
+    val deviceIndex: Int,
+    val deviceCount: Int,
+    private val peerCount: () -> Int,
+    private val scope: CoroutineScope,
+    private val expectedPeers: Int = deviceCount - 1,
+    private val profiles: Map<String, FixtureProfile> = emptyMap(),
+    private val pollIntervalMs: Long = DEFAULT_POLL_INTERVAL_MS,
+    private val recoverAfterMs: Long = DEFAULT_RECOVER_AFTER_MS,
+    private val clockMs: () -> Long = monotonicMs()
+) {
+    init {
+        require(deviceIndex in 0 until deviceCount) { "deviceIndex $deviceIndex not in 0 until $deviceCount" }
+    }
+
+    private val allUniverses: Set<Int> = rig.mapTo(LinkedHashSet()) { it.fixture.universeId }
+    private val shardUniverses: Set<Int> = ShardAssignment.universesFor(rig, deviceIndex, deviceCount)
+
+    private val _ownedUniverses = MutableStateFlow<Set<Int>>(emptySet())
+
+    /** Universes this device currently renders and sends. */
+    val ownedUniverses: StateFlow<Set<Int>> = _ownedUniverses.asStateFlow()
+
+    private val _isFailover = MutableStateFlow(true)
+
+    /** True while this device covers the whole rig (peers missing or not yet found). */
+    val isFailover: StateFlow<Boolean> = _isFailover.asStateFlow()
+
+    /** When the peer count last became healthy, or -1 while it is not. */
+    private var healthySinceMs = -1L
+
+    private var job: Job? = null
+
+    // Bridge cache; only touched by the DMX output loop through [dmxBridge].
+    @Volatile
+    private var bridgeFixtures: List<Fixture3D>? = null
+    @Volatile
+    private var bridge: DmxBridge? = null
+
+    val isRunning: Boolean get() = job?.isActive == true
+
+    /** Take the whole rig now and start watching the peer count. */
+    fun start() {
+        if (isRunning) return
+        healthySinceMs = -1L
+        apply(failover = true)
+        job = scope.launch {
+            while (isActive) {
+                update()
+                delay(pollIntervalMs)
+            }
+        }
+    }
+
+    fun stop() {
+        job?.cancel()
+        job = null
+    }
+
+    /** Re-evaluate the peer count; the poll loop calls this every [pollIntervalMs]. */
+    fun update() {
+        val now = clockMs()
+        if (peerCount() < expectedPeers) {
+            healthySinceMs = -1L
+            if (!_isFailover.value) apply(failover = true)
+            return
+        }
+        if (healthySinceMs < 0L) healthySinceMs = now
+        if (_isFailover.value && now - healthySinceMs >= recoverAfterMs) apply(failover = false)
+    }
+
+    /**
+     * DMX bridge patched for the fixtures the engine currently renders;
+     * rebuilt only when the shard changes. Call from the DMX output loop.
+     */
+    fun dmxBridge(): DmxBridge {
+        val fixtures = engine.fixtures
+        val current = bridge
+        if (current != null && bridgeFixtures === fixtures) return current
+        return DmxBridge(fixtures, profiles).also {
+            bridge = it
+            bridgeFixtures = fixtures
+        }
+    }
+
+    private fun apply(failover: Boolean) {
+        val owned = if (failover || deviceCount == 1) allUniverses else shardUniverses
+        _isFailover.value = failover
+        if (owned == _ownedUniverses.value) return
+        _ownedUniverses.value = owned
+        engine.updateFixtures(rig.filter { it.fixture.universeId in owned }, rig)
+    }
+
+    companion object {
+        const val DEFAULT_POLL_INTERVAL_MS: Long = 250L
+
+        /** Peers must be back this long before the rig is split again. */
+        const val DEFAULT_RECOVER_AFTER_MS: Long = 2_000L
+
+        /** Seconds of effect time per beat: effects run at their authored speed at 120 BPM. */
+        const val SECONDS_PER_BEAT: Double = 0.5
+
+        /**
+         * Effect time for [EffectEngine.effectTimeProvider] taken from the
+         * Link timeline, so it is the same on every device in the session.
+         * Uses the look-ahead API, [latencyMicros] ahead of now, matching
+         * the beat state the engine renders.
+         */
+        fun linkEffectTime(session: LinkSessionApi, latencyMicros: Long = 0L): () -> Float = {
+            val beat = session.beatAtTime(session.hostMicros() + latencyMicros, LinkSessionApi.BAR_QUANTUM)
+            (beat * SECONDS_PER_BEAT).toFloat()
+        }
+
+        private fun monotonicMs(): () -> Long {
+            val origin = TimeSource.Monotonic.markNow()
+            return { origin.elapsedNow().inWholeMilliseconds }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+package com.chromadmx.engine.shard
+
+import com.chromadmx.core.model.Fixture3D
+
+/**
+ * Deterministic split of a rig's universes across rendering devices.
+ *
+ * Every device runs this on the same rig and gets the same answer, so no
+ * coordination beyond a shared device count and each device's own index
+ * is needed. Universes are handed out largest first (by fixture count,
+ * then by universe ID) to whichever device has the fewest fixtures so
+ * far, lowest index on a tie, which keeps the render load even when
+ * universes are unevenly populated.
+ */
+object ShardAssignment {
+
+    /**
+     * Owning device index (0 until [deviceCount]) for every universe
+     * patched in [rig].
+     */
+    fun assign(rig: List<Fixture3D>, deviceCount: Int): Map<Int, Int> {
+        require(deviceCount >= 1) { "deviceCount must be >= 1, got $deviceCount" }
+        val fixturesPerUniverse = rig.groupingBy { it.fixture.universeId }.eachCount()
+        val order = fixturesPerUniverse.keys.sortedWith(
+            compareByDescending<Int> { fixturesPerUniverse.getValue(it) }.thenBy { it }
+        )
+        val load = IntArray(deviceCount)
+        val owners = LinkedHashMap<Int, Int>()
+        for (universe in order) {
+            var device = 0
+            for (d in 1 until deviceCount) {
+                if (load[d] < load[device]) device = d
+            }
+            owners[universe] = device
+            load[device] += fixturesPerUniverse.getValue(universe)
+        }
+        return owners
+    }
+
+    /** Universes [deviceIndex] owns out of [deviceCount] devices. */
+    fun universesFor(rig: List<Fixture3D>, deviceIndex: Int, deviceCount: Int): Set<Int> {
+        require(deviceIndex in 0 until deviceCount) { "deviceIndex $deviceIndex not in 0 until $deviceCount" }
+        return assign(rig, deviceCount).filterValues { it == deviceIndex }.keys
+    }
+}
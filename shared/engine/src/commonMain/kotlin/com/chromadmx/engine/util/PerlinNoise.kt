@@ -47,15 +47,19 @@ object PerlinNoise {
      * @return A value approximately in -1..1.
      */
     fun noise(x: Float, y: Float, z: Float): Float {
+        val fx = floor(x)
+        val fy = floor(y)
+        val fz = floor(z)
+
         // Unit cube containing the point
-        val xi = floor(x).toInt() and 255
-        val yi = floor(y).toInt() and 255
-        val zi = floor(z).toInt() and 255
+        val xi = fx.toInt() and 255
+        val yi = fy.toInt() and 255
+        val zi = fz.toInt() and 255
 
         // Relative position inside the cube
-        val xf = x - floor(x)
-        val yf = y - floor(y)
-        val zf = z - floor(z)
+        val xf = x - fx
+        val yf = y - fy
+        val zf = z - fz
 
         // Fade curves
         val u = fade(xf)
@@ -93,6 +97,87 @@ object PerlinNoise {
     fun noise01(x: Float, y: Float, z: Float): Float =
         (noise(x, y, z) + 1f) * 0.5f
 
+    /**
+     * Fractal Brownian motion: [octaves] layers of [noise], each at
+     * [lacunarity] times the frequency and [gain] times the amplitude of
+     * the previous one, normalized by the total amplitude.
+     *
+     * With one octave this is exactly [noise].
+     *
+     * @return A value approximately in -1..1.
+     */
+    fun fbm(
+        x: Float,
+        y: Float,
+        z: Float,
+        octaves: Int,
+        lacunarity: Float = DEFAULT_LACUNARITY,
+        gain: Float = DEFAULT_GAIN
+    ): Float {
+        if (octaves <= 1) return noise(x, y, z)
+        var sum = 0f
+        var amplitude = 1f
+        var frequency = 1f
+        var norm = 0f
+        for (octave in 0 until octaves) {
+            sum += noise(x * frequency, y * frequency, z * frequency) * amplitude
+            norm += amplitude
+            amplitude *= gain
+            frequency *= lacunarity
+        }
+        return sum / norm
+    }
+
+    /** [fbm] remapped to 0..1. */
+    fun fbm01(
+        x: Float,
+        y: Float,
+        z: Float,
+        octaves: Int,
+        lacunarity: Float = DEFAULT_LACUNARITY,
+        gain: Float = DEFAULT_GAIN
+    ): Float = (fbm(x, y, z, octaves, lacunarity, gain) + 1f) * 0.5f
+
+    /**
+     * Batched [fbm01] over structure-of-arrays coordinates:
+     *
+     *     out[i] = fbm01(x[i] * scale, y[i] * scale, z[i] * scale + zOffset, octaves, ...)
+     *
+     * for `i in 0 until count`. Results are bit-identical to the scalar
+     * call, so effects may use either path. [out] may alias an input array.
+     */
+    fun fbm01Batch(
+        x: FloatArray,
+        y: FloatArray,
+        z: FloatArray,
+        out: FloatArray,
+        count: Int = out.size,
+        scale: Float = 1f,
+        zOffset: Float = 0f,
+        octaves: Int = 1,
+        lacunarity: Float = DEFAULT_LACUNARITY,
+        gain: Float = DEFAULT_GAIN
+    ) {
+        require(count <= x.size && count <= y.size && count <= z.size && count <= out.size) {
+            "count $count exceeds an array size"
+        }
+        if (octaves <= 1) {
+            for (i in 0 until count) {
+                out[i] = noise01(x[i] * scale, y[i] * scale, z[i] * scale + zOffset)
+            }
+        } else {
+            for (i in 0 until count) {
+                out[i] = fbm01(x[i] * scale, y[i] * scale, z[i] * scale + zOffset, octaves, lacunarity, gain)
+            }
+        }
+    }
+
+    /** Frequency multiplier between [fbm] octaves. */
+    const val DEFAULT_LACUNARITY = 2f
+
+    /** Amplitude multiplier between [fbm] octaves. */
+    const val DEFAULT_GAIN = 0.5f
+
     /* ------------------------------------------------------------------ */
     /*  Internal helpers                                                    */
     /* ------------------------------------------------------------------ */
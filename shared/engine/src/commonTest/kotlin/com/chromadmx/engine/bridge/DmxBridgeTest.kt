@@ -1,8 +1,10 @@
 package com.chromadmx.engine.bridge
 
 import com.chromadmx.core.model.*
+import com.chromadmx.engine.effect.ColorBuffer
 import kotlin.test.Test
 import kotlin.test.assertEquals
+import kotlin.test.assertSame
 import kotlin.test.assertTrue
 
 class DmxBridgeTest {
@@ -94,4 +96,120 @@ class DmxBridgeTest {
         val result = bridge.convert(emptyArray())
         assertTrue(result.isEmpty())
     }
+
+    @Test
+    fun reusedFrameDoesNotKeepStaleValues() {
+        val fixtures = listOf(
+            Fixture3D(
+                fixture = Fixture("f1", "Par 1", channelStart = 0, channelCount = 3, universeId = 0),
+                position = Vec3.ZERO
+            )
+        )
+        val bridge = DmxBridge(fixtures, profiles)
+
+        bridge.convert(arrayOf(Color.WHITE))
+        // This call rewrites the buffer that held WHITE.
+        val data = bridge.convert(arrayOf(Color.RED))[0]!!
+
+        assertEquals(255, data[0].toInt() and 0xFF)
+        assertEquals(0, data[1].toInt() and 0xFF)
+        assertEquals(0, data[2].toInt() and 0xFF)
+    }
+
+    @Test
+    fun frameBufferIsReused() {
+        val fixtures = listOf(
+            Fixture3D(
+                fixture = Fixture("f1", "Par 1", channelStart = 0, channelCount = 3, universeId = 0),
+                position = Vec3.ZERO
+            )
+        )
+        val bridge = DmxBridge(fixtures, profiles)
+
+        val first = bridge.convert(arrayOf(Color.RED))
+        val second = bridge.convert(arrayOf(Color.GREEN))
+        assertSame(first, second)
+        assertSame(first[0], second[0])
+        assertEquals(0, second[0]!![0].toInt() and 0xFF)
+        assertEquals(255, second[0]!![1].toInt() and 0xFF)
+    }
+
+    @Test
+    fun colorBufferConvertMatchesColorArray() {
+        val fixtures = listOf(
+            Fixture3D(
+                fixture = Fixture("f1", "Par 1", channelStart = 0, channelCount = 3, universeId = 0),
+                position = Vec3.ZERO
+            ),
+            Fixture3D(
+                fixture = Fixture("f2", "Par 2", channelStart = 10, channelCount = 3, universeId = 1),
+                position = Vec3.ZERO
+            ),
+            Fixture3D(
+                fixture = Fixture("f3", "Par 3", channelStart = 20, channelCount = 3, universeId = 1),
+                position = Vec3.ZERO
+            )
+        )
+        val colors = arrayOf(Color(0.2f, 0.4f, 0.6f), Color(1.2f, -0.1f, 0.5f))
+        val buffer = ColorBuffer(colors.size)
+        colors.forEachIndexed { i, c -> buffer[i] = c }
+
+        val expected = DmxBridge(fixtures, profiles).convert(colors)
+        val actual = DmxBridge(fixtures, profiles).convert(buffer)
+
+        assertEquals(expected.keys, actual.keys)
+        for (universe in expected.keys) {
+            assertTrue(expected[universe]!!.contentEquals(actual[universe]!!), "universe $universe")
+        }
+    }
+
+    @Test
+    fun mixedRigWritesEachProfileLayout() {
+        val rgbwa = FixtureProfile(
+            profileId = "test-rgbwa",
+            name = "RGBWA",
+            type = FixtureType.PAR,
+            channels = listOf(
+                Channel("Red", ChannelType.RED, 0),
+                Channel("Green", ChannelType.GREEN, 1),
+                Channel("Blue", ChannelType.BLUE, 2),
+                Channel("White", ChannelType.WHITE, 3),
+                Channel("Amber", ChannelType.AMBER, 4, defaultValue = 42)
+            )
+        )
+        fun fixture(id: String, start: Int, profileId: String, universe: Int = 0) = Fixture3D(
+            fixture = Fixture(id, id, channelStart = start, channelCount = 3, universeId = universe, profileId = profileId),
+            position = Vec3.ZERO
+        )
+        // Profiles interleaved, so each writer group spans several universes.
+        val fixtures = listOf(
+            fixture("bar", 0, "pixel-bar-8"),
+            fixture("wash", 30, "generic-wash"),
+            fixture("rgbwa", 40, "test-rgbwa"),
+            fixture("strobe", 50, "generic-strobe"),
+            fixture("bar-edge", 500, "pixel-bar-8", universe = 1),
+            fixture("rgbwa-2", 0, "test-rgbwa", universe = 1)
+        )
+        val color = Color(0.8f, 0.4f, 0.2f)
+        val data = DmxBridge(fixtures, mapOf("test-rgbwa" to rgbwa)).convert(Array(fixtures.size) { color })
+        fun level(universe: Int, channel: Int) = data[universe]!![channel].toInt() and 0xFF
+
+        for (pixel in 0 until 8) {
+            assertEquals(204, level(0, pixel * 3), "bar pixel $pixel red")
+            assertEquals(102, level(0, pixel * 3 + 1), "bar pixel $pixel green")
+            assertEquals(51, level(0, pixel * 3 + 2), "bar pixel $pixel blue")
+        }
+        // Wash: dimmer carries brightness, RGB normalized to it.
+        assertEquals(204, level(0, 30))
+        assertEquals(255, level(0, 31))
+        assertEquals(128, level(0, 32))
+        // RGBWA: white is min(RGB), amber keeps its default.
+        assertEquals(51, level(0, 43))
+        assertEquals(42, level(0, 44))
+        assertEquals(42, level(1, 4))
+        // No RGB in the strobe profile: plain RGB fallback.
+        assertEquals(listOf(204, 102, 51), (50..52).map { level(0, it) })
+        // Pixels past the end of the universe are dropped, the rest written.
+        assertEquals(listOf(204, 102, 51), (509..511).map { level(1, it) })
+    }
 }
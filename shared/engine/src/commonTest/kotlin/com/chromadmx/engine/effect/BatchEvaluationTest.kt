@@ -0,0 +1,171 @@
+package com.chromadmx.engine.effect
+
+import com.chromadmx.core.EffectParams
+import com.chromadmx.core.model.BeatState
+import com.chromadmx.core.model.BlendMode
+import com.chromadmx.core.model.Color
+import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effects.Chase3DEffect
+import com.chromadmx.engine.effects.GradientSweep3DEffect
+import com.chromadmx.engine.effects.ParticleBurst3DEffect
+import com.chromadmx.engine.effects.PerlinNoise3DEffect
+import com.chromadmx.engine.effects.RadialPulse3DEffect
+import com.chromadmx.engine.effects.SolidColorEffect
+import com.chromadmx.engine.effects.WaveEffect3DEffect
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Batch evaluation must render exactly what per-pixel evaluation renders,
+ * so presets look identical whichever path the engine takes.
+ */
+class BatchEvaluationTest {
+
+    /** A 6x6x3 lattice covering the normalized venue plus a little outside it. */
+    private val positions = PositionBuffer(
+        buildList {
+            for (x in 0..5) for (y in 0..5) for (z in 0..2) {
+                add(Vec3(x / 4f - 0.1f, y / 5f, z / 2f))
+            }
+        }
+    )
+
+    private val beat = BeatState(bpm = 128f, beatPhase = 0.3f, barPhase = 0.7f, elapsed = 3.2f)
+
+    private fun assertBatchMatchesScalar(effect: SpatialEffect, params: EffectParams, time: Float) {
+        val context = effect.prepare(params, time, beat)
+        val out = ColorBuffer(positions.size)
+        effect.computeBatch(positions, context, out)
+        for (i in 0 until positions.size) {
+            assertEquals(
+                effect.compute(positions.points[i], context), out[i],
+                "${effect.id} differs at ${positions.points[i]}"
+            )
+        }
+    }
+
+    /* ------------------------------------------------------------------ */
+    /*  Built-in effect kernels                                            */
+    /* ------------------------------------------------------------------ */
+
+    @Test
+    fun solidColorBatchMatchesScalar() {
+        assertBatchMatchesScalar(SolidColorEffect(), EffectParams().with("color", Color(0f, 1f, 1f)), 1f)
+    }
+
+    @Test
+    fun gradientSweepBatchMatchesScalar() {
+        val params = EffectParams()
+            .with("axis", "y")
+            .with("speed", 0.7f)
+            .with("palette", listOf(Color.RED, Color.GREEN, Color.BLUE))
+        assertBatchMatchesScalar(GradientSweep3DEffect(), params, 2.3f)
+    }
+
+    @Test
+    fun waveBatchMatchesScalar() {
+        val params = EffectParams().with("axis", "z").with("wavelength", 0.4f)
+        assertBatchMatchesScalar(WaveEffect3DEffect(), params, 1.7f)
+    }
+
+    @Test
+    fun perlinNoiseBatchMatchesScalar() {
+        val params = EffectParams().with("scale", 3f).with("speed", 0.9f)
+        assertBatchMatchesScalar(PerlinNoise3DEffect(), params, 4.1f)
+        assertBatchMatchesScalar(PerlinNoise3DEffect(), params.with("octaves", 4), 4.1f)
+    }
+
+    @Test
+    fun radialPulseBatchMatchesScalar() {
+        val params = EffectParams().with("centerX", 0.5f).with("centerY", 0.5f).with("width", 0.6f)
+        assertBatchMatchesScalar(RadialPulse3DEffect(), params, 0.35f)
+    }
+
+    @Test
+    fun chaseBatchMatchesScalar() {
+        val params = EffectParams().with("axis", "x").with("tail", 0.8f)
+        assertBatchMatchesScalar(Chase3DEffect(), params, 0.6f)
+    }
+
+    @Test
+    fun particleBurstBatchMatchesScalar() {
+        val params = EffectParams().with("centerX", 0.5f).with("count", 24).with("fade", 0.7f)
+        assertBatchMatchesScalar(ParticleBurst3DEffect(), params, 0.2f)
+    }
+
+    @Test
+    fun customEffectFallsBackToCompute() {
+        val effect = object : SpatialEffect {
+            override val id = "custom"
+            override val name = "Custom"
+            override fun compute(pos: Vec3, context: Any?): Color = Color(pos.x.coerceIn(0f, 1f), pos.y, 0f)
+        }
+        assertBatchMatchesScalar(effect, EffectParams.EMPTY, 0f)
+    }
+
+    /* ------------------------------------------------------------------ */
+    /*  Stack compositing                                                  */
+    /* ------------------------------------------------------------------ */
+
+    @Test
+    fun stackBatchMatchesPerPixelEvaluate() {
+        val stack = EffectStack(
+            layers = listOf(
+                EffectLayer(GradientSweep3DEffect()),
+                EffectLayer(WaveEffect3DEffect(), blendMode = BlendMode.MULTIPLY, opacity = 0.8f),
+                EffectLayer(RadialPulse3DEffect(), blendMode = BlendMode.ADDITIVE, opacity = 0.5f),
+                EffectLayer(PerlinNoise3DEffect(), blendMode = BlendMode.OVERLAY, opacity = 0.6f),
+                EffectLayer(SolidColorEffect(), blendMode = BlendMode.NORMAL, opacity = 0.25f),
+                EffectLayer(Chase3DEffect(), enabled = false),
+                EffectLayer(SolidColorEffect(), opacity = 0f)
+            ),
+            masterDimmer = 0.75f
+        )
+        val evaluator = stack.buildFrame(1.3f, beat)
+        val out = ColorBuffer(positions.size)
+        evaluator.evaluateBatch(positions, out, ColorBuffer(positions.size))
+
+        for (i in 0 until positions.size) {
+            assertEquals(evaluator.evaluate(positions.points[i]), out[i], "differs at ${positions.points[i]}")
+        }
+    }
+
+    @Test
+    fun stackBatchClearsPreviousFrame() {
+        val stack = EffectStack(layers = listOf(EffectLayer(SolidColorEffect())))
+        val out = ColorBuffer(positions.size)
+        val scratch = ColorBuffer(positions.size)
+        stack.buildFrame(0f, beat).evaluateBatch(positions, out, scratch)
+
+        stack.clearLayers()
+        stack.buildFrame(0f, beat).evaluateBatch(positions, out, scratch)
+
+        for (i in 0 until positions.size) assertEquals(Color.BLACK, out[i])
+    }
+
+    @Test
+    fun reusedEvaluatorMatchesFreshOneAcrossLayerChanges() {
+        val stack = EffectStack(
+            layers = listOf(
+                EffectLayer(GradientSweep3DEffect()),
+                EffectLayer(WaveEffect3DEffect(), blendMode = BlendMode.ADDITIVE, opacity = 0.5f)
+            )
+        )
+        val reused = EffectStack.FrameEvaluator()
+        val out = ColorBuffer(positions.size)
+        val expected = ColorBuffer(positions.size)
+        val scratch = ColorBuffer(positions.size)
+
+        for (frame in 0 until 3) {
+            if (frame == 1) stack.removeLayerAt(0)
+            if (frame == 2) stack.addLayer(EffectLayer(RadialPulse3DEffect(), blendMode = BlendMode.MULTIPLY))
+            val time = frame * 0.4f
+            assertTrue(stack.buildFrame(time, beat, reused) === reused)
+            reused.evaluateBatch(positions, out, scratch)
+            stack.buildFrame(time, beat).evaluateBatch(positions, expected, scratch)
+
+            for (i in 0 until positions.size) assertEquals(expected[i], out[i], "frame $frame, index $i")
+        }
+    }
+}
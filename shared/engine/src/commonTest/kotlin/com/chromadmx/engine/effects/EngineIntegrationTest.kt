@@ -15,6 +15,7 @@ import kotlin.test.Test
 import kotlin.test.assertEquals
 import kotlin.test.assertNotNull
 import kotlin.test.assertNull
+import kotlin.test.assertSame
 import kotlin.test.assertTrue
 import kotlinx.coroutines.test.TestScope
 
@@ -328,7 +329,7 @@ class EngineIntegrationTest {
 
         engine.tick()
 
-        val colors = engine.colorOutput.read()
+        val colors = engine.colorOutput.read().toList()
         assertEquals(4, colors.size)
         for (color in colors) {
             assertEquals(Color.BLUE, color)
@@ -342,6 +343,30 @@ class EngineIntegrationTest {
         }
     }
 
+    @Test
+    fun engineTickReusesUnchangedFixtureOutputs() {
+        val engine = EffectEngine(TestScope(), makeFixtures(4))
+        engine.effectStack.addLayer(
+            EffectLayer(SolidColorEffect(), params = EffectParams().with("color", Color.BLUE))
+        )
+        engine.effectStack.addMovementLayer(
+            MovementLayer(SweepMovementEffect(), params = EffectParams().with("axis", "pan"))
+        )
+
+        // A fixed time holds the look; each slot comes back every third frame
+        val first = List(3) {
+            engine.tick(0f)
+            engine.fixtureOutputBuffer.read()[0]
+        }
+        val again = List(3) {
+            engine.tick(0f)
+            engine.fixtureOutputBuffer.read()[0]
+        }
+
+        assertEquals(Color.BLUE, first[0].color)
+        for (i in 0 until 3) assertSame(first[i], again[i])
+    }
+
     @Test
     fun backwardCompatEvaluateColorStillWorks() {
         val stack = EffectStack(
@@ -108,7 +108,7 @@ class ColorPipelineTest {
         // Step 6: Read from TripleBuffer (as syncColorsFromEngine does)
         val buffer = engine.colorOutput
         buffer.swapRead()
-        val colors = buffer.readSlot()
+        val colors = buffer.readSlot().toList()
 
         // Step 7: At least some fixtures should be non-black
         val hasColor = colors.any { c -> c.r > 0.001f || c.g > 0.001f || c.b > 0.001f }
@@ -144,7 +144,7 @@ class ColorPipelineTest {
         // Read from the NEW TripleBuffer
         val buffer = engine.colorOutput
         buffer.swapRead()
-        val colors = buffer.readSlot()
+        val colors = buffer.readSlot().toList()
 
         val hasColor = colors.any { c -> c.r > 0.001f || c.g > 0.001f || c.b > 0.001f }
         assertTrue(hasColor, "After updateFixtures + tick, preset colors should be visible. " +
@@ -209,7 +209,7 @@ class ColorPipelineTest {
         engine.tick()
         val buf1 = engine.colorOutput
         buf1.swapRead()
-        val colors1 = buf1.readSlot()
+        val colors1 = buf1.readSlot().toList()
         val hasColor1 = colors1.any { c -> c.r > 0.001f || c.g > 0.001f || c.b > 0.001f }
         assertTrue(hasColor1, "Should have colors before updateFixtures")
 
@@ -222,7 +222,7 @@ class ColorPipelineTest {
         // Read from the NEW buffer
         val buf2 = engine.colorOutput
         buf2.swapRead()
-        val colors2 = buf2.readSlot()
+        val colors2 = buf2.readSlot().toList()
         val hasColor2 = colors2.any { c -> c.r > 0.001f || c.g > 0.001f || c.b > 0.001f }
         assertTrue(hasColor2, "After updateFixtures + tick, colors should still be visible. " +
             "Colors: ${colors2.map { "(${it.r},${it.g},${it.b})" }}")
@@ -331,7 +331,7 @@ class ColorPipelineTest {
         val hasDirtyAfter = bufAfter.swapRead()
         assertTrue(hasDirtyAfter, "Buffer should be dirty after engine tick")
 
-        val colors = bufAfter.readSlot()
+        val colors = bufAfter.readSlot().toList()
         val hasColor = colors.any { c -> c.r > 0.001f || c.g > 0.001f || c.b > 0.001f }
         assertTrue(hasColor, "Reader should see non-black colors after one tick on new buffer")
     }
@@ -0,0 +1,117 @@
+package com.chromadmx.engine.pipeline
+
+import com.chromadmx.core.model.BeatState
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+import kotlinx.coroutines.test.TestScope
+
+class CueQueueTest {
+
+    private fun beat(beatPhase: Float, barPhase: Float) =
+        BeatState(bpm = 120f, beatPhase = beatPhase, barPhase = barPhase, elapsed = 0f)
+
+    @Test
+    fun immediateCueFiresOnNextAdvance() {
+        val queue = CueQueue()
+        var fired = 0
+        queue.schedule(CueQuantize.IMMEDIATE) { fired++ }
+
+        assertEquals(1, queue.advance(beat(0.3f, 0.1f)))
+        assertEquals(1, fired)
+        assertEquals(0, queue.size)
+    }
+
+    @Test
+    fun barCueWaitsForDownbeat() {
+        val queue = CueQueue()
+        var fired = false
+        queue.advance(beat(0.2f, 0.3f))
+        queue.schedule(CueQuantize.BAR) { fired = true }
+
+        // Beat wraps inside the bar do not count.
+        queue.advance(beat(0.9f, 0.5f))
+        queue.advance(beat(0.1f, 0.55f))
+        queue.advance(beat(0.9f, 0.95f))
+        assertTrue(!fired)
+
+        assertEquals(1, queue.advance(beat(0.05f, 0.01f)))
+        assertTrue(fired)
+    }
+
+    @Test
+    fun beatCueFiresOnNextBeatWrap() {
+        val queue = CueQueue()
+        var fired = false
+        queue.advance(beat(0.4f, 0.1f))
+        queue.schedule(CueQuantize.BEAT) { fired = true }
+
+        queue.advance(beat(0.8f, 0.2f))
+        assertTrue(!fired)
+        queue.advance(beat(0.02f, 0.25f))
+        assertTrue(fired)
+    }
+
+    @Test
+    fun cueScheduledAfterBoundaryWaitsForTheNextOne() {
+        val queue = CueQueue()
+        var fired = 0
+        queue.advance(beat(0.9f, 0.95f))
+        queue.advance(beat(0.05f, 0.01f))  // Downbeat with nothing queued
+        queue.schedule(CueQuantize.BAR) { fired++ }
+
+        queue.advance(beat(0.5f, 0.4f))
+        assertEquals(0, fired)
+        queue.advance(beat(0.5f, 0.9f))
+        queue.advance(beat(0.1f, 0.02f))
+        assertEquals(1, fired)
+    }
+
+    @Test
+    fun smallBackwardCorrectionIsNotABoundary() {
+        val queue = CueQueue()
+        var fired = false
+        queue.advance(beat(0.5f, 0.6f))
+        queue.schedule(CueQuantize.BAR) { fired = true }
+
+        queue.advance(beat(0.45f, 0.58f))
+        assertTrue(!fired)
+    }
+
+    @Test
+    fun dueCuesFireTogetherInSchedulingOrder() {
+        val queue = CueQueue()
+        val order = mutableListOf<Int>()
+        queue.advance(beat(0.5f, 0.9f))
+        queue.schedule(CueQuantize.BAR) { order += 1 }
+        queue.schedule(CueQuantize.BEAT) { order += 2 }
+        queue.schedule(CueQuantize.BAR) { order += 3 }
+        queue.advance(beat(0.6f, 0.92f))
+
+        assertEquals(3, queue.advance(beat(0.01f, 0.0f)))
+        assertEquals(listOf(1, 2, 3), order)
+    }
+
+    @Test
+    fun clearDropsPendingCues() {
+        val queue = CueQueue()
+        var fired = false
+        queue.schedule(CueQuantize.BAR) { fired = true }
+        queue.clear()
+
+        queue.advance(beat(0.9f, 0.95f))
+        queue.advance(beat(0.1f, 0.01f))
+        assertTrue(!fired)
+        assertEquals(0, queue.size)
+    }
+
+    @Test
+    fun engineTickDrainsCueQueue() {
+        val engine = EffectEngine(TestScope())
+        var fired = false
+        engine.cueQueue.schedule(CueQuantize.IMMEDIATE) { fired = true }
+
+        engine.tick()
+        assertTrue(fired)
+    }
+}
@@ -7,6 +7,8 @@ import com.chromadmx.core.model.Color
 import com.chromadmx.core.model.Fixture
 import com.chromadmx.core.model.Fixture3D
 import com.chromadmx.core.model.Vec3
+import com.chromadmx.core.telemetry.PerformanceTelemetry
+import com.chromadmx.engine.effect.ColorBuffer
 import com.chromadmx.engine.effect.EffectLayer
 import com.chromadmx.engine.effect.SpatialEffect
 import com.chromadmx.engine.effects.GradientSweep3DEffect
@@ -15,6 +17,7 @@ import com.chromadmx.engine.effects.RainbowSweep3DEffect
 import com.chromadmx.engine.effects.SolidColorEffect
 import kotlin.test.Test
 import kotlin.test.assertEquals
+import kotlin.test.assertFalse
 import kotlin.test.assertTrue
 import kotlin.time.measureTime
 import kotlinx.coroutines.test.TestScope
@@ -85,13 +88,98 @@ class EffectEngineTest {
         engine.tick()
 
         // Read from triple buffer
-        val output = engine.colorOutput.read()
+        val output = engine.colorOutput.read().toList()
         assertEquals(5, output.size)
         for (color in output) {
             assertEquals(Color.GREEN, color)
         }
     }
 
+    @Test
+    fun workspaceIsSizedFromTheFixtureSnapshot() {
+        val snapshot = EffectEngine.buildSnapshot(makeFixtures(24))
+
+        assertEquals(24, snapshot.workspace.fixtureCount)
+        assertEquals(24, snapshot.workspace.layerScratch.size)
+        assertEquals(0, EffectEngine.buildSnapshot(emptyList()).workspace.fixtureCount)
+    }
+
+    @Test
+    fun engineTickPublishesPrimitiveColorFrames() {
+        val fixtures = makeFixtures(4)
+        val engine = EffectEngine(TestScope(), fixtures)
+        engine.effectStack.addLayer(
+            EffectLayer(GradientSweep3DEffect(), params = EffectParams().with("speed", 0f))
+        )
+
+        engine.tick()
+
+        val frame = engine.colorFrames.read()
+        val colors = engine.colorOutput.read()
+        assertEquals(4, frame.size)
+        for (i in 0 until 4) {
+            assertEquals(colors[i], frame[i])
+        }
+    }
+
+    @Test
+    fun engineTickCopiesColorsIntoTheSameThreeSlots() {
+        val engine = EffectEngine(TestScope(), makeFixtures(4))
+        engine.effectStack.addLayer(
+            EffectLayer(SolidColorEffect(), params = EffectParams().with("color", Color.RED))
+        )
+        val colorOutput = engine.colorOutput
+
+        // Identity set: ColorBuffer has no equals, so only new buffers would grow it
+        val seen = mutableSetOf<ColorBuffer>()
+        repeat(9) {
+            engine.tick()
+            seen += colorOutput.read()
+        }
+
+        assertEquals(3, seen.size)
+        assertEquals(Color.RED, colorOutput.readSlot()[3])
+    }
+
+    @Test
+    fun engineHoldsLastFrameWhileTransportStopped() {
+        val fixtures = makeFixtures(3)
+        val engine = EffectEngine(TestScope(), fixtures)
+        engine.effectStack.addLayer(
+            EffectLayer(SolidColorEffect(), params = EffectParams().with("color", Color.RED))
+        )
+        engine.tick()
+        assertTrue(engine.colorFrames.swapRead())
+
+        engine.beatStateProvider = { BeatState.IDLE.copy(isPlaying = false) }
+        engine.tick()
+        assertFalse(engine.colorFrames.swapRead(), "stopped transport publishes nothing")
+        assertEquals(Color.RED, engine.colorFrames.readSlot()[0])
+
+        engine.beatStateProvider = { BeatState.IDLE }
+        engine.tick()
+        assertTrue(engine.colorFrames.swapRead())
+    }
+
+    @Test
+    fun engineRecordsBeatSyncErrorOnBeatWrap() {
+        val telemetry = PerformanceTelemetry()
+        val engine = EffectEngine(TestScope(), makeFixtures(1), telemetry)
+        var phase = 0.9f
+        engine.beatStateProvider = { BeatState(bpm = 120f, beatPhase = phase, barPhase = 0f, elapsed = 0f) }
+
+        engine.tick()
+        phase = 0.95f
+        engine.tick()
+        assertEquals(0L, telemetry.beatSyncError.count)
+
+        // A quarter of a 500ms beat past the boundary.
+        phase = 0.25f
+        engine.tick()
+        assertEquals(1L, telemetry.beatSyncError.count)
+        assertEquals(125_000L, telemetry.beatSyncError.maxMicros)
+    }
+
     @Test
     fun engineMasterDimmerAffectsOutput() {
         val fixtures = makeFixtures(3)
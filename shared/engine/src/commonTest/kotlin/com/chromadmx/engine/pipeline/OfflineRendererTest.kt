@@ -0,0 +1,109 @@
+package com.chromadmx.engine.pipeline
+
+import com.chromadmx.core.EffectParams
+import com.chromadmx.core.model.BeatState
+import com.chromadmx.core.model.Color
+import com.chromadmx.core.model.Fixture
+import com.chromadmx.core.model.Fixture3D
+import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.effect.EffectLayer
+import com.chromadmx.engine.effects.RainbowSweep3DEffect
+import com.chromadmx.engine.effects.SolidColorEffect
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertNotEquals
+import kotlinx.coroutines.test.TestScope
+
+class OfflineRendererTest {
+
+    private fun makeEngine(fixtureCount: Int = 8): EffectEngine {
+        val fixtures = (0 until fixtureCount).map { i ->
+            Fixture3D(
+                fixture = Fixture(
+                    fixtureId = "fix-$i",
+                    name = "Fixture $i",
+                    channelStart = i * 3 + 1,
+                    channelCount = 3,
+                    universeId = 1
+                ),
+                position = Vec3(x = i / fixtureCount.toFloat(), y = 0f, z = 0f)
+            )
+        }
+        return EffectEngine(TestScope(), fixtures).apply {
+            effectStack.addLayer(EffectLayer(RainbowSweep3DEffect()))
+        }
+    }
+
+    /** 120 BPM from time 0. */
+    private val beatAt: (Long) -> BeatState = { micros ->
+        val beat = micros / 500_000.0
+        BeatState(
+            bpm = 120f,
+            beatPhase = (beat % 1.0).toFloat(),
+            barPhase = ((beat % 4.0) / 4.0).toFloat(),
+            elapsed = micros / 1_000_000f
+        )
+    }
+
+    @Test
+    fun renderIsDeterministic() {
+        val first = OfflineRenderer(makeEngine()).renderGolden(400, beatAt)
+        val second = OfflineRenderer(makeEngine()).renderGolden(400, beatAt)
+
+        assertContentEquals(first, second)
+        assertEquals(-1, GoldenFrames.firstMismatch(first, second))
+    }
+
+    @Test
+    fun goldenHeaderDescribesRender() {
+        val golden = OfflineRenderer(makeEngine(5), frameRateHz = 60).renderGolden(12, beatAt)
+
+        assertEquals(5, GoldenFrames.fixtureCount(golden))
+        assertEquals(60, GoldenFrames.frameRateHz(golden))
+        assertEquals(12, GoldenFrames.frameCount(golden))
+        assertEquals(GoldenFrames.HEADER_SIZE + 12 * 5 * 3, golden.size)
+    }
+
+    @Test
+    fun framesAdvanceOnVirtualTime() {
+        val renderer = OfflineRenderer(makeEngine())
+        val times = mutableListOf<Long>()
+        val greens = mutableListOf<Float>()
+        renderer.render(3, beatAt) { _, timeMicros, frame ->
+            times += timeMicros
+            greens += frame.g[0]
+        }
+
+        assertEquals(listOf(0L, 25_000L, 50_000L), times)
+        assertNotEquals(greens[0], greens[2], "effect should move between frames")
+    }
+
+    @Test
+    fun stoppedTransportRepeatsPreviousFrame() {
+        val engine = makeEngine(2)
+        engine.effectStack.clearLayers()
+        engine.effectStack.addLayer(
+            EffectLayer(SolidColorEffect(), params = EffectParams().with("color", Color.RED))
+        )
+        val golden = OfflineRenderer(engine).renderGolden(4) { micros ->
+            beatAt(micros).copy(isPlaying = micros == 0L)
+        }
+
+        val frameSize = 2 * 3
+        val red = 255.toByte()
+        for (frame in 0 until 4) {
+            assertEquals(red, golden[GoldenFrames.HEADER_SIZE + frame * frameSize], "frame $frame")
+        }
+    }
+
+    @Test
+    fun mismatchReportsFirstDifferingFrame() {
+        val expected = OfflineRenderer(makeEngine()).renderGolden(40, beatAt)
+        val actual = expected.copyOf()
+        val frameSize = 8 * 3
+        actual[GoldenFrames.HEADER_SIZE + 17 * frameSize + 4]++
+
+        assertEquals(17, GoldenFrames.firstMismatch(expected, actual))
+    }
+}
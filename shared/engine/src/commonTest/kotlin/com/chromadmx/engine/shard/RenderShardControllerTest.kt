@@ -0,0 +1,155 @@
+package com.chromadmx.engine.shard
+
+import com.chromadmx.core.model.Fixture
+import com.chromadmx.core.model.Fixture3D
+import com.chromadmx.core.model.Vec3
+import com.chromadmx.engine.pipeline.EffectEngine
+import com.chromadmx.tempo.link.VirtualLinkSession
+import kotlinx.coroutines.test.TestScope
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class RenderShardControllerTest {
+
+    /** [perUniverse] fixtures on each of [universes], spread along x. */
+    private fun rig(universes: List<Int>, perUniverse: (Int) -> Int = { 4 }): List<Fixture3D> {
+        var x = 0
+        return universes.flatMap { universe ->
+            (0 until perUniverse(universe)).map { i ->
+                Fixture3D(
+                    fixture = Fixture(
+                        fixtureId = "u$universe-$i",
+                        name = "U$universe #$i",
+                        channelStart = i * 3 + 1,
+                        channelCount = 3,
+                        universeId = universe
+                    ),
+                    position = Vec3(x = (x++).toFloat(), y = 0f, z = 0f)
+                )
+            }
+        }
+    }
+
+    @Test
+    fun assignmentCoversEveryUniverseOnce() {
+        val rig = rig(listOf(0, 1, 2, 3, 4))
+        val owners = ShardAssignment.assign(rig, deviceCount = 3)
+
+        assertEquals(setOf(0, 1, 2, 3, 4), owners.keys)
+        val shards = (0 until 3).map { ShardAssignment.universesFor(rig, it, 3) }
+        assertEquals(5, shards.sumOf { it.size })
+        assertEquals(setOf(0, 1, 2, 3, 4), shards.flatten().toSet())
+    }
+
+    @Test
+    fun assignmentIgnoresRigOrder() {
+        val rig = rig(listOf(7, 2, 5, 1)) { it + 1 }
+        assertEquals(ShardAssignment.assign(rig, 2), ShardAssignment.assign(rig.reversed(), 2))
+    }
+
+    @Test
+    fun assignmentBalancesFixtureLoad() {
+        // 8 + 4 + 2 + 2 fixtures: the big universe alone, the rest together.
+        val sizes = mapOf(0 to 8, 1 to 4, 2 to 2, 3 to 2)
+        val owners = ShardAssignment.assign(rig(sizes.keys.toList()) { sizes.getValue(it) }, 2)
+
+        assertEquals(mapOf(0 to 0, 1 to 1, 2 to 1, 3 to 1), owners)
+    }
+
+    @Test
+    fun startsOnWholeRigThenShardsOncePeersSettle() {
+        val rig = rig(listOf(0, 1))
+        val engine = EffectEngine(TestScope(), rig)
+        var now = 0L
+        var peers = 1
+        val controller = RenderShardController(
+            engine, rig, deviceIndex = 1, deviceCount = 2,
+            peerCount = { peers }, scope = TestScope(), clockMs = { now }
+        )
+
+        controller.start()
+        assertTrue(controller.isFailover.value)
+        assertEquals(8, engine.fixtures.size)
+
+        controller.update()
+        now = RenderShardController.DEFAULT_RECOVER_AFTER_MS - 1
+        controller.update()
+        assertTrue(controller.isFailover.value)
+
+        now = RenderShardController.DEFAULT_RECOVER_AFTER_MS
+        controller.update()
+        assertFalse(controller.isFailover.value)
+        assertEquals(setOf(1), controller.ownedUniverses.value)
+        assertTrue(engine.fixtures.all { it.fixture.universeId == 1 })
+        controller.stop()
+    }
+
+    @Test
+    fun peerDropTakesOverWholeRigImmediately() {
+        val rig = rig(listOf(0, 1, 2))
+        val engine = EffectEngine(TestScope(), rig)
+        var now = 0L
+        var peers = 2
+        val controller = RenderShardController(
+            engine, rig, deviceIndex = 0, deviceCount = 3,
+            peerCount = { peers }, scope = TestScope(), recoverAfterMs = 0L, clockMs = { now }
+        )
+        controller.start()
+        controller.update()
+        assertFalse(controller.isFailover.value)
+        assertEquals(4, engine.fixtures.size)
+
+        peers = 1
+        now += 1
+        controller.update()
+        assertTrue(controller.isFailover.value)
+        assertEquals(setOf(0, 1, 2), controller.ownedUniverses.value)
+        assertEquals(12, engine.fixtures.size)
+        controller.stop()
+    }
+
+    @Test
+    fun bridgeFollowsTheShard() {
+        val rig = rig(listOf(0, 1))
+        val engine = EffectEngine(TestScope(), rig)
+        var now = 0L
+        val controller = RenderShardController(
+            engine, rig, deviceIndex = 0, deviceCount = 2,
+            peerCount = { 1 }, scope = TestScope(), clockMs = { now }
+        )
+        controller.start()
+        val full = controller.dmxBridge()
+        assertTrue(full === controller.dmxBridge(), "bridge is cached while the shard is unchanged")
+
+        controller.update()
+        now = RenderShardController.DEFAULT_RECOVER_AFTER_MS
+        controller.update()
+        val shard = controller.dmxBridge()
+        assertFalse(full === shard)
+        assertEquals(setOf(0), shard.convert(engine.colorOutput.readSlot()).keys)
+        controller.stop()
+    }
+
+    @Test
+    fun shardKeepsRigWidePositions() {
+        val rig = rig(listOf(0, 1))
+        val whole = EffectEngine.normalizePositions(rig)
+        val shard = rig.filter { it.fixture.universeId == 1 }
+
+        assertEquals(whole.takeLast(4), EffectEngine.normalizePositions(shard, rig))
+    }
+
+    @Test
+    fun linkEffectTimeFollowsTheSharedTimeline() {
+        val session = VirtualLinkSession(initialBpm = 120.0)
+        val effectTime = RenderShardController.linkEffectTime(session)
+
+        assertEquals(0f, effectTime())
+        session.advanceMicros(1_000_000L)
+        assertEquals(1f, effectTime(), 1e-5f)
+        session.advanceMicros(500_000L)
+        assertEquals(1.5f, effectTime(), 1e-5f, "120 BPM runs effects in real time")
+    }
+}
@@ -56,4 +56,50 @@ class PerlinNoiseTest {
         // Very unlikely to be exactly the same
         assertTrue(v1 != v2 || v1 == 0f, "Noise should vary spatially")
     }
+
+    @Test
+    fun singleOctaveFbmIsPlainNoise() {
+        for (i in 0 until 50) {
+            val x = i * 0.37f - 4f
+            val y = i * 0.11f
+            val z = i * 0.73f + 1f
+            assertEquals(PerlinNoise.noise(x, y, z), PerlinNoise.fbm(x, y, z, octaves = 1))
+        }
+    }
+
+    @Test
+    fun fbmStaysInRange() {
+        for (i in 0 until 200) {
+            val v = PerlinNoise.fbm(i * 0.173f, i * 0.291f, i * 0.047f, octaves = 5)
+            assertTrue(v in -1.1f..1.1f, "fbm out of range: $v")
+        }
+    }
+
+    @Test
+    fun batchMatchesScalarBitForBit() {
+        val n = 64
+        val xs = FloatArray(n) { it * 0.37f - 4f }
+        val ys = FloatArray(n) { it * 0.11f }
+        val zs = FloatArray(n) { 1f - it * 0.05f }
+        for (octaves in listOf(1, 4)) {
+            val out = FloatArray(n)
+            PerlinNoise.fbm01Batch(xs, ys, zs, out, scale = 2.5f, zOffset = 0.3f, octaves = octaves)
+            for (i in 0 until n) {
+                val expected = PerlinNoise.fbm01(xs[i] * 2.5f, ys[i] * 2.5f, zs[i] * 2.5f + 0.3f, octaves)
+                assertEquals(expected.toRawBits(), out[i].toRawBits(), "octaves=$octaves i=$i")
+            }
+        }
+    }
+
+    @Test
+    fun batchMayWriteIntoInputArray() {
+        val xs = FloatArray(16) { it * 0.3f }
+        val ys = FloatArray(16) { it * 0.2f }
+        val zs = FloatArray(16) { it * 0.1f }
+        val expected = FloatArray(16) { PerlinNoise.noise01(xs[it], ys[it], zs[it]) }
+
+        PerlinNoise.fbm01Batch(xs, ys, zs, out = xs)
+
+        for (i in 0 until 16) assertEquals(expected[i], xs[i])
+    }
 }
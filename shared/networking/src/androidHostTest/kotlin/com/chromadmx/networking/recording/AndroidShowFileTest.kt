@@ -0,0 +1,78 @@
+package com.chromadmx.networking.recording
+
+import java.io.File
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+
+class AndroidShowFileTest {
+
+    private val path: String = File.createTempFile("show", ".cdx").absolutePath
+
+    @AfterTest
+    fun deleteFile() {
+        File(path).delete()
+    }
+
+    private fun ShowFile.readAt(position: Long, count: Int): ByteArray {
+        val into = ByteArray(count)
+        assertEquals(count, read(position, into, 0, count))
+        return into
+    }
+
+    @Test
+    fun readerFollowsAGrowingFile() {
+        val writer = openShowFile(path, writable = true)
+        writer.append(byteArrayOf(1, 2, 3))
+        val reader = openShowFile(path, writable = false)
+        assertEquals(3L, reader.length)
+
+        writer.append(byteArrayOf(4, 5))
+        assertContentEquals(byteArrayOf(3, 4, 5), reader.readAt(2L, 3))
+        assertEquals(5L, reader.length)
+
+        writer.close()
+        reader.close()
+    }
+
+    @Test
+    fun mappedReaderSeesBytesPastTheMap() {
+        // A megabyte is enough for reads to come from a memory map.
+        val megabyte = 1 shl 20
+        val writer = openShowFile(path, writable = true)
+        writer.append(ByteArray(megabyte) { 1 })
+        val reader = openShowFile(path, writable = false)
+        assertContentEquals(byteArrayOf(1, 1), reader.readAt(megabyte - 2L, 2))
+
+        // A short tail is read through the channel, a long one remaps.
+        writer.append(byteArrayOf(2, 3))
+        assertContentEquals(byteArrayOf(1, 2, 3), reader.readAt(megabyte - 1L, 3))
+        writer.append(ByteArray(2 * megabyte) { 4 })
+        assertContentEquals(byteArrayOf(3, 4), reader.readAt(megabyte + 1L, 2))
+        assertEquals(3L * megabyte + 2, reader.length)
+
+        writer.close()
+        reader.close()
+    }
+
+    @Test
+    fun playerFollowsALiveRecording() {
+        val indexPath = File.createTempFile("show", ".cdxi").absolutePath
+        val frame = { level: Int -> mapOf(0 to ByteArray(512) { level.toByte() }) }
+        val recorder = ShowRecorder(openShowFile(path, writable = true), openShowFile(indexPath, writable = true))
+        recorder.record(frame(10), 0L, 0.0)
+
+        val player = ShowPlayer(openShowFile(path, writable = false), openShowFile(indexPath, writable = false))
+        assertEquals(1L, player.barCount)
+        recorder.record(frame(20), 2_000_000L, 4.0)
+        recorder.record(frame(30), 4_000_000L, 8.0)
+
+        assertEquals(3L, player.barCount)
+        assertEquals(30, player.frameAt(8.0).getValue(0)[0].toInt())
+
+        recorder.close()
+        player.close()
+        File(indexPath).delete()
+    }
+}
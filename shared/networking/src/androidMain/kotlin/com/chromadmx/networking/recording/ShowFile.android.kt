@@ -0,0 +1,116 @@
+package com.chromadmx.networking.recording
+
+import java.io.RandomAccessFile
+import java.nio.ByteBuffer
+import java.nio.MappedByteBuffer
+import java.nio.channels.FileChannel
+
+/**
+ * Android actual backed by a [RandomAccessFile].
+ *
+ * Reads come from a read-only memory map of the file, so seeking through
+ * a long recording is page-cache reads rather than syscalls. While the
+ * file grows, reads past the map use positional channel reads, and the
+ * file is only remapped once that unmapped tail is as large as the map
+ * itself (and at least [MIN_REMAP_BYTES]). Each remap at least doubles the
+ * map, so a recording being played back while it is written is remapped
+ * O(log size) times; remapping on every frame would exhaust the address
+ * space of 32-bit devices. Files too large to map in one piece always use
+ * channel reads.
+ *
+ * A read-only handle re-stats the file when asked for bytes past the size
+ * it knows (and for [ShowFile.length]), so a player follows a recording
+ * that another handle is still appending to.
+ */
+actual fun openShowFile(path: String, writable: Boolean): ShowFile =
+    AndroidShowFile(RandomAccessFile(path, if (writable) "rw" else "r"), writable)
+
+private class AndroidShowFile(
+    private val file: RandomAccessFile,
+    private val writable: Boolean
+) : ShowFile {
+
+    private val channel: FileChannel = file.channel
+
+    /** Guards updates of [size] and [map]; reads go through the volatile fields. */
+    private val lock = Any()
+
+    @Volatile
+    private var size: Long
+
+    @Volatile
+    private var map: MappedByteBuffer? = null
+
+    init {
+        if (writable) file.setLength(0L)
+        size = channel.size()
+    }
+
+    override val length: Long get() = if (writable) size else refreshSize()
+
+    override fun append(bytes: ByteArray, offset: Int, length: Int) {
+        val buffer = ByteBuffer.wrap(bytes, offset, length)
+        synchronized(lock) {
+            while (buffer.hasRemaining()) {
+                size += channel.write(buffer, size)
+            }
+        }
+    }
+
+    override fun read(position: Long, into: ByteArray, offset: Int, length: Int): Int {
+        var known = size
+        if (!writable && position + length > known) known = refreshSize()
+        if (position >= known) return 0
+        val count = minOf(length.toLong(), known - position).toInt()
+        val mapped = mapCovering(position + count, known)
+        if (mapped != null) {
+            val view = mapped.duplicate()
+            view.position(position.toInt())
+            view.get(into, offset, count)
+            return count
+        }
+        val buffer = ByteBuffer.wrap(into, offset, count)
+        var at = position
+        while (buffer.hasRemaining()) {
+            val read = channel.read(buffer, at)
+            if (read < 0) break
+            at += read
+        }
+        return buffer.position() - offset
+    }
+
+    /** Size of the file on disk, which another handle may be appending to; never shrinks. */
+    private fun refreshSize(): Long = synchronized(lock) {
+        maxOf(size, channel.size()).also { size = it }
+    }
+
+    /**
+     * The map if it covers [end], remapped to [known] bytes when the tail is
+     * due; null to read through the channel.
+     */
+    private fun mapCovering(end: Long, known: Long): MappedByteBuffer? {
+        val current = map
+        if (current != null && current.capacity() >= end) return current
+        synchronized(lock) {
+            val latest = map
+            if (latest != null && latest.capacity() >= end) return latest
+            val mapped = latest?.capacity()?.toLong() ?: 0L
+            if (known - mapped < maxOf(mapped, MIN_REMAP_BYTES) || known > Int.MAX_VALUE) return null
+            return channel.map(FileChannel.MapMode.READ_ONLY, 0L, known).also { map = it }
+        }
+    }
+
+    override fun flush() {
+        channel.force(false)
+    }
+
+    override fun close() {
+        map = null
+        file.close()
+    }
+
+    private companion object {
+        /** Smallest unmapped tail worth a new map; smaller files are read through the channel. */
+        const val MIN_REMAP_BYTES = 1L shl 20
+    }
+}
@@ -0,0 +1,74 @@
+package com.chromadmx.networking.transport
+
+import java.net.DatagramPacket
+import java.net.InetAddress
+import java.net.InetSocketAddress
+import java.net.MulticastSocket
+import java.net.SocketException
+import java.net.SocketTimeoutException
+
+/**
+ * Android actual using a [MulticastSocket] bound to the wildcard address.
+ *
+ * Receiving multicast on Android also needs a `WifiManager.MulticastLock`
+ * held by the app while sACN input is wanted.
+ */
+actual class PlatformUdpReceiver actual constructor(private val port: Int) {
+
+    private val socket: MulticastSocket = MulticastSocket(null).apply {
+        reuseAddress = true
+        bind(InetSocketAddress(port))
+    }
+
+    private val packet = DatagramPacket(ByteArray(0), 0)
+    private var timeoutMs = -1
+
+    /** Last sender and its address as an Int, to skip re-reading the octets. */
+    private var lastSender: InetAddress? = null
+    private var lastSenderInt = 0
+
+    actual fun joinMulticastGroup(group: String) {
+        socket.joinGroup(InetSocketAddress(InetAddress.getByName(group), port), null)
+    }
+
+    actual fun receive(into: UdpDatagram, timeoutMs: Int): Boolean {
+        return try {
+            if (timeoutMs != this.timeoutMs) {
+                socket.soTimeout = timeoutMs
+                this.timeoutMs = timeoutMs
+            }
+            packet.setData(into.buffer, 0, into.buffer.size)
+            socket.receive(packet)
+            into.set(packet.length, senderInt(packet.address), packet.port)
+            true
+        } catch (_: SocketTimeoutException) {
+            false
+        } catch (_: SocketException) {
+            // Socket was closed
+            false
+        }
+    }
+
+    private fun senderInt(address: InetAddress?): Int {
+        if (address == null) return 0
+        if (address !== lastSender) {
+            val octets = address.address
+            lastSenderInt = if (octets.size == 4) {
+                ((octets[0].toInt() and 0xFF) shl 24) or
+                    ((octets[1].toInt() and 0xFF) shl 16) or
+                    ((octets[2].toInt() and 0xFF) shl 8) or
+                    (octets[3].toInt() and 0xFF)
+            } else {
+                0
+            }
+            lastSender = address
+        }
+        return lastSenderInt
+    }
+
+    actual val isClosed: Boolean get() = socket.isClosed
+
+    actual fun close() {
+        socket.close()
+    }
+}
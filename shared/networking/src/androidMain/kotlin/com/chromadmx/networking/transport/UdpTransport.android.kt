@@ -6,6 +6,7 @@ import kotlinx.coroutines.withContext
 import java.net.DatagramPacket
 import java.net.DatagramSocket
 import java.net.InetAddress
+import java.util.concurrent.ConcurrentHashMap
 
 /**
  * Android actual implementation using [DatagramSocket].
@@ -19,6 +20,12 @@ actual class PlatformUdpTransport actual constructor() {
         broadcast = true
     }
 
+    /** Resolved destinations; DMX output hits the same few addresses every frame. */
+    private val addressCache = ConcurrentHashMap<String, InetAddress>()
+
+    /** Datagram reused by [sendBatch]; only touched inside its IO block. */
+    private val batchDatagram = DatagramPacket(ByteArray(0), 0)
+
     actual suspend fun send(data: ByteArray, address: String, port: Int) {
         withContext(Dispatchers.IO) {
             val inetAddress = InetAddress.getByName(address)
@@ -27,6 +34,30 @@ actual class PlatformUdpTransport actual constructor() {
         }
     }
 
+    actual suspend fun sendBatch(batch: UdpBatch): Int {
+        if (batch.size == 0) return 0
+        return withContext(Dispatchers.IO) {
+            synchronized(batchDatagram) {
+                var sent = 0
+                for (i in 0 until batch.size) {
+                    try {
+                        batchDatagram.setData(batch.packet(i), 0, batch.length(i))
+                        batchDatagram.address = resolve(batch.address(i))
+                        batchDatagram.port = batch.port(i)
+                        socket.send(batchDatagram)
+                        sent++
+                    } catch (_: java.io.IOException) {
+                        // Unreachable node or closed socket: try the rest of the frame
+                    }
+                }
+                sent
+            }
+        }
+    }
+
+    private fun resolve(address: String): InetAddress =
+        addressCache.getOrPut(address) { InetAddress.getByName(address) }
+
     actual suspend fun receive(buffer: ByteArray, timeoutMs: Long): UdpPacket? {
         return withContext(Dispatchers.IO) {
             try {
@@ -17,6 +17,9 @@ enum class ConnectionState {
  *
  * Implementors include [com.chromadmx.networking.output.DmxOutputService]
  * for real hardware and SimulatedTransport for testing.
+ *
+ * [updateFrame] copies whatever it keeps: callers own the map and arrays
+ * they pass and may rewrite them as soon as the call returns.
  */
 interface DmxTransport {
     fun start()
@@ -0,0 +1,455 @@
+package com.chromadmx.networking.input
+
+import com.chromadmx.networking.protocol.ArtNetCodec
+import com.chromadmx.networking.protocol.ArtNetConstants
+import com.chromadmx.networking.protocol.SacnCodec
+import com.chromadmx.networking.protocol.SacnConstants
+import kotlinx.atomicfu.atomic
+import kotlin.concurrent.Volatile
+
+/**
+ * How sources of the same priority are combined per channel.
+ */
+enum class MergeMode {
+    /** Highest Takes Precedence: each channel is the maximum across sources. */
+    HTP,
+
+    /** Latest Takes Precedence: each channel is the value most recently changed by any source. */
+    LTP
+}
+
+/**
+ * Merges ArtDmx and E1.31 data from other controllers on the rig into one
+ * set of per-universe buffers.
+ *
+ * Only sources at the highest live priority contribute to a universe (sACN
+ * priority; Art-Net counts as [SacnConstants.DEFAULT_PRIORITY]), combined
+ * by [mode]. A source drops out after [ART_NET_SOURCE_TIMEOUT_MS] or
+ * [SACN_SOURCE_TIMEOUT_MS] of silence ([expire]), or at once when an sACN
+ * source sets Stream_Terminated.
+ *
+ * Packets are parsed in place and copied into preallocated per-source
+ * buffers, so [acceptArtDmx] and [acceptSacn] allocate nothing once a
+ * universe and source have been seen.
+ *
+ * Threading: the accept and [expire] methods take one writer at a time
+ * ([DmxReceiver] serialises its Art-Net and sACN loops); any thread may
+ * call [readUniverse]. Each universe is published
+ * through a sequence counter, and a reader that raced an update copies
+ * again.
+ *
+ * @param mode                  Merge rule for equal-priority sources
+ * @param maxUniverses          Universes tracked; packets for more are ignored
+ * @param maxSourcesPerUniverse Sources merged per universe; more are ignored
+ *                              until one times out
+ * @param ownCid                Our sACN CID, so our own multicast is not merged back
+ */
+class DmxMergeEngine(
+    val mode: MergeMode = MergeMode.HTP,
+    private val maxUniverses: Int = DEFAULT_MAX_UNIVERSES,
+    private val maxSourcesPerUniverse: Int = DEFAULT_MAX_SOURCES,
+    ownCid: ByteArray? = null
+) {
+    private class Source {
+        var active = false
+        var idHi = 0L
+        var idLo = 0L
+        var priority = 0
+        var sequence = NO_SEQUENCE
+        var lastSeenMs = 0L
+        var timeoutMs = 0L
+        val channels = ByteArray(ArtNetConstants.DMX_DATA_MAX_LENGTH)
+        var length = 0
+    }
+
+    private class Universe(val number: Int, sourceCount: Int) {
+        val sources = Array(sourceCount) { Source() }
+        val merged = ByteArray(ArtNetConstants.DMX_DATA_MAX_LENGTH)
+
+        /** Odd while [merged] is being written. */
+        val version = atomic(0)
+
+        @Volatile
+        var length = 0
+
+        /** Priority of the contributing sources, or -1 with no live source. */
+        @Volatile
+        var priority = NO_PRIORITY
+    }
+
+    private val universes = arrayOfNulls<Universe>(maxUniverses)
+
+    /** Entries of [universes] in use; written after the entry, so readers see it filled. */
+    @Volatile
+    private var universeCount = 0
+
+    private val hasOwnCid = ownCid != null
+    private val ownCidHi = if (ownCid != null) readLongBE(ownCid, 0) else 0L
+    private val ownCidLo = if (ownCid != null) readLongBE(ownCid, 8) else 0L
+
+    private var ignoredAddresses = IntArray(0)
+
+    /** Packets merged since creation. */
+    @Volatile
+    var packetsAccepted: Long = 0L
+        private set
+
+    /** Packets dropped: malformed, out of sequence, ours, or over a limit. */
+    @Volatile
+    var packetsRejected: Long = 0L
+        private set
+
+    /**
+     * Ignore ArtDmx from [address] (our own IPv4 as an Int, see
+     * [com.chromadmx.networking.transport.UdpDatagram.ipv4ToInt]), since our
+     * broadcasts are received back. Call before the receive loop starts.
+     */
+    fun ignoreArtNetSource(address: Int) {
+        ignoredAddresses += address
+    }
+
+    // ------------------------------------------------------------------ //
+    //  Input (receive loop)                                               //
+    // ------------------------------------------------------------------ //
+
+    /**
+     * Merge an ArtDmx packet of [length] bytes in [packet] from the IPv4
+     * [sourceAddress].
+     *
+     * @return true if it was an ArtDmx packet that was merged
+     */
+    fun acceptArtDmx(packet: ByteArray, length: Int, sourceAddress: Int, nowMs: Long): Boolean {
+        if (length < ArtNetConstants.ART_DMX_HEADER_SIZE ||
+            !ArtNetCodec.hasValidHeader(packet) ||
+            ArtNetCodec.readOpCode(packet) != ArtNetConstants.OP_DMX
+        ) {
+            return false
+        }
+        if (sourceAddress in ignoredAddresses) return reject()
+
+        val universe = ((packet[15].toInt() and 0x7F) shl 8) or (packet[14].toInt() and 0xFF)
+        val slots = readUInt16BE(packet, 16)
+        if (slots < 2 || slots > ArtNetConstants.DMX_DATA_MAX_LENGTH ||
+            ArtNetConstants.ART_DMX_HEADER_SIZE + slots > length
+        ) {
+            return reject()
+        }
+        return merge(
+            universe, ART_NET_SOURCE, sourceAddress.toLong(),
+            SacnConstants.DEFAULT_PRIORITY, NO_SEQUENCE, ART_NET_SOURCE_TIMEOUT_MS,
+            packet, ArtNetConstants.ART_DMX_HEADER_SIZE, slots, nowMs
+        )
+    }
+
+    /**
+     * Merge an E1.31 data packet of [length] bytes in [packet]. Preview
+     * data and non-zero start codes are ignored.
+     *
+     * @return true if it was an E1.31 data packet that was merged
+     */
+    fun acceptSacn(packet: ByteArray, length: Int, nowMs: Long): Boolean {
+        if (length < SACN_DATA_OFFSET || !SacnCodec.isValidPacket(packet) ||
+            readUInt32BE(packet, SACN_ROOT_VECTOR) != SacnConstants.VECTOR_ROOT_E131_DATA ||
+            readUInt32BE(packet, SACN_FRAMING_VECTOR) != SacnConstants.VECTOR_E131_DATA_PACKET
+        ) {
+            return false
+        }
+        val cidHi = readLongBE(packet, SACN_CID)
+        val cidLo = readLongBE(packet, SACN_CID + 8)
+        if (hasOwnCid && cidHi == ownCidHi && cidLo == ownCidLo) return reject()
+
+        val universe = readUInt16BE(packet, SACN_UNIVERSE)
+        val options = packet[SACN_OPTIONS].toInt() and 0xFF
+        if ((options and SacnConstants.OPTION_STREAM_TERMINATED) != 0) {
+            terminate(universe, cidHi, cidLo)
+            return true
+        }
+        val slots = readUInt16BE(packet, SACN_PROPERTY_COUNT) - 1
+        if ((options and SacnConstants.OPTION_PREVIEW) != 0 ||
+            packet[SACN_START_CODE].toInt() != 0 ||
+            (packet[SACN_DMP_VECTOR].toInt() and 0xFF) != SacnConstants.VECTOR_DMP_SET_PROPERTY ||
+            slots < 1 || slots > SacnConstants.MAX_DMX_SLOTS || SACN_DATA_OFFSET + slots > length
+        ) {
+            return reject()
+        }
+        return merge(
+            universe, cidHi, cidLo,
+            packet[SACN_PRIORITY].toInt() and 0xFF, packet[SACN_SEQUENCE].toInt() and 0xFF,
+            SACN_SOURCE_TIMEOUT_MS, packet, SACN_DATA_OFFSET, slots, nowMs
+        )
+    }
+
+    /** Drop sources silent past their timeout and re-merge their universes. */
+    fun expire(nowMs: Long) {
+        for (u in 0 until universeCount) {
+            val universe = universes[u] ?: continue
+            var dropped = false
+            for (source in universe.sources) {
+                if (source.active && nowMs - source.lastSeenMs > source.timeoutMs) {
+                    source.active = false
+                    dropped = true
+                }
+            }
+            if (dropped) remerge(universe)
+        }
+    }
+
+    // ------------------------------------------------------------------ //
+    //  Output (any thread)                                                //
+    // ------------------------------------------------------------------ //
+
+    /**
+     * Copy the merged channels of [universe] into [into].
+     *
+     * @return number of channels copied; 0 if no live source sends it
+     */
+    fun readUniverse(universe: Int, into: ByteArray): Int {
+        val state = find(universe) ?: return 0
+        var length: Int
+        var attempt = 0
+        while (true) {
+            val before = state.version.value
+            length = minOf(state.length, into.size)
+            state.merged.copyInto(into, 0, 0, length)
+            if ((before and 1) == 0 && state.version.value == before) break
+            // A writer mid-burst: a blended copy beats blocking the output loop.
+            if (++attempt == READ_ATTEMPTS) break
+        }
+        return length
+    }
+
+    /** Priority of the sources merged into [universe], or -1 if none is live. */
+    fun priorityOf(universe: Int): Int = find(universe)?.priority ?: NO_PRIORITY
+
+    /** Number of live sources sending [universe]. */
+    fun sourceCount(universe: Int): Int =
+        find(universe)?.sources?.count { it.active } ?: 0
+
+    // ------------------------------------------------------------------ //
+    //  Merging (receive loop)                                             //
+    // ------------------------------------------------------------------ //
+
+    private fun merge(
+        number: Int,
+        idHi: Long,
+        idLo: Long,
+        priority: Int,
+        sequence: Int,
+        timeoutMs: Long,
+        packet: ByteArray,
+        offset: Int,
+        slots: Int,
+        nowMs: Long
+    ): Boolean {
+        val universe = findOrAdd(number) ?: return reject()
+        val source = sourceFor(universe, idHi, idLo) ?: return reject()
+
+        if (source.active && sequence != NO_SEQUENCE && source.sequence != NO_SEQUENCE) {
+            // E1.31 6.7.2: a packet up to 19 behind the last is out of order
+            val diff = (sequence - source.sequence).toByte().toInt()
+            if (diff in -19..0) return reject()
+        }
+
+        val wasActive = source.active
+        val previousTop = universe.priority
+        val ltpChanges = mode == MergeMode.LTP && wasActive && priority == previousTop &&
+            source.priority == priority
+
+        universe.version.incrementAndGet()
+        if (ltpChanges) {
+            // Channels this source changed take over; the rest keep their latest writer.
+            val merged = universe.merged
+            for (i in 0 until slots) {
+                val value = packet[offset + i]
+                if (value != source.channels[i]) merged[i] = value
+            }
+        }
+        packet.copyInto(source.channels, 0, offset, offset + slots)
+        if (slots < source.length) source.channels.fill(0, slots, source.length)
+        source.length = slots
+        source.priority = priority
+        source.sequence = sequence
+        source.lastSeenMs = nowMs
+        source.timeoutMs = timeoutMs
+        source.active = true
+
+        if (ltpChanges) {
+            if (slots > universe.length) universe.length = slots
+        } else if (mode == MergeMode.LTP && priority >= previousTop) {
+            // New source or priority change: this source's whole frame is the latest.
+            updateTop(universe)
+            if (universe.priority == priority) {
+                source.channels.copyInto(universe.merged, 0, 0, slots)
+                if (slots > universe.length) universe.length = slots
+            }
+        } else {
+            mergeLocked(universe, latest = null)
+        }
+        universe.version.incrementAndGet()
+        packetsAccepted++
+        return true
+    }
+
+    private fun terminate(number: Int, idHi: Long, idLo: Long) {
+        val universe = find(number) ?: return
+        for (source in universe.sources) {
+            if (source.active && source.idHi == idHi && source.idLo == idLo) {
+                source.active = false
+                remerge(universe)
+                return
+            }
+        }
+    }
+
+    /** Rebuild [universe] from its live sources after one dropped out. */
+    private fun remerge(universe: Universe) {
+        universe.version.incrementAndGet()
+        mergeLocked(universe, latest = mostRecentTopSource(universe))
+        universe.version.incrementAndGet()
+    }
+
+    /**
+     * Recompute [universe] from scratch; call between version increments.
+     * HTP takes the maximum over top-priority sources. LTP only rebuilds
+     * when [latest] is given (a source dropped or the top priority
+     * changed), from that source's frame.
+     */
+    private fun mergeLocked(universe: Universe, latest: Source?) {
+        val oldTop = universe.priority
+        updateTop(universe)
+        val top = universe.priority
+        val merged = universe.merged
+        if (top == NO_PRIORITY) {
+            merged.fill(0, 0, universe.length)
+            universe.length = 0
+            return
+        }
+        if (mode == MergeMode.LTP) {
+            val from = latest ?: if (top != oldTop) mostRecentTopSource(universe) else null
+            if (from != null) {
+                from.channels.copyInto(merged)
+                universe.length = universe.sources.maxOf { if (it.active && it.priority == top) it.length else 0 }
+            }
+            return
+        }
+        var length = 0
+        merged.fill(0)
+        for (source in universe.sources) {
+            if (!source.active || source.priority != top) continue
+            val channels = source.channels
+            for (i in 0 until source.length) {
+                val value = channels[i].toInt() and 0xFF
+                if (value > (merged[i].toInt() and 0xFF)) merged[i] = channels[i]
+            }
+            if (source.length > length) length = source.length
+        }
+        universe.length = length
+    }
+
+    private fun updateTop(universe: Universe) {
+        var top = NO_PRIORITY
+        for (source in universe.sources) {
+            if (source.active && source.priority > top) top = source.priority
+        }
+        universe.priority = top
+    }
+
+    private fun mostRecentTopSource(universe: Universe): Source? {
+        var best: Source? = null
+        var bestPriority = NO_PRIORITY
+        for (source in universe.sources) {
+            if (!source.active) continue
+            if (source.priority > bestPriority ||
+                (source.priority == bestPriority && source.lastSeenMs > best!!.lastSeenMs)
+            ) {
+                best = source
+                bestPriority = source.priority
+            }
+        }
+        return best
+    }
+
+    private fun find(number: Int): Universe? {
+        for (u in 0 until universeCount) {
+            val universe = universes[u]
+            if (universe != null && universe.number == number) return universe
+        }
+        return null
+    }
+
+    private fun findOrAdd(number: Int): Universe? {
+        find(number)?.let { return it }
+        if (universeCount == maxUniverses) return null
+        val universe = Universe(number, maxSourcesPerUniverse)
+        universes[universeCount] = universe
+        universeCount++
+        return universe
+    }
+
+    private fun sourceFor(universe: Universe, idHi: Long, idLo: Long): Source? {
+        var free: Source? = null
+        for (source in universe.sources) {
+            if (source.active) {
+                if (source.idHi == idHi && source.idLo == idLo) return source
+            } else if (free == null) {
+                free = source
+            }
+        }
+        return free?.also {
+            it.idHi = idHi
+            it.idLo = idLo
+            it.sequence = NO_SEQUENCE
+        }
+    }
+
+    private fun reject(): Boolean {
+        packetsRejected++
+        return false
+    }
+
+    companion object {
+        /** Universes tracked by default. */
+        const val DEFAULT_MAX_UNIVERSES = 64
+
+        /** Sources merged per universe by default (Art-Net nodes merge two). */
+        const val DEFAULT_MAX_SOURCES = 4
+
+        /** Art-Net drops a merge source after 10 s without data. */
+        const val ART_NET_SOURCE_TIMEOUT_MS = 10_000L
+
+        /** E1.31 network data loss timeout. */
+        const val SACN_SOURCE_TIMEOUT_MS = 2_500L
+
+        /** Tag in the high id word marking an Art-Net source keyed by IPv4. */
+        private const val ART_NET_SOURCE = Long.MIN_VALUE
+
+        private const val NO_SEQUENCE = -1
+        private const val NO_PRIORITY = -1
+        private const val READ_ATTEMPTS = 4
+
+        // E1.31 data packet field offsets
+        private const val SACN_ROOT_VECTOR = 18
+        private const val SACN_CID = 22
+        private const val SACN_FRAMING_VECTOR = 40
+        private const val SACN_PRIORITY = 108
+        private const val SACN_SEQUENCE = 111
+        private const val SACN_OPTIONS = 112
+        private const val SACN_UNIVERSE = 113
+        private const val SACN_DMP_VECTOR = 117
+        private const val SACN_PROPERTY_COUNT = 123
+        private const val SACN_START_CODE = 125
+        private const val SACN_DATA_OFFSET = 126
+
+        private fun readUInt16BE(data: ByteArray, offset: Int): Int =
+            ((data[offset].toInt() and 0xFF) shl 8) or (data[offset + 1].toInt() and 0xFF)
+
+        private fun readUInt32BE(data: ByteArray, offset: Int): Int =
+            (readUInt16BE(data, offset) shl 16) or readUInt16BE(data, offset + 2)
+
+        private fun readLongBE(data: ByteArray, offset: Int): Long {
+            var value = 0L
+            for (i in 0 until 8) value = (value shl 8) or (data[offset + i].toLong() and 0xFF)
+            return value
+        }
+    }
+}
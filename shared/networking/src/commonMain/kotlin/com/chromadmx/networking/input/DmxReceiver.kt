@@ -0,0 +1,118 @@
+package com.chromadmx.networking.input
+
+import com.chromadmx.networking.protocol.ArtNetConstants
+import com.chromadmx.networking.protocol.SacnConstants
+import com.chromadmx.networking.transport.PlatformUdpReceiver
+import com.chromadmx.networking.transport.UdpDatagram
+import kotlinx.atomicfu.locks.SynchronizedObject
+import kotlinx.atomicfu.locks.synchronized
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.IO
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import kotlin.time.TimeSource
+
+/**
+ * Receives Art-Net and sACN from other controllers into a [DmxMergeEngine].
+ *
+ * Each protocol gets a loop blocked in [PlatformUdpReceiver.receive] on
+ * a [Dispatchers.IO] thread, reusing one [UdpDatagram], so nothing is
+ * allocated per packet and the blocking waits never pin the
+ * [Dispatchers.Default] threads the engine renders on. The two loops take
+ * turns feeding [merge] and expire silent sources every
+ * [EXPIRE_INTERVAL_MS]. A loop ends once its socket is closed.
+ *
+ * Usage:
+ * ```
+ * val merge = DmxMergeEngine(ownCid = sacnCid)
+ * val receiver = DmxReceiver(merge, scope, sacnUniverses = listOf(1, 2))
+ * receiver.start()
+ * // DMX output: MergingDmxTransport(outputService, merge)
+ * ```
+ *
+ * @param merge          Destination of the received data
+ * @param scope          Scope the receive loops run in
+ * @param sacnUniverses  sACN universes whose multicast groups are joined;
+ *                       empty skips sACN
+ * @param listenArtNet   Whether to receive ArtDmx on port 6454
+ */
+class DmxReceiver(
+    private val merge: DmxMergeEngine,
+    private val scope: CoroutineScope,
+    private val sacnUniverses: List<Int> = emptyList(),
+    private val listenArtNet: Boolean = true
+) {
+    /** Serialises the two loops; [merge] takes one writer at a time. */
+    private val lock = SynchronizedObject()
+
+    private val clock = TimeSource.Monotonic.markNow()
+    private var lastExpireMs = 0L
+
+    private val receivers = mutableListOf<PlatformUdpReceiver>()
+    private val jobs = mutableListOf<Job>()
+
+    /** Whether the receive loops are running. */
+    val isRunning: Boolean get() = jobs.any { it.isActive }
+
+    fun start() {
+        if (isRunning) return
+        if (listenArtNet) {
+            val artNet = PlatformUdpReceiver(ArtNetConstants.PORT)
+            receivers += artNet
+            jobs += receiveLoop(artNet) { datagram, nowMs ->
+                merge.acceptArtDmx(datagram.buffer, datagram.length, datagram.sourceAddress, nowMs)
+            }
+        }
+        if (sacnUniverses.isNotEmpty()) {
+            val sacn = PlatformUdpReceiver(SacnConstants.PORT)
+            for (universe in sacnUniverses) {
+                sacn.joinMulticastGroup(SacnConstants.multicastAddress(universe))
+            }
+            receivers += sacn
+            jobs += receiveLoop(sacn) { datagram, nowMs ->
+                merge.acceptSacn(datagram.buffer, datagram.length, nowMs)
+            }
+        }
+    }
+
+    fun stop() {
+        jobs.forEach { it.cancel() }
+        jobs.clear()
+        // Closing unblocks a pending receive
+        receivers.forEach { it.close() }
+        receivers.clear()
+    }
+
+    private fun receiveLoop(
+        receiver: PlatformUdpReceiver,
+        accept: (UdpDatagram, Long) -> Unit
+    ): Job = scope.launch(Dispatchers.IO) {
+        val datagram = UdpDatagram()
+        try {
+            // A closed socket fails every receive at once; stop instead of spinning
+            while (isActive && !receiver.isClosed) {
+                val received = receiver.receive(datagram, RECEIVE_TIMEOUT_MS)
+                val nowMs = clock.elapsedNow().inWholeMilliseconds
+                synchronized(lock) {
+                    if (received) accept(datagram, nowMs)
+                    if (nowMs - lastExpireMs >= EXPIRE_INTERVAL_MS) {
+                        merge.expire(nowMs)
+                        lastExpireMs = nowMs
+                    }
+                }
+            }
+        } finally {
+            receiver.close()
+        }
+    }
+
+    companion object {
+        /** Longest a loop blocks before checking for cancellation and expiry. */
+        const val RECEIVE_TIMEOUT_MS: Int = 250
+
+        /** How often silent sources are looked for. */
+        const val EXPIRE_INTERVAL_MS: Long = 250L
+    }
+}
@@ -0,0 +1,121 @@
+package com.chromadmx.networking.input
+
+import com.chromadmx.networking.ConnectionState
+import com.chromadmx.networking.DmxTransport
+import com.chromadmx.networking.protocol.SacnConstants
+import kotlinx.coroutines.flow.StateFlow
+
+/**
+ * [DmxTransport] decorator that merges what other controllers send
+ * ([merge]) into our frames before handing them to [delegate].
+ *
+ * Per universe we output, our frame competes as a source at
+ * [localPriority]: received data at a higher priority replaces ours, at a
+ * lower one is ignored, and at the same priority is combined by the merge
+ * engine's [DmxMergeEngine.mode] (HTP maximum, or LTP taking whichever
+ * side changed a channel last). Universes only other controllers send are
+ * not re-transmitted, so two merging rigs do not echo each other.
+ *
+ * The merged frame is one preallocated map, rewritten on every call; the
+ * delegate copies it, per the [DmxTransport.updateFrame] contract. Call
+ * [updateFrame] from one thread.
+ */
+class MergingDmxTransport(
+    private val delegate: DmxTransport,
+    private val merge: DmxMergeEngine,
+    private val localPriority: Int = SacnConstants.DEFAULT_PRIORITY
+) : DmxTransport {
+
+    private class UniverseState(val universe: Int, size: Int) {
+        val remote = ByteArray(maxOf(size, SacnConstants.MAX_DMX_SLOTS))
+        val lastRemote = ByteArray(remote.size)
+        val lastLocal = ByteArray(size)
+        val held = ByteArray(size)
+    }
+
+    /** Per-universe merge state, in the iteration order of the current layout. */
+    private var states: Array<UniverseState> = emptyArray()
+    private var merged = LinkedHashMap<Int, ByteArray>()
+
+    override val connectionState: StateFlow<ConnectionState> get() = delegate.connectionState
+    override val isRunning: Boolean get() = delegate.isRunning
+
+    override fun start() = delegate.start()
+
+    override fun stop() = delegate.stop()
+
+    override fun sendFrame(universe: Int, channels: ByteArray) = delegate.sendFrame(universe, channels)
+
+    override fun updateFrame(universeData: Map<Int, ByteArray>) {
+        if (!layoutMatches(universeData)) rebuild(universeData)
+
+        val targets = merged.values.iterator()
+        var index = 0
+        for (local in universeData.values) {
+            mergeUniverse(states[index++], local, targets.next())
+        }
+        delegate.updateFrame(merged)
+    }
+
+    private fun mergeUniverse(state: UniverseState, local: ByteArray, target: ByteArray) {
+        val remote = state.remote
+        val remoteLength = merge.readUniverse(state.universe, remote)
+        val remotePriority = if (remoteLength == 0) -1 else merge.priorityOf(state.universe)
+        val size = target.size
+
+        when {
+            remotePriority < localPriority -> local.copyInto(target)
+            remotePriority > localPriority -> {
+                val n = minOf(remoteLength, size)
+                remote.copyInto(target, 0, 0, n)
+                target.fill(0, n, size)
+            }
+            merge.mode == MergeMode.HTP -> {
+                for (i in 0 until size) {
+                    val mine = local[i].toInt() and 0xFF
+                    val theirs = if (i < remoteLength) remote[i].toInt() and 0xFF else 0
+                    target[i] = (if (theirs > mine) theirs else mine).toByte()
+                }
+            }
+            else -> {
+                // LTP: a channel follows whichever side changed it most recently.
+                val held = state.held
+                val lastRemote = state.lastRemote
+                val lastLocal = state.lastLocal
+                for (i in 0 until size) {
+                    val theirs: Byte = if (i < remoteLength) remote[i] else 0
+                    if (theirs != lastRemote[i]) {
+                        held[i] = theirs
+                    } else if (local[i] != lastLocal[i]) {
+                        held[i] = local[i]
+                    }
+                }
+                held.copyInto(target)
+            }
+        }
+        // Remember both sides so LTP can tell which one moved next time.
+        local.copyInto(state.lastLocal)
+        target.copyInto(state.held)
+        remote.copyInto(state.lastRemote, 0, 0, remoteLength)
+        state.lastRemote.fill(0, remoteLength, state.lastRemote.size)
+    }
+
+    private fun layoutMatches(frame: Map<Int, ByteArray>): Boolean {
+        if (states.size != frame.size) return false
+        var index = 0
+        for ((universe, channels) in frame) {
+            val state = states[index++]
+            if (state.universe != universe || state.held.size != channels.size) return false
+        }
+        return true
+    }
+
+    private fun rebuild(frame: Map<Int, ByteArray>) {
+        states = frame.map { (universe, channels) ->
+            UniverseState(universe, channels.size).also { channels.copyInto(it.held) }
+        }.toTypedArray()
+        merged = LinkedHashMap<Int, ByteArray>(frame.size * 2).apply {
+            for ((universe, channels) in frame) put(universe, ByteArray(channels.size))
+        }
+    }
+}
@@ -1,5 +1,7 @@
 package com.chromadmx.networking.output
 
+import com.chromadmx.core.telemetry.PerformanceTelemetry
+import com.chromadmx.core.util.FramePacer
 import com.chromadmx.networking.ConnectionState
 import com.chromadmx.networking.DmxTransport
 import com.chromadmx.networking.protocol.ArtNetCodec
@@ -7,20 +9,22 @@ import com.chromadmx.networking.protocol.ArtNetConstants
 import com.chromadmx.networking.protocol.SacnCodec
 import com.chromadmx.networking.protocol.SacnConstants
 import com.chromadmx.networking.transport.PlatformUdpTransport
-import kotlinx.atomicfu.atomic
-import kotlinx.atomicfu.AtomicRef
+import com.chromadmx.networking.transport.UdpBatch
+import kotlinx.atomicfu.locks.SynchronizedObject
+import kotlinx.atomicfu.locks.synchronized
 import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.cancel
-import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
+import kotlin.concurrent.Volatile
+import kotlin.time.TimeSource
 
 /**
  * DMX output protocol.
@@ -33,9 +37,14 @@ enum class DmxProtocol {
 /**
  * High-frequency DMX output service.
  *
- * Runs a 40Hz (25ms) broadcast loop that reads the latest frame data
- * from an atomic reference and sends one ArtDmx or sACN packet per
- * universe per frame via [PlatformUdpTransport].
+ * Runs a 40Hz (25ms) broadcast loop that sends the latest frame data as
+ * one ArtDmx or sACN packet per universe per frame. A frame's packets are
+ * queued into one [UdpBatch] and handed to [PlatformUdpTransport.sendBatch]
+ * together.
+ *
+ * [updateFrame] and [updateUniverse] copy the caller's channel data into
+ * service-owned buffers, so a producer may rewrite its arrays as soon as
+ * the call returns and a frame is never read while it is being written.
  *
  * Usage:
  * ```
@@ -49,6 +58,13 @@ enum class DmxProtocol {
  * The service supports multi-universe output: the frame map keys are
  * universe numbers and values are 512-byte channel data arrays.
  *
+ * With [suppressUnchanged], a universe whose channels match what was last
+ * sent is skipped once it has gone out [UNCHANGED_REPEATS] extra times
+ * (E1.31 asks for three identical packets before a rate drop, and the
+ * repeats cover a lost datagram), then refreshed every
+ * [KEEPALIVE_INTERVAL_MS] so receivers do not time out. A static scene
+ * costs about one packet per universe per 800ms instead of 40 per second.
+ *
  * @param transport       UDP transport for sending packets
  * @param targetAddress   Destination IP for Art-Net (default broadcast)
  * @param protocol        Which DMX-over-IP protocol to use
@@ -56,6 +72,9 @@ enum class DmxProtocol {
  * @param sourceName      sACN source name (used only for sACN protocol)
  * @param sacnCid         sACN Component ID, 16-byte UUID (used only for sACN)
  * @param sacnPriority    sACN priority 0-200 (used only for sACN, default 100)
+ * @param telemetry       Receives each frame's encode-to-sent time and
+ *                        sent/skipped universe counts, if set
+ * @param suppressUnchanged Skip unchanged universes between keepalives
  */
 class DmxOutputService(
     private val transport: PlatformUdpTransport,
@@ -64,13 +83,25 @@ class DmxOutputService(
     private val frameRateHz: Int = DEFAULT_FRAME_RATE_HZ,
     private val sourceName: String = "ChromaDMX",
     private val sacnCid: ByteArray = ByteArray(SacnConstants.CID_SIZE),
-    private val sacnPriority: Int = SacnConstants.DEFAULT_PRIORITY
+    private val sacnPriority: Int = SacnConstants.DEFAULT_PRIORITY,
+    private val telemetry: PerformanceTelemetry? = null,
+    private val suppressUnchanged: Boolean = true
 ) : DmxTransport {
+    /** Guards [pendingFrame] and [pendingDirty]. */
+    private val frameLock = SynchronizedObject()
+
     /**
-     * Atomic reference to the latest frame data.
-     * Map<universeNumber, 512-byte channel data>.
+     * Latest frame handed in by the producers, copied out of their arrays.
+     * Map<universeNumber, channel data>; arrays are reused while the
+     * universe's size stays the same.
      */
-    private val frameRef: AtomicRef<Map<Int, ByteArray>> = atomic(emptyMap())
+    private val pendingFrame = LinkedHashMap<Int, ByteArray>()
+
+    /** Whether [pendingFrame] changed since the output loop last took it. */
+    private var pendingDirty = false
+
+    /** The frame being sent, refreshed from [pendingFrame]. Only touched from the output loop. */
+    private val sendingFrame = LinkedHashMap<Int, ByteArray>()
 
     private val _connectionState = MutableStateFlow(ConnectionState.Disconnected)
     override val connectionState: StateFlow<ConnectionState> = _connectionState.asStateFlow()
@@ -81,6 +112,32 @@ class DmxOutputService(
     /** Rolling sACN sequence counter (0..255). */
     private var sacnSequence: Int = 0
 
+    /**
+     * Reusable per-universe packet buffers. The transport has handed the
+     * bytes to the socket by the time `sendBatch` returns, so each universe's
+     * packet is re-encoded in place every frame instead of reallocated.
+     * Only touched from the output loop.
+     */
+    private val packetBuffers = HashMap<Int, ByteArray>()
+
+    /** sACN multicast group per universe, resolved once. */
+    private val sacnAddresses = HashMap<Int, String>()
+
+    private val sourceNameBytes: ByteArray = sourceName.encodeToByteArray()
+
+    /**
+     * Last sent channels per universe, for [suppressUnchanged]. Only
+     * touched from the output loop.
+     */
+    private val sendStates = HashMap<Int, UniverseSendState>()
+
+    /** Unchanged frames between keepalive refreshes of a universe. */
+    private val keepaliveFrames: Int =
+        (frameRateHz * KEEPALIVE_INTERVAL_MS / 1000L).toInt().coerceAtLeast(1)
+
+    /** Datagrams for the frame being sent; refilled by each [sendAllUniverses]. */
+    private val batch = UdpBatch()
+
     private var scope: CoroutineScope? = null
     private var outputJob: Job? = null
 
@@ -95,27 +152,52 @@ class DmxOutputService(
         private set
 
     /**
-     * Update the frame data for one or more universes.
+     * Wall time the last frame's batch spent in the transport, in
+     * microseconds. A value approaching [frameIntervalMs] means the socket,
+     * not the render loop, is limiting the output rate.
+     */
+    @Volatile
+    var lastFrameSendMicros: Long = 0L
+        private set
+
+    /** Datagrams in the last frame that the transport failed to send. */
+    @Volatile
+    var lastFrameDroppedPackets: Int = 0
+        private set
+
+    /** Universes in the last frame skipped because they had not changed. */
+    @Volatile
+    var lastFrameSkippedUniverses: Int = 0
+        private set
+
+    /**
+     * Replace the frame data with [universeData].
      *
-     * This is lock-free: the new map is atomically published and
-     * picked up by the output loop on the next frame.
+     * The channel data is copied before this returns, so the caller keeps
+     * ownership of the map and its arrays. Picked up by the output loop on
+     * the next frame.
      *
      * @param universeData Map of universe number to 512-byte channel data
      */
     override fun updateFrame(universeData: Map<Int, ByteArray>) {
-        frameRef.value = universeData
+        synchronized(frameLock) {
+            copyFrame(universeData, pendingFrame)
+            pendingDirty = true
+        }
     }
 
     /**
-     * Update a single universe's channel data.
+     * Update a single universe's channel data, keeping the others.
+     * [data] is copied, as in [updateFrame].
      *
      * @param universe Universe number
      * @param data     512-byte channel data
      */
     fun updateUniverse(universe: Int, data: ByteArray) {
-        val current = frameRef.value.toMutableMap()
-        current[universe] = data
-        frameRef.value = current
+        synchronized(frameLock) {
+            copyUniverse(pendingFrame, universe, data)
+            pendingDirty = true
+        }
     }
 
     /**
@@ -135,6 +217,7 @@ class DmxOutputService(
         frameCount = 0L
         artNetSequence = 1
         sacnSequence = 0
+        sendStates.clear()
         _connectionState.value = ConnectionState.Connecting
 
         val newScope = CoroutineScope(Dispatchers.Default + SupervisorJob())
@@ -161,11 +244,11 @@ class DmxOutputService(
     // ------------------------------------------------------------------ //
 
     private suspend fun outputLoop() {
-        val interval = frameIntervalMs
+        // Exact nanosecond interval: 1000 / 44 truncated to 22ms would
+        // actually run at 45Hz, above the Art-Net limit.
+        val pacer = FramePacer.forRate(frameRateHz)
 
         while (scope?.isActive == true) {
-            val startTime = monotonicTimeMs()
-
             try {
                 if (sendAllUniverses()) {
                     frameCount++
@@ -176,12 +259,8 @@ class DmxOutputService(
                 // Non-fatal: skip this frame
             }
 
-            // Maintain consistent frame rate
-            val elapsed = monotonicTimeMs() - startTime
-            val remaining = interval - elapsed
-            if (remaining > 0) {
-                delay(remaining)
-            }
+            // Absolute deadlines: late wakeups are absorbed, not accumulated
+            pacer.awaitNextFrame()
         }
     }
 
@@ -192,42 +271,117 @@ class DmxOutputService(
      * @return `true` if data was actually sent, `false` if skipped (no frame data).
      */
     internal suspend fun sendAllUniverses(): Boolean {
-        val frame = frameRef.value
+        synchronized(frameLock) {
+            if (pendingDirty) {
+                copyFrame(pendingFrame, sendingFrame)
+                pendingDirty = false
+            }
+        }
+        val frame = sendingFrame
         if (frame.isEmpty()) return false
 
+        val packStart = TimeSource.Monotonic.markNow()
+        batch.clear()
+        var skipped = 0
         for ((universe, data) in frame) {
+            if (!needsSend(universe, data)) {
+                skipped++
+                continue
+            }
             when (protocol) {
-                DmxProtocol.ART_NET -> sendArtDmx(universe, data)
-                DmxProtocol.SACN -> sendSacn(universe, data)
+                DmxProtocol.ART_NET -> queueArtDmx(universe, data)
+                DmxProtocol.SACN -> queueSacn(universe, data)
             }
         }
+        lastFrameSkippedUniverses = skipped
+        telemetry?.recordDmxUniverses(sent = batch.size, skipped = skipped)
+        if (batch.size == 0) {
+            lastFrameDroppedPackets = 0
+            return true
+        }
+
+        val sendStart = TimeSource.Monotonic.markNow()
+        val sent = transport.sendBatch(batch)
+        lastFrameSendMicros = sendStart.elapsedNow().inWholeMicroseconds
+        lastFrameDroppedPackets = batch.size - sent
+        telemetry?.dmxPackToSend?.record(packStart.elapsedNow().inWholeMicroseconds)
         return true
     }
 
-    private suspend fun sendArtDmx(universe: Int, data: ByteArray) {
-        val packet = ArtNetCodec.encodeArtDmx(
+    /**
+     * Whether [universe] goes out this frame: always when it changed,
+     * for [UNCHANGED_REPEATS] frames after that, then once per keepalive.
+     */
+    private fun needsSend(universe: Int, data: ByteArray): Boolean {
+        if (!suppressUnchanged) return true
+        val state = sendStates[universe]
+        if (state == null || state.lastSent.size != data.size) {
+            sendStates[universe] = UniverseSendState(data.copyOf())
+            return true
+        }
+        if (!data.contentEquals(state.lastSent)) {
+            data.copyInto(state.lastSent)
+            state.repeats = 0
+            state.framesSinceSent = 0
+            return true
+        }
+        if (state.repeats < UNCHANGED_REPEATS) {
+            state.repeats++
+            return true
+        }
+        if (++state.framesSinceSent >= keepaliveFrames) {
+            state.framesSinceSent = 0
+            return true
+        }
+        return false
+    }
+
+    private class UniverseSendState(val lastSent: ByteArray) {
+        /** Identical packets sent since the last change. */
+        var repeats = 0
+
+        /** Frames skipped since the last packet. */
+        var framesSinceSent = 0
+    }
+
+    /** Buffer of exactly [size] bytes for [universe], reused across frames. */
+    private fun packetBuffer(universe: Int, size: Int): ByteArray {
+        val existing = packetBuffers[universe]
+        if (existing != null && existing.size == size) return existing
+        return ByteArray(size).also { packetBuffers[universe] = it }
+    }
+
+    private fun queueArtDmx(universe: Int, data: ByteArray) {
+        val packet = packetBuffer(universe, ArtNetCodec.artDmxSize(data.size))
+        val length = ArtNetCodec.encodeArtDmxInto(
+            packet = packet,
             sequence = artNetSequence.toByte(),
             physical = 0,
             universe = universe,
             data = data
         )
-        transport.send(packet, targetAddress, ArtNetConstants.PORT)
+        batch.add(packet, length, targetAddress, ArtNetConstants.PORT)
         artNetSequence = if (artNetSequence >= 255) 1 else artNetSequence + 1
     }
 
-    private suspend fun sendSacn(universe: Int, data: ByteArray) {
-        val multicastAddr = SacnConstants.multicastAddress(
-            if (universe == 0) 1 else universe  // sACN universes start at 1
-        )
-        val packet = SacnCodec.encode(
+    private fun queueSacn(universe: Int, data: ByteArray) {
+        val sacnUniverse = if (universe == 0) 1 else universe  // sACN universes start at 1
+        val multicastAddr = sacnAddresses.getOrPut(sacnUniverse) {
+            SacnConstants.multicastAddress(sacnUniverse)
+        }
+        val packet = packetBuffer(universe, SacnCodec.packetSize(data.size))
+        val length = SacnCodec.encodeInto(
+            packet = packet,
             cid = sacnCid,
-            sourceName = sourceName,
+            sourceName = sourceNameBytes,
             priority = sacnPriority,
             sequence = sacnSequence,
-            universe = if (universe == 0) 1 else universe,
+            options = 0,
+            universe = sacnUniverse,
+            startCode = 0x00,
             dmxData = data
         )
-        transport.send(packet, multicastAddr, SacnConstants.PORT)
+        batch.add(packet, length, multicastAddr, SacnConstants.PORT)
         sacnSequence = (sacnSequence + 1) and 0xFF
     }
 
@@ -240,10 +394,29 @@ class DmxOutputService(
 
         /** Maximum frame rate (Art-Net spec limit is ~44Hz). */
         const val MAX_FRAME_RATE_HZ: Int = 44
+
+        /**
+         * Longest gap between packets for an unchanged universe. Art-Net
+         * asks for a refresh every 800-1000ms, sACN at least once a second.
+         */
+        const val KEEPALIVE_INTERVAL_MS: Long = 800L
+
+        /** Extra identical packets sent after a change before suppressing. */
+        const val UNCHANGED_REPEATS: Int = 2
+
+        /** Make [target] hold a copy of [source], reusing its arrays where the sizes match. */
+        private fun copyFrame(source: Map<Int, ByteArray>, target: MutableMap<Int, ByteArray>) {
+            target.keys.retainAll(source.keys)
+            for ((universe, data) in source) copyUniverse(target, universe, data)
+        }
+
+        private fun copyUniverse(target: MutableMap<Int, ByteArray>, universe: Int, data: ByteArray) {
+            val existing = target[universe]
+            if (existing != null && existing.size == data.size) {
+                data.copyInto(existing)
+            } else {
+                target[universe] = data.copyOf()
+            }
+        }
     }
 }
-
-/**
- * Platform-agnostic monotonic clock in milliseconds for frame timing.
- */
-internal expect fun monotonicTimeMs(): Long
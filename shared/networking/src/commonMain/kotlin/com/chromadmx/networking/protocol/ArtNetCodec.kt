@@ -59,14 +59,42 @@ object ArtNetCodec {
         universe: Int,
         data: ByteArray
     ): ByteArray {
-        require(data.size in 2..DMX_DATA_MAX_LENGTH) {
-            "DMX data length must be 2..512, got ${data.size}"
+        val packet = ByteArray(artDmxSize(data.size))
+        encodeArtDmxInto(packet, sequence, physical, universe, data)
+        return packet
+    }
+
+    /**
+     * Size of an ArtDmx packet carrying [dataLength] channels (padded to even).
+     */
+    fun artDmxSize(dataLength: Int): Int {
+        require(dataLength in 2..DMX_DATA_MAX_LENGTH) {
+            "DMX data length must be 2..512, got $dataLength"
         }
+        return ART_DMX_HEADER_SIZE + dataLength + (dataLength and 1)
+    }
+
+    /**
+     * Encode an ArtDmx packet into a caller-owned [packet] buffer, so an
+     * output loop can reuse one buffer per universe instead of allocating a
+     * packet (and a padded data copy) every frame.
+     *
+     * @param packet Destination, at least [artDmxSize] of `data.size` bytes
+     * @return number of bytes written
+     * @see encodeArtDmx for the field descriptions
+     */
+    fun encodeArtDmxInto(
+        packet: ByteArray,
+        sequence: Byte,
+        physical: Byte,
+        universe: Int,
+        data: ByteArray
+    ): Int {
+        val size = artDmxSize(data.size)
+        require(packet.size >= size) { "Packet buffer too small: ${packet.size} < $size" }
         // Art-Net spec requires even data length
-        val paddedLength = if (data.size % 2 != 0) data.size + 1 else data.size
-        val padded = if (paddedLength != data.size) data.copyOf(paddedLength) else data
+        val paddedLength = size - ART_DMX_HEADER_SIZE
 
-        val packet = ByteArray(ART_DMX_HEADER_SIZE + paddedLength)
         var offset = 0
 
         // Header "Art-Net\0"
@@ -97,10 +125,11 @@ object ArtNetCodec {
         packet[offset++] = ((paddedLength shr 8) and 0xFF).toByte()
         packet[offset++] = (paddedLength and 0xFF).toByte()
 
-        // DMX data
-        padded.copyInto(packet, offset)
+        // DMX data, zero-padded to even length
+        data.copyInto(packet, offset)
+        if (paddedLength != data.size) packet[offset + data.size] = 0
 
-        return packet
+        return size
     }
 
     /**
@@ -97,6 +97,41 @@ object SacnCodec {
         startCode: Byte = 0x00,
         dmxData: ByteArray = ByteArray(MAX_DMX_SLOTS)
     ): ByteArray {
+        val packet = ByteArray(packetSize(dmxData.size))
+        encodeInto(
+            packet, cid, sourceName.encodeToByteArray(), priority,
+            sequence, options, universe, startCode, dmxData
+        )
+        return packet
+    }
+
+    /**
+     * Size of an E1.31 data packet carrying [slotCount] DMX slots.
+     */
+    fun packetSize(slotCount: Int): Int =
+        ROOT_PREAMBLE_SIZE + 2 + 4 + CID_SIZE + FRAMING_PDU_SIZE + DMP_HEADER_SIZE + 1 + slotCount
+
+    /**
+     * Encode a sACN E1.31 data packet into a caller-owned [packet] buffer.
+     *
+     * Lets an output loop reuse one buffer per universe. [sourceName] is
+     * taken pre-encoded (UTF-8) so the name is not re-encoded every frame.
+     *
+     * @param packet Destination, at least [packetSize] of `dmxData.size` bytes
+     * @return number of bytes written
+     * @see encode for the field descriptions
+     */
+    fun encodeInto(
+        packet: ByteArray,
+        cid: ByteArray,
+        sourceName: ByteArray,
+        priority: Int,
+        sequence: Int,
+        options: Int,
+        universe: Int,
+        startCode: Byte,
+        dmxData: ByteArray
+    ): Int {
         require(cid.size == CID_SIZE) { "CID must be $CID_SIZE bytes, got ${cid.size}" }
         require(dmxData.size in 1..MAX_DMX_SLOTS) { "DMX data must be 1..$MAX_DMX_SLOTS bytes, got ${dmxData.size}" }
         require(universe in 1..63999) { "Universe must be 1..63999, got $universe" }
@@ -114,8 +149,10 @@ object SacnCodec {
         // Per spec: Root layer PDU length = number of octets from (and including) the Flags & Length
         // to the end of the PDU. So it includes itself (2) + vector(4) + CID(16) + all downstream.
         val totalPacketSize = ROOT_PREAMBLE_SIZE + 2 + 4 + CID_SIZE + framingLayerLength
+        require(packet.size >= totalPacketSize) {
+            "Packet buffer too small: ${packet.size} < $totalPacketSize"
+        }
 
-        val packet = ByteArray(totalPacketSize)
         var offset = 0
 
         // ---- ACN Root Layer Preamble ---- //
@@ -168,9 +205,9 @@ object SacnCodec {
         packet[offset++] = ((VECTOR_E131_DATA_PACKET shr 8) and 0xFF).toByte()
         packet[offset++] = (VECTOR_E131_DATA_PACKET and 0xFF).toByte()
 
-        // Source Name (64 bytes, null-terminated)
-        val nameBytes = sourceName.encodeToByteArray()
-        nameBytes.copyInto(packet, offset, 0, minOf(63, nameBytes.size))
+        // Source Name (64 bytes, null-terminated; clear leftovers in a reused buffer)
+        packet.fill(0, offset, offset + SOURCE_NAME_SIZE)
+        sourceName.copyInto(packet, offset, 0, minOf(63, sourceName.size))
         offset += SOURCE_NAME_SIZE
 
         // Priority (1 byte)
@@ -222,7 +259,7 @@ object SacnCodec {
         // DMX Slot Data
         dmxData.copyInto(packet, offset)
 
-        return packet
+        return totalPacketSize
     }
 
     // ------------------------------------------------------------------ //
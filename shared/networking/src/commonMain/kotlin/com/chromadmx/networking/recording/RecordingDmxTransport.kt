@@ -0,0 +1,35 @@
+package com.chromadmx.networking.recording
+
+import com.chromadmx.networking.ConnectionState
+import com.chromadmx.networking.DmxTransport
+import kotlinx.coroutines.flow.StateFlow
+
+/**
+ * [DmxTransport] decorator that records every frame passed to
+ * [updateFrame] into [recorder] before handing it to [delegate].
+ *
+ * [beatProvider] and [timeProvider] place each frame on the timeline,
+ * typically the Link session's current beat and host time, so playback
+ * can be re-aligned to a later session by bar.
+ */
+class RecordingDmxTransport(
+    private val delegate: DmxTransport,
+    private val recorder: ShowRecorder,
+    private val beatProvider: () -> Double,
+    private val timeProvider: () -> Long
+) : DmxTransport {
+
+    override val connectionState: StateFlow<ConnectionState> get() = delegate.connectionState
+    override val isRunning: Boolean get() = delegate.isRunning
+
+    override fun start() = delegate.start()
+
+    override fun stop() = delegate.stop()
+
+    override fun sendFrame(universe: Int, channels: ByteArray) = delegate.sendFrame(universe, channels)
+
+    override fun updateFrame(universeData: Map<Int, ByteArray>) {
+        recorder.record(universeData, timeProvider(), beatProvider())
+        delegate.updateFrame(universeData)
+    }
+}
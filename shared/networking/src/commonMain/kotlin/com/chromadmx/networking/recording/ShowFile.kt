@@ -0,0 +1,67 @@
+package com.chromadmx.networking.recording
+
+/**
+ * Append-only byte store with random-access reads, backing a show
+ * recording ([ShowRecorder]) and its playback ([ShowPlayer]).
+ *
+ * Reads go straight to the backing storage (a memory-mapped file on
+ * Android, `pread` on iOS), so playing back a recording of any length
+ * costs no heap beyond the caller's buffers.
+ *
+ * One writer and one reader at a time; a reader may follow a file that is
+ * still being appended to.
+ */
+interface ShowFile : AutoCloseable {
+
+    /** Bytes written so far. */
+    val length: Long
+
+    /** Append [length] bytes of [bytes] starting at [offset]. */
+    fun append(bytes: ByteArray, offset: Int = 0, length: Int = bytes.size)
+
+    /**
+     * Copy up to [length] bytes at [position] into [into] at [offset].
+     *
+     * @return bytes copied; fewer than [length] only at the end of the file
+     */
+    fun read(position: Long, into: ByteArray, offset: Int = 0, length: Int): Int
+
+    /** Push appended bytes to durable storage. */
+    fun flush() {}
+}
+
+/**
+ * Open the show file at [path]. When [writable] the file is created, or
+ * truncated if it exists, ready for a new [ShowRecorder]; otherwise it is
+ * opened read-only for a [ShowPlayer].
+ */
+expect fun openShowFile(path: String, writable: Boolean): ShowFile
+
+/** Heap-backed [ShowFile] for tests and short recordings. */
+class InMemoryShowFile(initialCapacity: Int = 4096) : ShowFile {
+
+    private var data = ByteArray(initialCapacity.coerceAtLeast(16))
+    private var size = 0
+
+    override val length: Long get() = size.toLong()
+
+    override fun append(bytes: ByteArray, offset: Int, length: Int) {
+        if (size + length > data.size) {
+            data = data.copyOf(maxOf(data.size * 2, size + length))
+        }
+        bytes.copyInto(data, size, offset, offset + length)
+        size += length
+    }
+
+    override fun read(position: Long, into: ByteArray, offset: Int, length: Int): Int {
+        if (position >= size) return 0
+        val count = minOf(length.toLong(), size - position).toInt()
+        data.copyInto(into, offset, position.toInt(), position.toInt() + count)
+        return count
+    }
+
+    /** Copy of the contents, e.g. to persist a recording made in memory. */
+    fun toByteArray(): ByteArray = data.copyOf(size)
+
+    override fun close() {}
+}
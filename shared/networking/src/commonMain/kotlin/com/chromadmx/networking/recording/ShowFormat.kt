@@ -0,0 +1,89 @@
+package com.chromadmx.networking.recording
+
+/**
+ * On-disk layout of a show recording. All integers are little-endian.
+ *
+ * ## Data file
+ *
+ * - Header ([DATA_HEADER_SIZE] bytes): magic `CDXS`, u8 [VERSION],
+ *   3 bytes padding, f64 quantum (beats per bar).
+ * - Records, back to back. Each starts with a [RECORD_HEADER_SIZE]-byte
+ *   header: u8 tag, i32 payload length, i64 host time (µs), f64 beat.
+ *   - [TAG_KEYFRAME]: u16 universe count, then per universe
+ *     u16 universe, u16 size, `size` bytes of channel data.
+ *   - [TAG_DELTA]: u16 universe count, then per changed universe
+ *     u16 universe, u16 span count, then per span u16 start, u16 length,
+ *     `length` bytes replacing channels `start until start + length`.
+ *
+ * The first frame of every bar is a keyframe, so decoding can start at
+ * any bar without reading what came before.
+ *
+ * ## Index file
+ *
+ * - Header ([INDEX_HEADER_SIZE] bytes): magic `CDXI`, u8 [VERSION],
+ *   3 bytes padding, i64 first bar.
+ * - One [INDEX_ENTRY_SIZE]-byte entry per bar from the first bar on:
+ *   i64 data-file position of the bar's keyframe, i64 its host time.
+ *   Entry `n` describes bar `firstBar + n`, so seeking is one read.
+ *   Bars skipped in the recording point at the next keyframe; a longer
+ *   jump than [ShowRecorder.MAX_SKIPPED_BARS] bars is shortened to that.
+ */
+internal object ShowFormat {
+    const val VERSION: Int = 1
+
+    const val DATA_HEADER_SIZE = 16
+    const val INDEX_HEADER_SIZE = 16
+    const val INDEX_ENTRY_SIZE = 16
+    const val RECORD_HEADER_SIZE = 21
+
+    const val TAG_KEYFRAME: Byte = 1
+    const val TAG_DELTA: Byte = 2
+
+    val DATA_MAGIC = byteArrayOf('C'.code.toByte(), 'D'.code.toByte(), 'X'.code.toByte(), 'S'.code.toByte())
+    val INDEX_MAGIC = byteArrayOf('C'.code.toByte(), 'D'.code.toByte(), 'X'.code.toByte(), 'I'.code.toByte())
+
+    /** Largest universe the format stores (u16 size). */
+    const val MAX_UNIVERSE_SIZE = 0xFFFF
+
+    /** Unchanged runs shorter than this stay inside a delta span (a span header is 4 bytes). */
+    const val SPAN_MERGE_GAP = 4
+
+    fun writeU16(out: ByteArray, offset: Int, value: Int) {
+        out[offset] = value.toByte()
+        out[offset + 1] = (value shr 8).toByte()
+    }
+
+    fun readU16(bytes: ByteArray, offset: Int): Int =
+        (bytes[offset].toInt() and 0xFF) or ((bytes[offset + 1].toInt() and 0xFF) shl 8)
+
+    fun writeI32(out: ByteArray, offset: Int, value: Int) {
+        for (i in 0 until 4) out[offset + i] = (value shr (8 * i)).toByte()
+    }
+
+    fun readI32(bytes: ByteArray, offset: Int): Int {
+        var value = 0
+        for (i in 0 until 4) value = value or ((bytes[offset + i].toInt() and 0xFF) shl (8 * i))
+        return value
+    }
+
+    fun writeI64(out: ByteArray, offset: Int, value: Long) {
+        for (i in 0 until 8) out[offset + i] = (value shr (8 * i)).toByte()
+    }
+
+    fun readI64(bytes: ByteArray, offset: Int): Long {
+        var value = 0L
+        for (i in 0 until 8) value = value or ((bytes[offset + i].toLong() and 0xFF) shl (8 * i))
+        return value
+    }
+
+    /** Write [magic], [VERSION] and padding into the first 8 bytes of [out]. */
+    fun writeMagic(out: ByteArray, magic: ByteArray) {
+        magic.copyInto(out)
+        out[4] = VERSION.toByte()
+    }
+
+    fun checkMagic(header: ByteArray, magic: ByteArray, what: String) {
+        require((0 until 4).all { header[it] == magic[it] }) { "Not a show $what file" }
+        require(header[4].toInt() == VERSION) { "Unsupported show $what version ${header[4]}" }
+    }
+}
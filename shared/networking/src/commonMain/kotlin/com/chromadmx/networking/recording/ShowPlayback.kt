@@ -0,0 +1,59 @@
+package com.chromadmx.networking.recording
+
+import com.chromadmx.core.util.FramePacer
+import com.chromadmx.networking.DmxTransport
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import kotlin.math.floor
+
+/**
+ * Plays a recording into a [DmxTransport] in step with a live beat.
+ *
+ * [start] lines a recorded bar up with the start of the current live bar,
+ * then every [intervalMs] (40Hz by default) the frame at the matching
+ * recorded beat is sent. Frames are paced by a [FramePacer] against
+ * absolute deadlines, so the send rate does not drift. Tempo changes on
+ * the live timeline stretch the playback with it.
+ *
+ * @param beatProvider Live beat, typically the Link session's current beat.
+ */
+class ShowPlayback(
+    private val player: ShowPlayer,
+    private val transport: DmxTransport,
+    private val beatProvider: () -> Double,
+    private val scope: CoroutineScope,
+    private val intervalMs: Long = 25L // 40Hz
+) {
+    private var job: Job? = null
+    val isRunning: Boolean get() = job?.isActive == true
+
+    /** Recorded beat minus live beat. */
+    private var beatOffset = 0.0
+
+    /** Start playing from recorded [fromBar], aligned to the current live bar. */
+    fun start(fromBar: Long = player.firstBar) {
+        if (isRunning) return
+        val quantum = player.quantum
+        beatOffset = fromBar * quantum - floor(beatProvider() / quantum) * quantum
+        val pacer = FramePacer(intervalMs * NANOS_PER_MS)
+        job = scope.launch(Dispatchers.Default) {
+            while (isActive) {
+                transport.updateFrame(player.frameAt(beatProvider() + beatOffset))
+                if (player.atEnd) break
+                pacer.awaitNextFrame()
+            }
+        }
+    }
+
+    fun stop() {
+        job?.cancel()
+        job = null
+    }
+
+    private companion object {
+        const val NANOS_PER_MS = 1_000_000L
+    }
+}
@@ -0,0 +1,175 @@
+package com.chromadmx.networking.recording
+
+import kotlin.math.floor
+
+/**
+ * Streams a [ShowRecorder] recording back as DMX frames.
+ *
+ * [frameAt] returns the frame that was on the wire at a recorded beat.
+ * Moving forward decodes only the records in between; jumping back, or
+ * more than a bar ahead, seeks through the bar index to that bar's
+ * keyframe ([seekToBar]) with one index read, then decodes forward from
+ * there. Nothing is held in memory beyond the current universes, so the
+ * length of the recording does not matter.
+ *
+ * The returned frame is the decoder's own state, rewritten by the next
+ * [frameAt] or [seekToBar]; hand it to a DMX transport, which copies it,
+ * or copy it to keep it. Use the player from one thread.
+ *
+ * @param data  Recording's data file.
+ * @param index Recording's bar index file.
+ */
+class ShowPlayer(
+    private val data: ShowFile,
+    private val index: ShowFile
+) : AutoCloseable {
+
+    private val header = ByteArray(ShowFormat.RECORD_HEADER_SIZE)
+    private var payload = ByteArray(4096)
+    private val indexEntry = ByteArray(ShowFormat.INDEX_ENTRY_SIZE)
+
+    /** Beats per bar the recording was made with. */
+    val quantum: Double
+
+    /** Bar of the first recorded frame. */
+    val firstBar: Long
+
+    init {
+        val dataHeader = ByteArray(ShowFormat.DATA_HEADER_SIZE)
+        require(data.read(0L, dataHeader, 0, dataHeader.size) == dataHeader.size) { "Show data file is empty" }
+        ShowFormat.checkMagic(dataHeader, ShowFormat.DATA_MAGIC, "data")
+        quantum = Double.fromBits(ShowFormat.readI64(dataHeader, 8))
+
+        val indexHeader = ByteArray(ShowFormat.INDEX_HEADER_SIZE)
+        require(index.read(0L, indexHeader, 0, indexHeader.size) == indexHeader.size) { "Show index file is empty" }
+        ShowFormat.checkMagic(indexHeader, ShowFormat.INDEX_MAGIC, "index")
+        firstBar = ShowFormat.readI64(indexHeader, 8)
+    }
+
+    /** Number of indexed bars; grows while the recording is still being written. */
+    val barCount: Long
+        get() = (index.length - ShowFormat.INDEX_HEADER_SIZE) / ShowFormat.INDEX_ENTRY_SIZE
+
+    /** Last bar of the recording. */
+    val lastBar: Long get() = firstBar + barCount - 1
+
+    // ---- Decoder state ----
+
+    /** Current value of each universe, in recording order. */
+    private val universes = LinkedHashMap<Int, ByteArray>()
+
+    /** Data-file position of the next undecoded record. */
+    private var position = -1L
+
+    /** Beat of the last applied record; NaN before the first seek. */
+    private var beat = Double.NaN
+
+    /**
+     * Bar whose keyframe is the last applied record, or [NO_BAR] once a
+     * later record was decoded. A beat before that keyframe (or before the
+     * first bar) is answered from it without seeking again.
+     */
+    private var seekedBar = NO_BAR
+
+    /** True once every record up to the end of the file has been applied. */
+    val atEnd: Boolean get() = position >= 0L && position >= data.length
+
+    /**
+     * Frame on the wire at recorded [beat]. Before the first bar this is
+     * the first keyframe; past the end it is the last frame.
+     */
+    fun frameAt(beat: Double): Map<Int, ByteArray> {
+        val bar = floor(beat / quantum).toLong().coerceIn(firstBar, maxOf(firstBar, lastBar))
+        val here = this.beat
+        val behind = beat < here && bar != seekedBar
+        if (position < 0L || behind || bar > floor(here / quantum).toLong() + 1) seekToBar(bar)
+        while (applyNextRecordUpTo(beat)) { /* decode forward */ }
+        return universes
+    }
+
+    /** Position the decoder on [bar]'s keyframe; false if [bar] is not in the recording. */
+    fun seekToBar(bar: Long): Boolean {
+        val entry = bar - firstBar
+        if (entry < 0L || entry >= barCount) return false
+        val at = ShowFormat.INDEX_HEADER_SIZE + entry * ShowFormat.INDEX_ENTRY_SIZE
+        if (index.read(at, indexEntry, 0, indexEntry.size) != indexEntry.size) return false
+        position = ShowFormat.readI64(indexEntry, 0)
+        beat = Double.NEGATIVE_INFINITY
+        // The keyframe is applied whatever its beat and rewrites every universe.
+        applyNextRecordUpTo(Double.POSITIVE_INFINITY)
+        seekedBar = bar
+        return true
+    }
+
+    override fun close() {
+        data.close()
+        index.close()
+    }
+
+    // ---- Decoding ----
+
+    /** Apply the record at [position] if its beat is at most [limit]. */
+    private fun applyNextRecordUpTo(limit: Double): Boolean {
+        if (position < 0L) return false
+        if (data.read(position, header, 0, header.size) != header.size) return false
+        val recordBeat = Double.fromBits(ShowFormat.readI64(header, 13))
+        if (recordBeat > limit) return false
+        val length = ShowFormat.readI32(header, 1)
+        if (payload.size < length) payload = ByteArray(maxOf(length, payload.size * 2))
+        if (data.read(position + header.size, payload, 0, length) != length) return false
+
+        when (header[0]) {
+            ShowFormat.TAG_KEYFRAME -> applyKeyframe(payload)
+            ShowFormat.TAG_DELTA -> applyDelta(payload)
+            else -> error("Corrupt show record at $position")
+        }
+        position += header.size + length
+        beat = recordBeat
+        seekedBar = NO_BAR
+        return true
+    }
+
+    private fun applyKeyframe(bytes: ByteArray) {
+        val count = ShowFormat.readU16(bytes, 0)
+        if (count != universes.size || !layoutMatches(bytes, count)) universes.clear()
+        var offset = 2
+        repeat(count) {
+            val universe = ShowFormat.readU16(bytes, offset)
+            val size = ShowFormat.readU16(bytes, offset + 2)
+            val channels = universes.getOrPut(universe) { ByteArray(size) }
+            bytes.copyInto(channels, 0, offset + 4, offset + 4 + size)
+            offset += 4 + size
+        }
+    }
+
+    /** Whether the keyframe in [bytes] has the universes and sizes decoded so far. */
+    private fun layoutMatches(bytes: ByteArray, count: Int): Boolean {
+        var offset = 2
+        repeat(count) {
+            val size = ShowFormat.readU16(bytes, offset + 2)
+            if (universes[ShowFormat.readU16(bytes, offset)]?.size != size) return false
+            offset += 4 + size
+        }
+        return true
+    }
+
+    private fun applyDelta(bytes: ByteArray) {
+        val count = ShowFormat.readU16(bytes, 0)
+        var offset = 2
+        repeat(count) {
+            val channels = universes[ShowFormat.readU16(bytes, offset)]
+            val spans = ShowFormat.readU16(bytes, offset + 2)
+            offset += 4
+            repeat(spans) {
+                val start = ShowFormat.readU16(bytes, offset)
+                val length = ShowFormat.readU16(bytes, offset + 2)
+                if (channels != null) bytes.copyInto(channels, start, offset + 4, offset + 4 + length)
+                offset += 4 + length
+            }
+        }
+    }
+
+    private companion object {
+        const val NO_BAR = Long.MIN_VALUE
+    }
+}
@@ -0,0 +1,220 @@
+package com.chromadmx.networking.recording
+
+import kotlin.math.floor
+
+/**
+ * Records outgoing DMX frames into an append-only show file, indexed by
+ * bar (see [ShowFormat] for the layout).
+ *
+ * The first frame of each bar is stored whole; every other frame stores
+ * only the channel spans that changed, and an unchanged frame writes
+ * nothing at all. A static ambient scene therefore costs one keyframe per
+ * bar. Memory use is one copy of each universe plus a reusable encode
+ * buffer, independent of how long the show runs.
+ *
+ * Call [record] from the thread producing frames (e.g. through
+ * [RecordingDmxTransport]). Beats are expected not to go backwards, as on
+ * a running Link timeline. A jump of more than [MAX_SKIPPED_BARS] bars
+ * (a peer resetting the timeline, say) is recorded as that many held bars,
+ * and later beats are shifted back by whole bars to match, so the bar
+ * index never grows by more than [MAX_SKIPPED_BARS] entries per frame.
+ *
+ * @param data    Empty file receiving the frames.
+ * @param index   Empty file receiving the bar index.
+ * @param quantum Beats per bar (4.0 in 4/4).
+ */
+class ShowRecorder(
+    private val data: ShowFile,
+    private val index: ShowFile,
+    val quantum: Double = 4.0
+) : AutoCloseable {
+
+    init {
+        require(data.length == 0L && index.length == 0L) { "Record into empty show files" }
+        require(quantum > 0.0) { "quantum must be > 0, got $quantum" }
+        val header = ByteArray(ShowFormat.DATA_HEADER_SIZE)
+        ShowFormat.writeMagic(header, ShowFormat.DATA_MAGIC)
+        ShowFormat.writeI64(header, 8, quantum.toRawBits())
+        data.append(header)
+    }
+
+    /** Last recorded value of every universe; the base for the next delta. */
+    private val previous = LinkedHashMap<Int, ByteArray>()
+
+    private var scratch = ByteArray(4096)
+    private val indexEntry = ByteArray(ShowFormat.INDEX_ENTRY_SIZE)
+
+    /** Bar of the last keyframe, or null before the first frame. */
+    private var lastBar: Long? = null
+
+    /** Bars cut out of the timeline by clamped jumps; subtracted from every live bar. */
+    private var skippedBarsCut = 0L
+
+    /** Frames that produced a record (unchanged frames are skipped). */
+    var recordsWritten: Long = 0L
+        private set
+
+    /** Keyframes written; at least one per recorded bar. */
+    var keyframesWritten: Long = 0L
+        private set
+
+    /** Size of the data file so far. */
+    val bytesWritten: Long get() = data.length
+
+    /**
+     * Record [frame] as output at [hostMicros] on the timeline at [beat].
+     *
+     * The channel arrays are copied, so the caller may reuse them.
+     */
+    fun record(frame: Map<Int, ByteArray>, hostMicros: Long, beat: Double) {
+        if (frame.isEmpty()) return
+        var bar = floor(beat / quantum).toLong() - skippedBarsCut
+        val last = lastBar
+        if (last != null && bar - last > MAX_SKIPPED_BARS) {
+            skippedBarsCut += bar - last - MAX_SKIPPED_BARS
+            bar = last + MAX_SKIPPED_BARS
+        }
+        val recordedBeat = beat - skippedBarsCut * quantum
+        if (last == null || bar > last || layoutChanged(frame)) {
+            writeKeyframe(frame, hostMicros, recordedBeat, bar, last)
+        } else {
+            writeDelta(frame, hostMicros, recordedBeat)
+        }
+    }
+
+    override fun close() {
+        data.flush()
+        index.flush()
+        data.close()
+        index.close()
+    }
+
+    // ---- Encoding ----
+
+    private fun layoutChanged(frame: Map<Int, ByteArray>): Boolean {
+        if (frame.size != previous.size) return true
+        for ((universe, channels) in frame) {
+            val before = previous[universe] ?: return true
+            if (before.size != channels.size) return true
+        }
+        return false
+    }
+
+    private fun writeKeyframe(frame: Map<Int, ByteArray>, hostMicros: Long, beat: Double, bar: Long, last: Long?) {
+        var payload = 2
+        for (channels in frame.values) payload += 4 + minOf(channels.size, ShowFormat.MAX_UNIVERSE_SIZE)
+        val out = ensureScratch(ShowFormat.RECORD_HEADER_SIZE + payload)
+
+        var offset = ShowFormat.RECORD_HEADER_SIZE
+        ShowFormat.writeU16(out, offset, frame.size)
+        offset += 2
+        previous.clear()
+        for ((universe, channels) in frame) {
+            val size = minOf(channels.size, ShowFormat.MAX_UNIVERSE_SIZE)
+            ShowFormat.writeU16(out, offset, universe)
+            ShowFormat.writeU16(out, offset + 2, size)
+            channels.copyInto(out, offset + 4, 0, size)
+            offset += 4 + size
+            previous[universe] = channels.copyOf(size)
+        }
+
+        val position = data.length
+        appendRecord(ShowFormat.TAG_KEYFRAME, hostMicros, beat, offset)
+        keyframesWritten++
+
+        // Index every bar from the one after the last keyframe up to this one.
+        if (last == null) {
+            val header = ByteArray(ShowFormat.INDEX_HEADER_SIZE)
+            ShowFormat.writeMagic(header, ShowFormat.INDEX_MAGIC)
+            ShowFormat.writeI64(header, 8, bar)
+            index.append(header)
+            appendIndexEntry(position, hostMicros)
+        } else {
+            repeat((bar - last).coerceAtLeast(0L).toInt()) { appendIndexEntry(position, hostMicros) }
+        }
+        lastBar = if (last == null) bar else maxOf(bar, last)
+    }
+
+    private fun writeDelta(frame: Map<Int, ByteArray>, hostMicros: Long, beat: Double) {
+        // Generous bound; spans never cost more than their channels twice over.
+        var bound = 2
+        for (channels in frame.values) bound += 4 + channels.size * 2
+        val out = ensureScratch(ShowFormat.RECORD_HEADER_SIZE + bound)
+
+        var offset = ShowFormat.RECORD_HEADER_SIZE + 2
+        var changedUniverses = 0
+        for ((universe, channels) in frame) {
+            val before = previous.getValue(universe)
+            val universeStart = offset
+            offset += 4
+            var spans = 0
+            var i = 0
+            val size = before.size
+            while (i < size) {
+                if (channels[i] == before[i]) {
+                    i++
+                    continue
+                }
+                // Extend the span across short unchanged gaps.
+                var end = i + 1
+                var gap = 0
+                var j = end
+                while (j < size && gap < ShowFormat.SPAN_MERGE_GAP) {
+                    if (channels[j] != before[j]) {
+                        end = j + 1
+                        gap = 0
+                    } else {
+                        gap++
+                    }
+                    j++
+                }
+                val length = end - i
+                ShowFormat.writeU16(out, offset, i)
+                ShowFormat.writeU16(out, offset + 2, length)
+                channels.copyInto(out, offset + 4, i, end)
+                channels.copyInto(before, i, i, end)
+                offset += 4 + length
+                spans++
+                i = end
+            }
+            if (spans == 0) {
+                offset = universeStart
+            } else {
+                ShowFormat.writeU16(out, universeStart, universe)
+                ShowFormat.writeU16(out, universeStart + 2, spans)
+                changedUniverses++
+            }
+        }
+        if (changedUniverses == 0) return
+
+        ShowFormat.writeU16(out, ShowFormat.RECORD_HEADER_SIZE, changedUniverses)
+        appendRecord(ShowFormat.TAG_DELTA, hostMicros, beat, offset)
+    }
+
+    /** Fill in the header of the record encoded in [scratch] and append it. */
+    private fun appendRecord(tag: Byte, hostMicros: Long, beat: Double, end: Int) {
+        val out = scratch
+        out[0] = tag
+        ShowFormat.writeI32(out, 1, end - ShowFormat.RECORD_HEADER_SIZE)
+        ShowFormat.writeI64(out, 5, hostMicros)
+        ShowFormat.writeI64(out, 13, beat.toRawBits())
+        data.append(out, 0, end)
+        recordsWritten++
+    }
+
+    private fun appendIndexEntry(position: Long, hostMicros: Long) {
+        ShowFormat.writeI64(indexEntry, 0, position)
+        ShowFormat.writeI64(indexEntry, 8, hostMicros)
+        index.append(indexEntry)
+    }
+
+    private fun ensureScratch(size: Int): ByteArray {
+        if (scratch.size < size) scratch = ByteArray(maxOf(size, scratch.size * 2))
+        return scratch
+    }
+
+    companion object {
+        /** Longest run of empty bars indexed between two frames; 64 bars is two minutes at 128 BPM. */
+        const val MAX_SKIPPED_BARS = 64L
+    }
+}
@@ -0,0 +1,73 @@
+package com.chromadmx.networking.transport
+
+/**
+ * A reusable list of datagrams sent together by [PlatformUdpTransport.sendBatch].
+ *
+ * Entries reference caller-owned packet buffers; nothing is copied. An
+ * output loop clears and refills one batch every frame, so the backing
+ * arrays only grow when the universe count does.
+ *
+ * Not thread-safe: fill and send from the same loop.
+ *
+ * @param initialCapacity Number of entries to preallocate.
+ */
+class UdpBatch(initialCapacity: Int = DEFAULT_CAPACITY) {
+
+    private var packets = arrayOfNulls<ByteArray>(initialCapacity.coerceAtLeast(1))
+    private var lengths = IntArray(packets.size)
+    private var addresses = arrayOfNulls<String>(packets.size)
+    private var ports = IntArray(packets.size)
+
+    /** Number of datagrams currently in the batch. */
+    var size: Int = 0
+        private set
+
+    /**
+     * Append a datagram.
+     *
+     * @param packet  Buffer holding the datagram; must stay unmodified until sent
+     * @param length  Number of bytes of [packet] to send
+     * @param address Destination IP address (dotted string)
+     * @param port    Destination UDP port
+     */
+    fun add(packet: ByteArray, length: Int, address: String, port: Int) {
+        require(length in 0..packet.size) { "length $length out of range for ${packet.size}-byte packet" }
+        if (size == packets.size) grow()
+        packets[size] = packet
+        lengths[size] = length
+        addresses[size] = address
+        ports[size] = port
+        size++
+    }
+
+    /** Remove all entries, keeping the allocated capacity. */
+    fun clear() {
+        // Drop buffer references so a shrunk frame does not pin old packets
+        packets.fill(null, 0, size)
+        addresses.fill(null, 0, size)
+        size = 0
+    }
+
+    fun packet(index: Int): ByteArray = packets[checkIndex(index)]!!
+    fun length(index: Int): Int = lengths[checkIndex(index)]
+    fun address(index: Int): String = addresses[checkIndex(index)]!!
+    fun port(index: Int): Int = ports[checkIndex(index)]
+
+    private fun checkIndex(index: Int): Int {
+        if (index !in 0 until size) throw IndexOutOfBoundsException("index $index, size $size")
+        return index
+    }
+
+    private fun grow() {
+        val capacity = packets.size * 2
+        packets = packets.copyOf(capacity)
+        lengths = lengths.copyOf(capacity)
+        addresses = addresses.copyOf(capacity)
+        ports = ports.copyOf(capacity)
+    }
+
+    companion object {
+        /** Enough for a typical multi-universe rig without growing. */
+        const val DEFAULT_CAPACITY = 8
+    }
+}
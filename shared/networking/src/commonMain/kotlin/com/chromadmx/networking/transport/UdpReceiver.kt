@@ -0,0 +1,85 @@
+package com.chromadmx.networking.transport
+
+/**
+ * A reusable receive buffer plus the source of the last datagram read
+ * into it by [PlatformUdpReceiver.receive].
+ *
+ * The receive loop fills the same instance for every packet, so parsing
+ * thousands of packets per second allocates nothing.
+ *
+ * @param capacity Largest datagram accepted; longer ones are truncated.
+ */
+class UdpDatagram(capacity: Int = DEFAULT_CAPACITY) {
+
+    /** Datagram bytes; only the first [length] are valid. */
+    val buffer: ByteArray = ByteArray(capacity)
+
+    /** Bytes received into [buffer]. */
+    var length: Int = 0
+        internal set
+
+    /** Sender IPv4 address, first octet in the high byte (see [ipv4ToInt]). */
+    var sourceAddress: Int = 0
+        internal set
+
+    /** Sender UDP port. */
+    var sourcePort: Int = 0
+        internal set
+
+    /** Record a received datagram; used by the platform receivers. */
+    internal fun set(length: Int, sourceAddress: Int, sourcePort: Int) {
+        this.length = length
+        this.sourceAddress = sourceAddress
+        this.sourcePort = sourcePort
+    }
+
+    companion object {
+        /** Fits any ArtDmx or full-universe E1.31 packet. */
+        const val DEFAULT_CAPACITY = 1024
+
+        /** Dotted-quad IPv4 [address] as an Int, first octet in the high byte; 0 if malformed. */
+        fun ipv4ToInt(address: String): Int {
+            val octets = address.split('.')
+            if (octets.size != 4) return 0
+            var value = 0
+            for (octet in octets) {
+                val byte = octet.toIntOrNull() ?: return 0
+                if (byte !in 0..255) return 0
+                value = (value shl 8) or byte
+            }
+            return value
+        }
+    }
+}
+
+/**
+ * Bound UDP socket for receiving DMX-over-IP traffic (Art-Net on 6454,
+ * sACN on 5568 plus its multicast groups).
+ *
+ * Unlike [PlatformUdpTransport.receive], [receive] blocks the calling
+ * thread and fills a caller-owned [UdpDatagram], so it must run on a
+ * thread of its own (e.g. a coroutine on Dispatchers.IO) and
+ * costs no allocation per packet.
+ *
+ * @param port Local UDP port to bind, with address reuse so other apps
+ *             and [PlatformUdpTransport] can share it.
+ */
+expect class PlatformUdpReceiver(port: Int) {
+
+    /** Join the IPv4 multicast [group] (dotted string) on the default interface. */
+    fun joinMulticastGroup(group: String)
+
+    /**
+     * Block until a datagram arrives or [timeoutMs] passes.
+     *
+     * @return true if [into] now holds a datagram; false on timeout or
+     *         once the receiver is closed
+     */
+    fun receive(into: UdpDatagram, timeoutMs: Int): Boolean
+
+    /** Whether [close] has been called; [receive] then returns false at once. */
+    val isClosed: Boolean
+
+    /** Close the socket; a blocked [receive] returns false. */
+    fun close()
+}
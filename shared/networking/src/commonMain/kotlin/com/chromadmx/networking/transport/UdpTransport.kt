@@ -21,6 +21,19 @@ expect class PlatformUdpTransport() {
      */
     suspend fun send(data: ByteArray, address: String, port: Int)
 
+    /**
+     * Send every datagram in [batch] back-to-back.
+     *
+     * The whole batch is handed to the socket in one dispatcher hop with
+     * destination addresses resolved from a cache, so a multi-universe
+     * frame costs one thread switch rather than one per universe and its
+     * packets leave together. A datagram that fails to send does not stop
+     * the rest of the batch.
+     *
+     * @return number of datagrams sent successfully
+     */
+    suspend fun sendBatch(batch: UdpBatch): Int
+
     /**
      * Receive a UDP datagram.
      *
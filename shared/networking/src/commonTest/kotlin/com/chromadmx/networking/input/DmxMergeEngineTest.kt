@@ -0,0 +1,132 @@
+package com.chromadmx.networking.input
+
+import com.chromadmx.networking.protocol.ArtNetCodec
+import com.chromadmx.networking.protocol.SacnCodec
+import com.chromadmx.networking.protocol.SacnConstants
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class DmxMergeEngineTest {
+
+    private val consoleIp = 0x0A000001 // 10.0.0.1
+    private val phoneIp = 0x0A000002 // 10.0.0.2
+    private val cid = ByteArray(16) { (it + 1).toByte() }
+
+    private fun DmxMergeEngine.artDmx(source: Int, vararg channels: Int, nowMs: Long = 0L): Boolean {
+        val packet = ArtNetCodec.encodeArtDmx(0, 0, UNIVERSE, bytes(*channels))
+        return acceptArtDmx(packet, packet.size, source, nowMs)
+    }
+
+    private fun DmxMergeEngine.sacn(
+        vararg channels: Int,
+        priority: Int = SacnConstants.DEFAULT_PRIORITY,
+        sequence: Int = 0,
+        options: Int = 0,
+        nowMs: Long = 0L
+    ): Boolean {
+        val packet = SacnCodec.encode(
+            cid = cid, priority = priority, sequence = sequence, options = options,
+            universe = UNIVERSE, dmxData = bytes(*channels)
+        )
+        return acceptSacn(packet, packet.size, nowMs)
+    }
+
+    private fun DmxMergeEngine.read(): ByteArray {
+        val into = ByteArray(512)
+        return into.copyOf(readUniverse(UNIVERSE, into))
+    }
+
+    private fun bytes(vararg values: Int) = ByteArray(values.size) { values[it].toByte() }
+
+    @Test
+    fun htpTakesHighestValuePerChannel() {
+        val merge = DmxMergeEngine(MergeMode.HTP)
+        merge.artDmx(consoleIp, 10, 200)
+        merge.artDmx(phoneIp, 50, 100)
+
+        assertContentEquals(bytes(50, 200), merge.read())
+        assertEquals(2, merge.sourceCount(UNIVERSE))
+    }
+
+    @Test
+    fun ltpFollowsLatestChange() {
+        val merge = DmxMergeEngine(MergeMode.LTP)
+        merge.artDmx(consoleIp, 10, 10)
+        merge.artDmx(phoneIp, 20, 20)
+        assertContentEquals(bytes(20, 20), merge.read())
+
+        merge.artDmx(consoleIp, 30, 10)
+        assertContentEquals(bytes(30, 20), merge.read())
+    }
+
+    @Test
+    fun higherSacnPriorityOverridesArtNet() {
+        val merge = DmxMergeEngine()
+        merge.artDmx(consoleIp, 200, 200)
+        merge.sacn(5, 5, priority = 150)
+
+        assertContentEquals(bytes(5, 5), merge.read())
+        assertEquals(150, merge.priorityOf(UNIVERSE))
+    }
+
+    @Test
+    fun silentSourceExpires() {
+        val merge = DmxMergeEngine()
+        merge.artDmx(consoleIp, 200, 200, nowMs = 0L)
+        merge.sacn(5, 5, priority = 150, nowMs = 0L)
+
+        merge.expire(DmxMergeEngine.SACN_SOURCE_TIMEOUT_MS + 1)
+        assertContentEquals(bytes(200, 200), merge.read())
+        assertEquals(SacnConstants.DEFAULT_PRIORITY, merge.priorityOf(UNIVERSE))
+
+        merge.expire(DmxMergeEngine.ART_NET_SOURCE_TIMEOUT_MS + 1)
+        assertEquals(0, merge.read().size)
+        assertEquals(-1, merge.priorityOf(UNIVERSE))
+    }
+
+    @Test
+    fun streamTerminatedDropsSourceAtOnce() {
+        val merge = DmxMergeEngine()
+        merge.sacn(80, 80)
+        merge.sacn(80, 80, sequence = 1, options = SacnConstants.OPTION_STREAM_TERMINATED)
+
+        assertEquals(0, merge.sourceCount(UNIVERSE))
+        assertEquals(0, merge.read().size)
+    }
+
+    @Test
+    fun outOfOrderSacnIsRejected() {
+        val merge = DmxMergeEngine()
+        assertTrue(merge.sacn(40, sequence = 10))
+        assertFalse(merge.sacn(99, sequence = 9))
+        assertTrue(merge.sacn(41, sequence = 11))
+
+        assertContentEquals(bytes(41), merge.read())
+        assertEquals(1L, merge.packetsRejected)
+    }
+
+    @Test
+    fun ownTrafficIsIgnored() {
+        val merge = DmxMergeEngine(ownCid = cid)
+        merge.ignoreArtNetSource(phoneIp)
+
+        assertFalse(merge.sacn(1, 2))
+        assertFalse(merge.artDmx(phoneIp, 3, 4))
+        assertEquals(0, merge.sourceCount(UNIVERSE))
+    }
+
+    @Test
+    fun nonDmxPacketsAreNotMerged() {
+        val merge = DmxMergeEngine()
+        val poll = ArtNetCodec.encodeArtPoll()
+        assertFalse(merge.acceptArtDmx(poll, poll.size, consoleIp, 0L))
+        assertFalse(merge.acceptSacn(poll, poll.size, 0L))
+    }
+
+    private companion object {
+        const val UNIVERSE = 1
+    }
+}
@@ -0,0 +1,78 @@
+package com.chromadmx.networking.input
+
+import com.chromadmx.networking.ConnectionState
+import com.chromadmx.networking.DmxTransport
+import com.chromadmx.networking.protocol.ArtNetCodec
+import com.chromadmx.networking.protocol.SacnCodec
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+
+class MergingDmxTransportTest {
+
+    private class CapturingTransport : DmxTransport {
+        var last: Map<Int, ByteArray> = emptyMap()
+        override val connectionState: StateFlow<ConnectionState> = MutableStateFlow(ConnectionState.Connected)
+        override val isRunning = true
+        override fun start() {}
+        override fun stop() {}
+        override fun sendFrame(universe: Int, channels: ByteArray) {}
+        override fun updateFrame(universeData: Map<Int, ByteArray>) {
+            last = universeData.mapValues { it.value.copyOf() }
+        }
+    }
+
+    private fun bytes(vararg values: Int) = ByteArray(values.size) { values[it].toByte() }
+
+    private fun DmxMergeEngine.artDmx(vararg channels: Int) {
+        val packet = ArtNetCodec.encodeArtDmx(0, 0, 1, bytes(*channels))
+        acceptArtDmx(packet, packet.size, 0x0A000001, 0L)
+    }
+
+    @Test
+    fun localOnlyUniversePassesThrough() {
+        val out = CapturingTransport()
+        val transport = MergingDmxTransport(out, DmxMergeEngine())
+        transport.updateFrame(mapOf(0 to bytes(1, 2, 3, 4)))
+
+        assertContentEquals(bytes(1, 2, 3, 4), out.last.getValue(0))
+    }
+
+    @Test
+    fun equalPriorityMergesHtp() {
+        val out = CapturingTransport()
+        val merge = DmxMergeEngine(MergeMode.HTP)
+        val transport = MergingDmxTransport(out, merge)
+        merge.artDmx(50, 0, 0, 0)
+
+        transport.updateFrame(mapOf(1 to bytes(10, 10, 10, 10)))
+        assertContentEquals(bytes(50, 10, 10, 10), out.last.getValue(1))
+    }
+
+    @Test
+    fun equalPriorityLtpFollowsWhicheverSideMoved() {
+        val out = CapturingTransport()
+        val merge = DmxMergeEngine(MergeMode.LTP)
+        val transport = MergingDmxTransport(out, merge)
+        merge.artDmx(50, 0, 0, 0)
+
+        transport.updateFrame(mapOf(1 to bytes(10, 10, 10, 10)))
+        assertContentEquals(bytes(50, 10, 10, 10), out.last.getValue(1))
+
+        transport.updateFrame(mapOf(1 to bytes(20, 10, 10, 10)))
+        assertContentEquals(bytes(20, 10, 10, 10), out.last.getValue(1))
+    }
+
+    @Test
+    fun higherPriorityInputReplacesLocal() {
+        val out = CapturingTransport()
+        val merge = DmxMergeEngine()
+        val transport = MergingDmxTransport(out, merge)
+        val packet = SacnCodec.encode(priority = 180, universe = 1, dmxData = bytes(7, 7))
+        merge.acceptSacn(packet, packet.size, 0L)
+
+        transport.updateFrame(mapOf(1 to bytes(99, 99, 99, 99)))
+        assertContentEquals(bytes(7, 7, 0, 0), out.last.getValue(1))
+    }
+}
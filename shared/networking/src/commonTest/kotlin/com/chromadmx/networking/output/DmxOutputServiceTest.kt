@@ -1,5 +1,6 @@
 package com.chromadmx.networking.output
 
+import com.chromadmx.core.telemetry.PerformanceTelemetry
 import com.chromadmx.networking.protocol.ArtNetCodec
 import com.chromadmx.networking.protocol.ArtNetConstants
 import com.chromadmx.networking.protocol.SacnCodec
@@ -205,6 +206,72 @@ class DmxOutputServiceTest {
         assertTrue(data.contentEquals(decoded.dmxData))
     }
 
+    // ------------------------------------------------------------------ //
+    //  Unchanged-universe suppression                                     //
+    // ------------------------------------------------------------------ //
+
+    @Test
+    fun staticUniverse_suppressedBetweenKeepalives() = runTest {
+        val telemetry = PerformanceTelemetry()
+        val service = DmxOutputService(PlatformUdpTransport(), frameRateHz = 40, telemetry = telemetry)
+        service.updateFrame(mapOf(0 to ByteArray(512) { 0x40 }))
+
+        // First frame plus two repeats, then one keepalive 32 frames (800ms) later.
+        repeat(40) { service.sendAllUniverses() }
+
+        assertEquals(4L, telemetry.dmxUniversesSent)
+        assertEquals(36L, telemetry.dmxUniversesSkipped)
+        assertEquals(1, service.lastFrameSkippedUniverses)
+    }
+
+    @Test
+    fun changedUniverse_sentImmediately() = runTest {
+        val telemetry = PerformanceTelemetry()
+        val service = DmxOutputService(PlatformUdpTransport(), telemetry = telemetry)
+        val still = ByteArray(512)
+        val moving = ByteArray(512)
+        service.updateFrame(mapOf(0 to still, 1 to moving))
+        repeat(10) { service.sendAllUniverses() }
+        assertEquals(2, service.lastFrameSkippedUniverses)
+
+        moving[7] = 1
+        service.updateFrame(mapOf(0 to still, 1 to moving))
+        service.sendAllUniverses()
+        assertEquals(1, service.lastFrameSkippedUniverses)
+        assertEquals(6L + 1L, telemetry.dmxUniversesSent)
+    }
+
+    @Test
+    fun updateFrame_copiesCallerArrays() = runTest {
+        val telemetry = PerformanceTelemetry()
+        val service = DmxOutputService(PlatformUdpTransport(), telemetry = telemetry)
+        val data = ByteArray(512)
+        service.updateFrame(mapOf(0 to data))
+        repeat(10) { service.sendAllUniverses() }
+        assertEquals(1, service.lastFrameSkippedUniverses)
+
+        // Rewriting the caller's array without a new updateFrame changes nothing.
+        data.fill(0x7F)
+        service.sendAllUniverses()
+        assertEquals(1, service.lastFrameSkippedUniverses)
+        assertEquals(3L, telemetry.dmxUniversesSent)
+    }
+
+    @Test
+    fun suppressionDisabled_sendsEveryFrame() = runTest {
+        val telemetry = PerformanceTelemetry()
+        val service = DmxOutputService(
+            PlatformUdpTransport(),
+            telemetry = telemetry,
+            suppressUnchanged = false
+        )
+        service.updateFrame(mapOf(0 to ByteArray(512)))
+        repeat(10) { service.sendAllUniverses() }
+
+        assertEquals(10L, telemetry.dmxUniversesSent)
+        assertEquals(0L, telemetry.dmxUniversesSkipped)
+    }
+
     // ------------------------------------------------------------------ //
     //  Multi-universe support                                             //
     // ------------------------------------------------------------------ //
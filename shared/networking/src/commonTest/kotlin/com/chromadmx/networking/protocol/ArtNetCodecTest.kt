@@ -528,4 +528,26 @@ class ArtNetCodecTest {
             )
         }
     }
+
+    // ------------------------------------------------------------------ //
+    //  ArtDmx encode into reused buffer                                   //
+    // ------------------------------------------------------------------ //
+
+    @Test
+    fun encodeArtDmxInto_matchesEncodeArtDmx() {
+        val data = ByteArray(512) { (it * 7).toByte() }
+        val expected = ArtNetCodec.encodeArtDmx(3, 1, 0x0102, data)
+        val packet = ByteArray(ArtNetCodec.artDmxSize(512)) { 0x55 }
+        val written = ArtNetCodec.encodeArtDmxInto(packet, 3, 1, 0x0102, data)
+        assertEquals(expected.size, written)
+        assertTrue(expected.contentEquals(packet))
+    }
+
+    @Test
+    fun encodeArtDmxInto_clearsPadByteOfDirtyBuffer() {
+        val packet = ByteArray(ArtNetCodec.artDmxSize(3)) { 0x7F }
+        val written = ArtNetCodec.encodeArtDmxInto(packet, 0, 0, 0, byteArrayOf(1, 2, 3))
+        assertEquals(ArtNetConstants.ART_DMX_HEADER_SIZE + 4, written)
+        assertEquals(0, packet[written - 1].toInt())
+    }
 }
@@ -416,4 +416,30 @@ class SacnCodecTest {
         assertEquals(0x02, packet[123].toInt() and 0xFF)
         assertEquals(0x01, packet[124].toInt() and 0xFF)
     }
+
+    // ------------------------------------------------------------------ //
+    //  Encode into reused buffer                                          //
+    // ------------------------------------------------------------------ //
+
+    @Test
+    fun encodeInto_dirtyBuffer_matchesEncode() {
+        val cid = ByteArray(16) { it.toByte() }
+        val dmxData = ByteArray(512) { (it * 3).toByte() }
+        val packet = ByteArray(SacnCodec.packetSize(512))
+        // Leave a longer source name from a previous frame in the buffer.
+        SacnCodec.encodeInto(
+            packet, cid, "A much longer previous name".encodeToByteArray(),
+            50, 9, 0, 2, 0x00, ByteArray(512) { 0x11 }
+        )
+
+        val written = SacnCodec.encodeInto(
+            packet, cid, "Short".encodeToByteArray(), 100, 10, 0, 7, 0x00, dmxData
+        )
+        val expected = SacnCodec.encode(
+            cid = cid, sourceName = "Short", priority = 100, sequence = 10,
+            universe = 7, dmxData = dmxData
+        )
+        assertEquals(expected.size, written)
+        assertTrue(expected.contentEquals(packet))
+    }
 }
@@ -0,0 +1,161 @@
+package com.chromadmx.networking.recording
+
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class ShowRecordingTest {
+
+    /** Two 512-channel universes with a handful of channels moving per frame. */
+    private fun frame(step: Int): Map<Int, ByteArray> = mapOf(
+        0 to ByteArray(512) { ch -> if (ch < 12) (step * 3 + ch).toByte() else 40 },
+        1 to ByteArray(512) { ch -> if (ch in 200 until 206) (step * 7).toByte() else 0 }
+    )
+
+    private fun assertFrame(expected: Map<Int, ByteArray>, actual: Map<Int, ByteArray>, message: String? = null) {
+        assertEquals(expected.keys, actual.keys, message)
+        for ((universe, channels) in expected) {
+            assertContentEquals(channels, actual.getValue(universe), message)
+        }
+    }
+
+    /** Record [steps] frames a quarter beat apart; returns the frames by step. */
+    private fun record(
+        data: InMemoryShowFile,
+        index: InMemoryShowFile,
+        steps: Int
+    ): List<Map<Int, ByteArray>> {
+        val recorder = ShowRecorder(data, index)
+        val frames = (0 until steps).map { frame(it) }
+        frames.forEachIndexed { i, f -> recorder.record(f, i * 125_000L, i * 0.25) }
+        return frames
+    }
+
+    @Test
+    fun playbackReproducesRecordedFrames() {
+        val data = InMemoryShowFile()
+        val index = InMemoryShowFile()
+        val frames = record(data, index, 48)
+
+        val player = ShowPlayer(data, index)
+        frames.forEachIndexed { i, expected ->
+            assertFrame(expected, player.frameAt(i * 0.25), "step $i")
+        }
+        assertTrue(player.atEnd)
+    }
+
+    @Test
+    fun staticSceneCostsOneKeyframePerBar() {
+        val recorder = ShowRecorder(InMemoryShowFile(), InMemoryShowFile())
+        val still = frame(0)
+        repeat(32) { recorder.record(still, it * 125_000L, it * 0.25) }
+
+        assertEquals(2L, recorder.keyframesWritten)
+        assertEquals(2L, recorder.recordsWritten)
+    }
+
+    @Test
+    fun deltaStoresOnlyChangedChannels() {
+        val data = InMemoryShowFile()
+        val recorder = ShowRecorder(data, InMemoryShowFile())
+        val first = frame(0)
+        recorder.record(first, 0L, 0.0)
+        val afterKeyframe = data.length
+
+        val second = first.mapValues { it.value.copyOf() }
+        second.getValue(1)[300] = 99
+        recorder.record(second, 125_000L, 0.25)
+        val delta = data.length - afterKeyframe
+
+        assertTrue(delta * 10 < afterKeyframe, "delta of $delta bytes vs keyframe of $afterKeyframe")
+    }
+
+    @Test
+    fun seekingBackLandsOnExactFrame() {
+        val data = InMemoryShowFile()
+        val index = InMemoryShowFile()
+        val frames = record(data, index, 48)
+        val player = ShowPlayer(data, index)
+
+        player.frameAt(10.0)
+        assertFrame(frames[18], player.frameAt(4.5))
+
+        assertTrue(player.seekToBar(2))
+        assertFrame(frames[32], player.frameAt(8.0))
+        assertFalse(player.seekToBar(3))
+    }
+
+    @Test
+    fun skippedBarsAreIndexed() {
+        val data = InMemoryShowFile()
+        val index = InMemoryShowFile()
+        val recorder = ShowRecorder(data, index)
+        recorder.record(frame(0), 0L, 0.0)
+        recorder.record(frame(1), 6_000_000L, 12.0)
+
+        val player = ShowPlayer(data, index)
+        assertEquals(0L, player.firstBar)
+        assertEquals(4L, player.barCount)
+        assertTrue(player.seekToBar(2))
+        assertFrame(frame(1), player.frameAt(12.0))
+    }
+
+    @Test
+    fun beatJumpIndexesAtMostMaxSkippedBars() {
+        val data = InMemoryShowFile()
+        val index = InMemoryShowFile()
+        val recorder = ShowRecorder(data, index)
+        recorder.record(frame(0), 0L, 0.0)
+        recorder.record(frame(1), 1_000L, 4.0e9)
+        recorder.record(frame(2), 2_000_000L, 4.0e9 + 4.0)
+
+        val player = ShowPlayer(data, index)
+        val jumpBar = ShowRecorder.MAX_SKIPPED_BARS
+        assertEquals(jumpBar + 2, player.barCount)
+        assertFrame(frame(1), player.frameAt(jumpBar * 4.0))
+        assertFrame(frame(2), player.frameAt((jumpBar + 1) * 4.0))
+    }
+
+    /** Index file that counts reads, to observe how often the player seeks. */
+    private class CountingShowFile(private val inner: ShowFile) : ShowFile by inner {
+        var reads = 0
+
+        override fun read(position: Long, into: ByteArray, offset: Int, length: Int): Int {
+            reads++
+            return inner.read(position, into, offset, length)
+        }
+    }
+
+    @Test
+    fun beatsBeforeTheKeyframeSeekOnce() {
+        val data = InMemoryShowFile()
+        val index = InMemoryShowFile()
+        val recorder = ShowRecorder(data, index)
+        // The bar's keyframe lands half a beat in.
+        (2 until 16).forEach { recorder.record(frame(it), it * 125_000L, it * 0.25) }
+
+        val counted = CountingShowFile(index)
+        val player = ShowPlayer(data, counted)
+        assertFrame(frame(2), player.frameAt(0.0))
+        val reads = counted.reads
+        player.frameAt(0.1)
+        player.frameAt(0.2)
+        assertEquals(reads, counted.reads)
+
+        // Past the end stays on the last frame without seeking either.
+        assertFrame(frame(15), player.frameAt(40.0))
+        val endReads = counted.reads
+        player.frameAt(41.0)
+        assertEquals(endReads, counted.reads)
+    }
+
+    @Test
+    fun emptyFilesAreRejected() {
+        assertFailsWith<IllegalArgumentException> {
+            ShowPlayer(InMemoryShowFile(), InMemoryShowFile())
+        }
+    }
+}
@@ -0,0 +1,59 @@
+package com.chromadmx.networking.transport
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertSame
+
+class UdpBatchTest {
+
+    @Test
+    fun addKeepsEntriesInOrder() {
+        val batch = UdpBatch()
+        val first = ByteArray(530)
+        val second = ByteArray(638)
+        batch.add(first, 530, "255.255.255.255", 6454)
+        batch.add(second, 600, "239.255.0.1", 5568)
+
+        assertEquals(2, batch.size)
+        assertSame(first, batch.packet(0))
+        assertEquals(530, batch.length(0))
+        assertEquals("255.255.255.255", batch.address(0))
+        assertEquals(6454, batch.port(0))
+        assertSame(second, batch.packet(1))
+        assertEquals(600, batch.length(1))
+        assertEquals("239.255.0.1", batch.address(1))
+        assertEquals(5568, batch.port(1))
+    }
+
+    @Test
+    fun growsBeyondInitialCapacity() {
+        val batch = UdpBatch(initialCapacity = 2)
+        repeat(64) { batch.add(ByteArray(it + 1), it + 1, "10.0.0.$it", it) }
+
+        assertEquals(64, batch.size)
+        assertEquals(64, batch.length(63))
+        assertEquals("10.0.0.63", batch.address(63))
+    }
+
+    @Test
+    fun clearEmptiesBatchForReuse() {
+        val batch = UdpBatch()
+        batch.add(ByteArray(4), 4, "10.0.0.1", 1)
+        batch.clear()
+
+        assertEquals(0, batch.size)
+        assertFailsWith<IndexOutOfBoundsException> { batch.packet(0) }
+
+        batch.add(ByteArray(2), 2, "10.0.0.2", 2)
+        assertEquals("10.0.0.2", batch.address(0))
+    }
+
+    @Test
+    fun rejectsLengthLongerThanPacket() {
+        val batch = UdpBatch()
+        assertFailsWith<IllegalArgumentException> {
+            batch.add(ByteArray(4), 5, "10.0.0.1", 1)
+        }
+    }
+}
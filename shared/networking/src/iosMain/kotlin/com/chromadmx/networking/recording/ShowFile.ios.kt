@@ -0,0 +1,106 @@
+package com.chromadmx.networking.recording
+
+import kotlinx.atomicfu.locks.SynchronizedObject
+import kotlinx.atomicfu.locks.synchronized
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.addressOf
+import kotlinx.cinterop.alloc
+import kotlinx.cinterop.convert
+import kotlinx.cinterop.memScoped
+import kotlinx.cinterop.ptr
+import kotlinx.cinterop.usePinned
+import platform.posix.O_CREAT
+import platform.posix.O_RDONLY
+import platform.posix.O_RDWR
+import platform.posix.O_TRUNC
+import platform.posix.errno
+import platform.posix.fstat
+import platform.posix.fsync
+import platform.posix.open
+import platform.posix.pread
+import platform.posix.pwrite
+import platform.posix.stat
+import kotlin.concurrent.Volatile
+
+/**
+ * iOS actual using POSIX file descriptors via `platform.posix`.
+ *
+ * Reads are positional `pread` calls into the caller's buffer, so
+ * playback keeps nothing of the file on the Kotlin heap. A read-only
+ * handle re-stats the file when asked for bytes past the size it knows
+ * (and for [ShowFile.length]), so a player follows a recording that
+ * another handle is still appending to.
+ */
+@OptIn(ExperimentalForeignApi::class)
+actual fun openShowFile(path: String, writable: Boolean): ShowFile {
+    val flags = if (writable) O_RDWR or O_CREAT or O_TRUNC else O_RDONLY
+    val fd = open(path, flags, 0x1A4) // 0644
+    if (fd < 0) throw RuntimeException("Failed to open show file $path: errno=$errno")
+    return IosShowFile(fd, writable)
+}
+
+@OptIn(ExperimentalForeignApi::class)
+private class IosShowFile(private var fd: Int, private val writable: Boolean) : ShowFile {
+
+    /** Guards updates of [size]; reads go through the volatile field. */
+    private val lock = SynchronizedObject()
+
+    @Volatile
+    private var size: Long = statSize()
+
+    override val length: Long get() = if (writable) size else refreshSize()
+
+    override fun append(bytes: ByteArray, offset: Int, length: Int) {
+        if (length == 0) return
+        synchronized(lock) {
+            bytes.usePinned { pinned ->
+                var written = 0
+                while (written < length) {
+                    val n = pwrite(fd, pinned.addressOf(offset + written), (length - written).convert(), size)
+                    if (n < 0) throw RuntimeException("Failed to write show file: errno=$errno")
+                    written += n.toInt()
+                    size += n
+                }
+            }
+        }
+    }
+
+    override fun read(position: Long, into: ByteArray, offset: Int, length: Int): Int {
+        if (length == 0) return 0
+        var known = size
+        if (!writable && position + length > known) known = refreshSize()
+        if (position >= known) return 0
+        val count = minOf(length.toLong(), known - position).toInt()
+        return into.usePinned { pinned ->
+            var read = 0
+            while (read < count) {
+                val n = pread(fd, pinned.addressOf(offset + read), (count - read).convert(), position + read)
+                if (n <= 0) break
+                read += n.toInt()
+            }
+            read
+        }
+    }
+
+    /** Size of the file on disk, which another handle may be appending to; never shrinks. */
+    private fun refreshSize(): Long = synchronized(lock) {
+        maxOf(size, statSize()).also { size = it }
+    }
+
+    private fun statSize(): Long = memScoped {
+        val info = alloc<stat>()
+        if (fstat(fd, info.ptr) != 0) throw RuntimeException("Failed to stat show file: errno=$errno")
+        info.st_size
+    }
+
+    override fun flush() {
+        fsync(fd)
+    }
+
+    override fun close() {
+        if (fd >= 0) {
+            platform.posix.close(fd)
+            fd = -1
+        }
+    }
+}
@@ -0,0 +1,152 @@
+package com.chromadmx.networking.transport
+
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.IntVar
+import kotlinx.cinterop.UIntVar
+import kotlinx.cinterop.addressOf
+import kotlinx.cinterop.alloc
+import kotlinx.cinterop.convert
+import kotlinx.cinterop.free
+import kotlinx.cinterop.memScoped
+import kotlinx.cinterop.nativeHeap
+import kotlinx.cinterop.ptr
+import kotlinx.cinterop.reinterpret
+import kotlinx.cinterop.sizeOf
+import kotlinx.cinterop.usePinned
+import kotlinx.cinterop.value
+import kotlin.concurrent.Volatile
+import platform.posix.AF_INET
+import platform.posix.IPPROTO_IP
+import platform.posix.IPPROTO_UDP
+import platform.posix.IP_ADD_MEMBERSHIP
+import platform.posix.SOCK_DGRAM
+import platform.posix.SOL_SOCKET
+import platform.posix.SO_RCVTIMEO
+import platform.posix.SO_REUSEADDR
+import platform.posix.SO_REUSEPORT
+import platform.posix.bind
+import platform.posix.errno
+import platform.posix.ip_mreq
+import platform.posix.recvfrom
+import platform.posix.setsockopt
+import platform.posix.sockaddr_in
+import platform.posix.socket
+import platform.posix.timeval
+
+/**
+ * iOS actual using a POSIX UDP socket bound to the wildcard address.
+ *
+ * The sender address buffer is allocated once on the native heap, so a
+ * receive is one `recvfrom` with no Kotlin or native allocation.
+ */
+@OptIn(ExperimentalForeignApi::class)
+actual class PlatformUdpReceiver actual constructor(port: Int) {
+
+    /** File descriptor for the bound socket, or -1 if closed. */
+    @Volatile
+    private var fd: Int = -1
+
+    private val sender = nativeHeap.alloc<sockaddr_in>()
+    private val senderLength = nativeHeap.alloc<UIntVar>()
+    private var timeoutMs = -1
+
+    init {
+        fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP)
+        if (fd < 0) {
+            throw RuntimeException("Failed to create UDP socket: errno=$errno")
+        }
+        setIntOption(SOL_SOCKET, SO_REUSEADDR, 1)
+        setIntOption(SOL_SOCKET, SO_REUSEPORT, 1)
+        val bound = memScoped {
+            val addr = alloc<sockaddr_in>()
+            addr.sin_family = AF_INET.convert()
+            addr.sin_port = swapShort(port).convert()
+            addr.sin_addr.s_addr = 0u // INADDR_ANY
+            bind(fd, addr.ptr.reinterpret(), sizeOf<sockaddr_in>().convert())
+        }
+        if (bound != 0) {
+            val error = errno
+            close()
+            throw RuntimeException("Failed to bind UDP port $port: errno=$error")
+        }
+    }
+
+    actual fun joinMulticastGroup(group: String) {
+        memScoped {
+            val request = alloc<ip_mreq>()
+            request.imr_multiaddr.s_addr = toNetworkOrder(UdpDatagram.ipv4ToInt(group))
+            request.imr_interface.s_addr = 0u // INADDR_ANY
+            setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, request.ptr, sizeOf<ip_mreq>().convert())
+        }
+    }
+
+    actual fun receive(into: UdpDatagram, timeoutMs: Int): Boolean {
+        val socketFd = fd
+        if (socketFd < 0) return false
+        if (timeoutMs != this.timeoutMs) {
+            setTimeout(timeoutMs)
+            this.timeoutMs = timeoutMs
+        }
+        senderLength.value = sizeOf<sockaddr_in>().convert()
+        val bytesRead = into.buffer.usePinned { pinned ->
+            recvfrom(
+                socketFd,
+                pinned.addressOf(0),
+                into.buffer.size.convert(),
+                0,
+                sender.ptr.reinterpret(),
+                senderLength.ptr
+            )
+        }
+        // Timeout, error or closed socket
+        if (bytesRead <= 0) return false
+        into.set(
+            length = bytesRead.toInt(),
+            sourceAddress = fromNetworkOrder(sender.sin_addr.s_addr),
+            sourcePort = swapShort(sender.sin_port.toInt())
+        )
+        return true
+    }
+
+    actual val isClosed: Boolean get() = fd < 0
+
+    actual fun close() {
+        val socketFd = fd
+        if (socketFd >= 0) {
+            fd = -1
+            platform.posix.close(socketFd)
+            nativeHeap.free(sender)
+            nativeHeap.free(senderLength)
+        }
+    }
+
+    private fun setTimeout(timeoutMs: Int) {
+        memScoped {
+            val tv = alloc<timeval>()
+            tv.tv_sec = (timeoutMs / 1000).convert()
+            tv.tv_usec = ((timeoutMs % 1000) * 1000).convert()
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, tv.ptr, sizeOf<timeval>().convert())
+        }
+    }
+
+    private fun setIntOption(level: Int, option: Int, value: Int) {
+        memScoped {
+            val optVal = alloc<IntVar>()
+            optVal.value = value
+            setsockopt(fd, level, option, optVal.ptr, sizeOf<IntVar>().convert())
+        }
+    }
+}
+
+/** Byte-swap a 16-bit port; all iOS targets are little-endian. */
+private fun swapShort(value: Int): Int = ((value and 0xFF) shl 8) or ((value shr 8) and 0xFF)
+
+/** [UdpDatagram.ipv4ToInt] form to an `s_addr` in network byte order. */
+private fun toNetworkOrder(address: Int): UInt {
+    val v = address.toUInt()
+    return ((v shr 24) and 0xFFu) or (((v shr 16) and 0xFFu) shl 8) or
+        (((v shr 8) and 0xFFu) shl 16) or ((v and 0xFFu) shl 24)
+}
+
+/** `s_addr` in network byte order to the [UdpDatagram.ipv4ToInt] form. */
+private fun fromNetworkOrder(addr: UInt): Int = toNetworkOrder(addr.toInt()).toInt()
@@ -87,6 +87,43 @@ actual class PlatformUdpTransport actual constructor() {
         }
     }
 
+    actual suspend fun sendBatch(batch: UdpBatch): Int {
+        val socketFd = fd
+        if (socketFd < 0 || batch.size == 0) return 0
+
+        return withContext(Dispatchers.Default) {
+            memScoped {
+                // One sockaddr for the whole frame, rewritten per datagram
+                val addr = alloc<sockaddr_in>()
+                addr.sin_family = AF_INET.convert()
+                var sent = 0
+                for (i in 0 until batch.size) {
+                    val packet = batch.packet(i)
+                    val length = batch.length(i)
+                    addr.sin_port = hostToNetworkShort(batch.port(i).toUShort())
+                    addr.sin_addr.s_addr = ipStringToUInt(batch.address(i))
+
+                    val result = if (length == 0) {
+                        0L
+                    } else {
+                        packet.usePinned { pinned ->
+                            sendto(
+                                socketFd,
+                                pinned.addressOf(0),
+                                length.convert(),
+                                0,
+                                addr.ptr.reinterpret(),
+                                sizeOf<sockaddr_in>().convert()
+                            ).toLong()
+                        }
+                    }
+                    if (result >= 0) sent++
+                }
+                sent
+            }
+        }
+    }
+
     actual suspend fun receive(buffer: ByteArray, timeoutMs: Long): UdpPacket? {
         val socketFd = fd
         if (socketFd < 0) return null
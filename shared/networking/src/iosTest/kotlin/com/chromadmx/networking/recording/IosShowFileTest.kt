@@ -0,0 +1,64 @@
+package com.chromadmx.networking.recording
+
+import platform.Foundation.NSTemporaryDirectory
+import platform.Foundation.NSUUID
+import platform.posix.unlink
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertContentEquals
+import kotlin.test.assertEquals
+
+class IosShowFileTest {
+
+    private val paths = mutableListOf<String>()
+
+    private fun tempPath(): String =
+        (NSTemporaryDirectory() + "show-" + NSUUID().UUIDString + ".cdx").also { paths += it }
+
+    @AfterTest
+    fun deleteFiles() {
+        paths.forEach { unlink(it) }
+    }
+
+    private fun ShowFile.readAt(position: Long, count: Int): ByteArray {
+        val into = ByteArray(count)
+        assertEquals(count, read(position, into, 0, count))
+        return into
+    }
+
+    @Test
+    fun readerFollowsAGrowingFile() {
+        val path = tempPath()
+        val writer = openShowFile(path, writable = true)
+        writer.append(byteArrayOf(1, 2, 3))
+        val reader = openShowFile(path, writable = false)
+        assertEquals(3L, reader.length)
+
+        writer.append(byteArrayOf(4, 5))
+        assertContentEquals(byteArrayOf(3, 4, 5), reader.readAt(2L, 3))
+        assertEquals(5L, reader.length)
+
+        writer.close()
+        reader.close()
+    }
+
+    @Test
+    fun playerFollowsALiveRecording() {
+        val dataPath = tempPath()
+        val indexPath = tempPath()
+        val frame = { level: Int -> mapOf(0 to ByteArray(512) { level.toByte() }) }
+        val recorder = ShowRecorder(openShowFile(dataPath, writable = true), openShowFile(indexPath, writable = true))
+        recorder.record(frame(10), 0L, 0.0)
+
+        val player = ShowPlayer(openShowFile(dataPath, writable = false), openShowFile(indexPath, writable = false))
+        assertEquals(1L, player.barCount)
+        recorder.record(frame(20), 2_000_000L, 4.0)
+        recorder.record(frame(30), 4_000_000L, 8.0)
+
+        assertEquals(3L, player.barCount)
+        assertEquals(30, player.frameAt(8.0).getValue(0)[0].toInt())
+
+        recorder.close()
+        player.close()
+    }
+}
@@ -8,9 +8,9 @@ kotlin {
             api(project(":shared:core"))
             api(project(":shared:networking"))
             api(project(":shared:vision"))
+            implementation(project(":shared:engine"))
         }
         commonTest.dependencies {
-            implementation(project(":shared:engine"))
             implementation(project(":shared:tempo"))
         }
     }
@@ -0,0 +1,177 @@
+package com.chromadmx.simulation.bench
+
+import com.chromadmx.core.model.BeatState
+import com.chromadmx.core.model.BlendMode
+import com.chromadmx.core.telemetry.LatencyHistogram
+import com.chromadmx.engine.bridge.DmxBridge
+import com.chromadmx.engine.effect.EffectLayer
+import com.chromadmx.engine.effects.GradientSweep3DEffect
+import com.chromadmx.engine.effects.PerlinNoise3DEffect
+import com.chromadmx.engine.effects.RadialPulse3DEffect
+import com.chromadmx.engine.pipeline.EffectEngine
+import com.chromadmx.networking.protocol.ArtNetCodec
+import com.chromadmx.networking.protocol.ArtNetConstants
+import com.chromadmx.networking.transport.PlatformUdpTransport
+import com.chromadmx.networking.transport.UdpBatch
+import com.chromadmx.simulation.fixtures.RigPreset
+import com.chromadmx.simulation.fixtures.SimulatedFixtureRig
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlin.time.TimeSource
+
+/**
+ * End-to-end timing of one output frame per rig: render (engine tick),
+ * pack (DMX bridge) and send (Art-Net encode plus, with a [transport],
+ * a loopback datagram batch).
+ *
+ * Frames run back to back on effect time advancing at the requested frame
+ * rate, so a run finishes as fast as the device allows; each stage's
+ * timings go into a [LatencyHistogram] and [Result] compares the p99 of a
+ * whole frame against the frame budget. Use it to size a rig to hardware
+ * before a gig: run it on the device (debug builds, a test) or on desktop.
+ *
+ * The effect stack is a fixed three-layer mix (gradient, noise, pulse) so
+ * numbers are comparable across runs and rigs.
+ *
+ * @param frames    Frames timed per rig and rate, after [warmupFrames].
+ * @param transport Socket for the send stage; null times encoding only.
+ * @param address   Loopback destination of the send stage.
+ */
+class PipelineBenchmark(
+    private val frames: Int = DEFAULT_FRAMES,
+    private val warmupFrames: Int = DEFAULT_WARMUP_FRAMES,
+    private val transport: PlatformUdpTransport? = null,
+    private val address: String = LOOPBACK_ADDRESS
+) {
+    init {
+        require(frames > 0) { "frames must be > 0, got $frames" }
+        require(warmupFrames >= 0) { "warmupFrames must be >= 0, got $warmupFrames" }
+    }
+
+    /** Timings of one rig at one frame rate. */
+    data class Result(
+        val preset: RigPreset,
+        val frameRateHz: Int,
+        val fixtures: Int,
+        val universes: Int,
+        val render: LatencyHistogram.Summary,
+        val pack: LatencyHistogram.Summary,
+        val send: LatencyHistogram.Summary,
+        val frame: LatencyHistogram.Summary,
+        /** Art-Net bytes put on the wire per frame, headers included. */
+        val bytesPerFrame: Int
+    ) {
+        /** Time available per frame at [frameRateHz]. */
+        val budgetMicros: Long get() = MICROS_PER_SECOND / frameRateHz
+
+        /** Whether 99% of frames finished inside the budget. */
+        val fitsBudget: Boolean get() = frame.p99Micros <= budgetMicros
+
+        override fun toString(): String =
+            "$preset @${frameRateHz}Hz ($fixtures fixtures, $universes universes, $bytesPerFrame B/frame) " +
+                "render p99=${render.p99Micros}us pack p99=${pack.p99Micros}us send p99=${send.p99Micros}us " +
+                "frame p99=${frame.p99Micros}us of ${budgetMicros}us${if (fitsBudget) "" else " OVER BUDGET"}"
+    }
+
+    /** Every preset at every rate in [frameRatesHz]. */
+    suspend fun runAll(
+        presets: List<RigPreset> = RigPreset.entries,
+        frameRatesHz: List<Int> = DEFAULT_FRAME_RATES_HZ
+    ): List<Result> = presets.flatMap { preset -> frameRatesHz.map { run(preset, it) } }
+
+    /** Time [frames] frames of [preset] at [frameRateHz]. */
+    suspend fun run(preset: RigPreset, frameRateHz: Int): Result {
+        require(frameRateHz > 0) { "frameRateHz must be > 0, got $frameRateHz" }
+        val fixtures = SimulatedFixtureRig(preset).fixtures
+        // Ticked by hand below; the scope only satisfies the constructor.
+        val engine = EffectEngine(CoroutineScope(Dispatchers.Default), fixtures).apply {
+            effectStack.addLayer(EffectLayer(GradientSweep3DEffect()))
+            effectStack.addLayer(EffectLayer(PerlinNoise3DEffect(), blendMode = BlendMode.MULTIPLY, opacity = 0.7f))
+            effectStack.addLayer(EffectLayer(RadialPulse3DEffect(), blendMode = BlendMode.ADDITIVE, opacity = 0.5f))
+        }
+        val bridge = DmxBridge(fixtures)
+        val packets = HashMap<Int, ByteArray>()
+        val batch = UdpBatch()
+
+        val render = LatencyHistogram()
+        val pack = LatencyHistogram()
+        val send = LatencyHistogram()
+        val frame = LatencyHistogram()
+        var bytesPerFrame = 0
+        var universes = 0
+        var sequence = 0
+
+        val frameMicros = MICROS_PER_SECOND / frameRateHz
+        var timeMicros = 0L
+        engine.beatStateProvider = { beatAt(timeMicros) }
+        for (n in 0 until warmupFrames + frames) {
+            timeMicros = n * frameMicros
+            val timed = n >= warmupFrames
+
+            val start = TimeSource.Monotonic.markNow()
+            engine.tick(timeMicros / MICROS_PER_SECOND.toFloat())
+            val rendered = TimeSource.Monotonic.markNow()
+
+            val colorFrames = engine.colorFrames
+            colorFrames.swapRead()
+            val dmx = bridge.convert(colorFrames.readSlot())
+            val packed = TimeSource.Monotonic.markNow()
+
+            sequence = sequence % 255 + 1
+            batch.clear()
+            var bytes = 0
+            for ((universe, data) in dmx) {
+                val packet = packets.getOrPut(universe) { ByteArray(ArtNetCodec.artDmxSize(data.size)) }
+                val length = ArtNetCodec.encodeArtDmxInto(packet, sequence.toByte(), 0, universe, data)
+                batch.add(packet, length, address, ArtNetConstants.PORT)
+                bytes += length
+            }
+            transport?.sendBatch(batch)
+            val sent = TimeSource.Monotonic.markNow()
+
+            if (timed) {
+                render.record((rendered - start).inWholeMicroseconds)
+                pack.record((packed - rendered).inWholeMicroseconds)
+                send.record((sent - packed).inWholeMicroseconds)
+                frame.record((sent - start).inWholeMicroseconds)
+            }
+            bytesPerFrame = bytes
+            universes = dmx.size
+        }
+
+        return Result(
+            preset = preset,
+            frameRateHz = frameRateHz,
+            fixtures = fixtures.size,
+            universes = universes,
+            render = render.summary(),
+            pack = pack.summary(),
+            send = send.summary(),
+            frame = frame.summary(),
+            bytesPerFrame = bytesPerFrame
+        )
+    }
+
+    companion object {
+        const val DEFAULT_FRAMES: Int = 2_000
+        const val DEFAULT_WARMUP_FRAMES: Int = 200
+        const val LOOPBACK_ADDRESS: String = "127.0.0.1"
+
+        /** DMX output rate, the engine's default rate, and a high-refresh render rate. */
+        val DEFAULT_FRAME_RATES_HZ: List<Int> = listOf(40, 60, 120)
+
+        private const val MICROS_PER_SECOND = 1_000_000L
+        private const val BENCH_BPM = 128f
+
+        /** A running transport at [BENCH_BPM] from time 0. */
+        private fun beatAt(micros: Long): BeatState {
+            val beat = micros / (60_000_000.0 / BENCH_BPM)
+            return BeatState(
+                bpm = BENCH_BPM,
+                beatPhase = (beat % 1.0).toFloat(),
+                barPhase = ((beat % 4.0) / 4.0).toFloat(),
+                elapsed = micros / MICROS_PER_SECOND.toFloat()
+            )
+        }
+    }
+}
@@ -76,7 +76,7 @@ class E2ESimulationTest {
 
         // Tick the engine (writes to triple buffer)
         engine.tick()
-        val output = engine.colorOutput.read()
+        val output = engine.colorOutput.read().toList()
 
         // Every fixture should be red (non-black)
         assertEquals(rig.fixtureCount, output.size)
@@ -166,7 +166,7 @@ class E2ESimulationTest {
         engine.tick()
 
         // Read from triple buffer should yield the blue frame
-        val output = engine.colorOutput.read()
+        val output = engine.colorOutput.read().toList()
         for (color in output) {
             assertEquals(0.0f, color.r, 0.001f)
             assertEquals(0.0f, color.g, 0.001f)
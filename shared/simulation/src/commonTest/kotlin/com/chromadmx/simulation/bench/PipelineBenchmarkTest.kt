@@ -0,0 +1,35 @@
+package com.chromadmx.simulation.bench
+
+import com.chromadmx.networking.protocol.ArtNetCodec
+import com.chromadmx.simulation.fixtures.RigPreset
+import com.chromadmx.simulation.fixtures.SimulatedFixtureRig
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+import kotlinx.coroutines.test.runTest
+
+class PipelineBenchmarkTest {
+
+    @Test
+    fun everyRigRunsAtEveryRate() = runTest {
+        val results = PipelineBenchmark(frames = 20, warmupFrames = 2).runAll()
+
+        assertEquals(RigPreset.entries.size * PipelineBenchmark.DEFAULT_FRAME_RATES_HZ.size, results.size)
+        for (result in results) {
+            assertEquals(20L, result.frame.count, "$result")
+            assertEquals(20L, result.render.count)
+            assertTrue(result.frame.maxMicros >= result.render.maxMicros, "$result")
+        }
+    }
+
+    @Test
+    fun reportsWireBytesPerUniverse() = runTest {
+        val rig = SimulatedFixtureRig(RigPreset.TRUSS_RIG)
+        val result = PipelineBenchmark(frames = 5, warmupFrames = 0).run(RigPreset.TRUSS_RIG, 40)
+
+        assertEquals(rig.fixtureCount, result.fixtures)
+        assertEquals(rig.universeCount, result.universes)
+        assertEquals(rig.universeCount * ArtNetCodec.artDmxSize(512), result.bytesPerFrame)
+        assertEquals(25_000L, result.budgetMicros)
+    }
+}
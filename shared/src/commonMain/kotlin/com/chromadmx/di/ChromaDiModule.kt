@@ -10,6 +10,7 @@ import com.chromadmx.core.persistence.NetworkStateStore
 import com.chromadmx.core.persistence.PresetRepository
 import com.chromadmx.core.persistence.SettingsRepository
 import com.chromadmx.core.persistence.SettingsStore
+import com.chromadmx.core.telemetry.PerformanceTelemetry
 import com.chromadmx.engine.bridge.DmxBridge
 import com.chromadmx.engine.bridge.DmxOutputBridge
 import com.chromadmx.engine.effect.EffectRegistry
@@ -61,13 +62,16 @@ val chromaDiModule = module {
     // --- Coroutine scope ---
     single { CoroutineScope(SupervisorJob() + Dispatchers.Default) }
 
+    // --- Telemetry ---
+    single { PerformanceTelemetry() }
+
     // --- Tempo ---
     single<BeatClock> { TapTempoClock(scope = get()) }
 
     // --- Networking: Real ---
     single { PlatformUdpTransport() }
     single { NodeDiscovery(transport = get()) }
-    single { DmxOutputService(transport = get()) }
+    single { DmxOutputService(transport = get(), telemetry = get()) }
     single(named("real")) { get<DmxOutputService>() } bind DmxTransport::class
 
     // --- Networking: Simulated ---
@@ -106,8 +110,9 @@ val chromaDiModule = module {
         }
     }
     single {
-        EffectEngine(scope = get()).apply {
-            beatStateProvider = { get<BeatClock>().beatState.value }
+        val beatClock = get<BeatClock>()
+        EffectEngine(scope = get(), telemetry = get()).apply {
+            beatStateProvider = { beatClock.sampleBeatState() }
             start()
         }
     }
@@ -126,7 +131,8 @@ val chromaDiModule = module {
             colorOutputProvider = { engine.colorOutput },
             dmxBridge = bridge,
             onFrame = { frame -> router.updateFrame(frame) },
-            scope = get()
+            scope = get(),
+            colorFramesProvider = { engine.colorFrames }
         ).apply { start() }
     }
 
@@ -146,4 +152,20 @@ val chromaDiModule = module {
 
     // --- Fixture provider (empty default — StageViewModelV2 manages fixtures) ---
     single<() -> List<Fixture3D>> { { emptyList() } }
+
+    // --- Deliberately not registered ---
+    // OfflineRenderer / VirtualLinkSession: preset regression tooling. An
+    // offline render needs an engine whose own loop is stopped, so it never
+    // shares the live EffectEngine above; tests build their own.
+    // ShowRecorder / RecordingDmxTransport and ShowPlayer / ShowPlayback:
+    // each show opens its own files and is started by the user, and no
+    // screen does that yet. They wrap the DmxTransportRouter when added.
+    // DmxReceiver / MergingDmxTransport: opt-in, since receiving binds port
+    // 6454 and the sACN groups and merging changes what we send. Wrap the
+    // "real" DmxOutputService with them once a setting can turn merging on.
+    // RenderShardController: needs a Link session and a device index/count,
+    // neither of which this graph has (tempo is TapTempoClock). When added,
+    // pass its dmxBridge() as the DmxOutputBridge's dmxBridgeProvider.
+    // PipelineBenchmark (simulation): sizing tool with its own engine and
+    // loopback socket, run from PipelineBenchmarkTest, never in the app.
 }
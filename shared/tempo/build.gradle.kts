@@ -3,6 +3,7 @@ plugins {
 }
 
 val useStubs = findProperty("chromadmx.linkkit.stubs")?.toString()?.toBoolean() ?: false
+val traceNative = findProperty("chromadmx.trace")?.toString()?.toBoolean() ?: false
 
 kotlin {
     listOf(
@@ -18,6 +19,8 @@ kotlin {
                     file("src/nativeInterop/cinterop/ableton_link.def")
                 }
                 includeDirs("src/nativeInterop/cinterop/headers")
+                // os_signpost intervals in ABLLinkTrace.h
+                if (traceNative) compilerOpts("-DCHROMADMX_TRACE=1")
             }
         }
     }
@@ -0,0 +1,207 @@
+/**
+ * link_bench.cpp — Headless latency benchmark for the Link JNI bridge.
+ *
+ * ## Purpose
+ *
+ * Measures what one read of the Link session costs on a real device, so the
+ * poll rate can be chosen from numbers and regressions show up when the Link
+ * SDK is bumped. Each case is timed per call and reported as p50/p99/p99.9
+ * in nanoseconds, together with heap allocations per call (counted by the
+ * global operator new below).
+ *
+ * Cases:
+ * - Clocks: CLOCK_MONOTONIC and (with the SDK) `link.clock().micros()`.
+ * - Link SDK: `captureAppSessionState()` and `beatAtTime()`.
+ * - Every LinkSession native (link_jni.h) that does not need a JNIEnv,
+ *   called directly — the JNI transition itself is not included, this is
+ *   the native body only, handle validation included.
+ * - The same reads on a destroyed (stale) handle, i.e. the rejection path.
+ * - The shared-timeline seqlock read Kotlin performs, while the publisher
+ *   thread is live.
+ *
+ * ## Running
+ *
+ * Configure with `-DCHROMADMX_LINK_BENCH=ON`, then on a device:
+ *
+ *     adb push link_bench /data/local/tmp/
+ *     adb shell /data/local/tmp/link_bench [iterations]
+ *
+ * Link SDK cases are compiled only when CHROMADMX_HAVE_LINK is defined
+ * (CMakeLists.txt sets it, since the benchmark links the fetched SDK).
+ */
+
+#include <jni.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "link_jni.h"
+#include "session_registry.h"
+#include "shared_timeline.h"
+
+#ifdef CHROMADMX_HAVE_LINK
+#include <ableton/Link.hpp>
+#endif
+
+// ---- Allocation counting ----
+
+namespace {
+std::atomic<uint64_t> gAllocations{0};
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// ---- LinkSession natives under test (link_jni.h) ----
+
+using namespace chromadmx::jni;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kDefaultIterations = 100000;
+constexpr int kWarmupIterations = 1000;
+
+/** Defeats dead-code elimination of benchmarked results. */
+volatile double gSink = 0.0;
+
+/**
+ * Time [body] [iterations] times and print one result row.
+ *
+ * Each call is timed individually so tail latency (scheduler preemption,
+ * lock contention inside Link) is visible, not averaged away.
+ */
+template <typename Body>
+void bench(const char* name, int iterations, Body body) {
+    for (int i = 0; i < kWarmupIterations; ++i) gSink = gSink + body();
+
+    std::vector<int64_t> samples(static_cast<std::size_t>(iterations));
+    uint64_t allocationsBefore = gAllocations.load(std::memory_order_relaxed);
+    for (int i = 0; i < iterations; ++i) {
+        auto start = Clock::now();
+        gSink = gSink + body();
+        auto end = Clock::now();
+        samples[static_cast<std::size_t>(i)] =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+    uint64_t allocations = gAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        auto index = static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1));
+        return static_cast<long long>(samples[index]);
+    };
+    std::printf("%-32s %10lld %10lld %10lld %12.3f\n", name,
+                percentile(0.50), percentile(0.99), percentile(0.999),
+                static_cast<double>(allocations) / iterations);
+}
+
+/** The read LinkSharedTimeline.read() performs, minus the ByteBuffer. */
+double readSharedTimeline(const chromadmx::SharedTimeline& timeline) {
+    for (;;) {
+        uint64_t before = timeline.sequence.load(std::memory_order_acquire);
+        if (before & 1U) continue;
+        chromadmx::SharedTimeline copy;
+        std::memcpy(static_cast<void*>(&copy), &timeline, sizeof(copy));
+        if (timeline.sequence.load(std::memory_order_acquire) != before) continue;
+        if (chromadmx::timelineChecksum(copy, before) != copy.checksum) continue;
+        return copy.beatOrigin + copy.tempo;
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : kDefaultIterations;
+    if (iterations <= 0) iterations = kDefaultIterations;
+
+    std::printf("%-32s %10s %10s %10s %12s\n", "case (ns)", "p50", "p99", "p99.9", "allocs/call");
+
+    // ---- Clocks ----
+    bench("monotonicMicros", iterations, [] {
+        return static_cast<double>(chromadmx::monotonicMicros());
+    });
+
+#ifdef CHROMADMX_HAVE_LINK
+    // ---- Link SDK ----
+    ableton::Link link(120.0);
+    link.enable(true);
+    bench("clock().micros", iterations, [&link] {
+        return static_cast<double>(link.clock().micros().count());
+    });
+    bench("captureAppSessionState", iterations, [&link] {
+        return link.captureAppSessionState().tempo();
+    });
+    auto state = link.captureAppSessionState();
+    bench("beatAtTime", iterations, [&link, &state] {
+        return state.beatAtTime(link.clock().micros(), 4.0);
+    });
+    link.enable(false);
+#endif
+
+    // ---- LinkSession natives ----
+    JNIEnv* env = nullptr;
+    jobject thiz = nullptr;
+    jlong session = nativeCreate(env, thiz, 120.0);
+    nativeSetEnabled(env, thiz, session, JNI_TRUE);
+
+    bench("nativeIsEnabled", iterations, [=] {
+        return static_cast<double>(nativeIsEnabled(session));
+    });
+    bench("nativeCaptureBpm", iterations, [=] {
+        return nativeCaptureBpm(session);
+    });
+    bench("nativeCaptureBeatPhase", iterations, [=] {
+        return nativeCaptureBeatPhase(session, 1.0);
+    });
+    bench("nativeCaptureBarPhase", iterations, [=] {
+        return nativeCaptureBarPhase(session, 4.0);
+    });
+    bench("nativeNumPeers", iterations, [=] {
+        return static_cast<double>(nativeNumPeers(session));
+    });
+    bench("nativeBeatAtTime", iterations, [=] {
+        return nativeBeatAtTime(session, chromadmx::monotonicMicros(), 4.0);
+    });
+    bench("nativeTimeAtBeat", iterations, [=] {
+        return static_cast<double>(nativeTimeAtBeat(session, 16.0, 4.0));
+    });
+
+    // ---- Shared timeline (publisher thread running) ----
+    nativeTimelineCreate(env, thiz, session, 4.0);
+    const chromadmx::SharedTimeline& timeline = *chromadmx::sessionTimeline(session);
+    bench("sharedTimeline read", iterations, [&timeline] {
+        return readSharedTimeline(timeline);
+    });
+    bench("sharedTimeline read + wake", std::max(1, iterations / 10), [session, &timeline] {
+        chromadmx::wakePublisher(session);
+        return readSharedTimeline(timeline);
+    });
+    nativeTimelineDestroy(env, thiz, session);
+
+    nativeSetEnabled(env, thiz, session, JNI_FALSE);
+    nativeDestroy(env, thiz, session);
+
+    // ---- Stale handle ----
+    bench("nativeCaptureBpm (stale)", iterations, [=] {
+        return nativeCaptureBpm(session);
+    });
+    bench("nativeCaptureBarPhase (stale)", iterations, [=] {
+        return nativeCaptureBarPhase(session, 4.0);
+    });
+    return 0;
+}
@@ -4,18 +4,19 @@
  * ## Architecture
  *
  * This file provides the native implementations for the JNI methods declared
- * in LinkSession.android.kt. Each function receives an opaque pointer (jlong)
- * that represents the native ableton::Link instance.
+ * in LinkSession.android.kt. Each function receives an opaque handle (jlong)
+ * naming a native ableton::Link instance in the session registry
+ * (session_registry.h).
  *
- * ## Integration Steps
+ * JNI_OnLoad binds every method with one RegisterNatives call and caches
+ * the LinkSession class and callback method IDs (session_hooks.h), so no
+ * symbol is resolved by name at call time and only JNI_OnLoad is exported.
+ * The hot per-frame reads are @CriticalNative; see link_jni.h.
  *
- * When integrating the real Ableton Link SDK:
+ * ## Build
  *
- * 1. Clone Link SDK: `git clone https://github.com/Ableton/link.git link_sdk`
- * 2. Uncomment the `#include <ableton/Link.hpp>` and all TODO blocks below.
- * 3. Replace the stub return values with actual Link API calls.
- * 4. Uncomment the AbletonLink target in CMakeLists.txt.
- * 5. Build with NDK — the library will be packaged into the APK automatically.
+ * CMakeLists.txt fetches the Link SDK at a pinned tag and builds this file
+ * into libableton_link_jni.so for every app ABI; see that file for flags.
  *
  * ## Threading
  *
@@ -25,112 +26,202 @@
  *
  * ## Memory Management
  *
- * - nativeCreate() allocates a Link instance on the heap, returns its address as jlong.
- * - nativeDestroy() deletes the instance. Must be called when the session is discarded.
- * - All other methods dereference the pointer — caller must ensure it's valid.
+ * - nativeCreate() allocates a Link instance in a registry slot and returns a
+ *   generation-tagged handle, or 0 when every slot is taken.
+ * - nativeDestroy() invalidates the handle, waits for in-flight calls on it,
+ *   then deletes the instance. Must be called when the session is discarded.
+ * - Every other method validates the handle through a SessionRef. A stale or
+ *   zero handle never dereferences freed memory: it returns the idle values
+ *   of a disabled session (kIdleBpm, zero phase, no peers) or does nothing.
+ * - nativeTimelineCreate() starts a TimelinePublisher owned by the session's
+ *   registry slot and addressed by the session handle, like the Link
+ *   instance; nativeTimelineDestroy() and nativeDestroy() each delete it at
+ *   most once. The struct it publishes lives in the registry slot for the
+ *   whole process, so the ByteBuffer Kotlin reads never outlives its memory.
+ *
+ * ## Callbacks
+ *
+ * nativeCreate() registers the Link peer, tempo and start/stop callbacks once.
+ * They land in the session's SessionHooks (session_hooks.h), which wakes the
+ * timeline publisher and — after nativeSetListener() — calls back into the
+ * Kotlin LinkSession from a Link thread attached to the JVM once.
+ *
+ * ## Tracing
+ *
+ * Every native and the publisher's capture open a CHROMADMX_TRACE_SECTION
+ * named after the function (trace.h); compiled out unless CHROMADMX_TRACE
+ * is defined.
  */
 
 #include <jni.h>
+#include <chrono>
 #include <cmath>
-// TODO: Uncomment when Link SDK is available:
-// #include <ableton/Link.hpp>
-
-// TODO: Uncomment when Link SDK is available:
-// namespace {
-// /**
-//  * Common helper for computing normalized phase from the Link timeline.
-//  *
-//  * Captures the app session state, reads the current beat position, and
-//  * normalizes it into [0, 1) relative to the given quantum.
-//  *
-//  * @param link    Pointer to the ableton::Link instance.
-//  * @param quantum Number of beats per phase cycle (1.0 for beat, 4.0 for bar).
-//  * @return Phase in [0.0, 1.0).
-//  */
-// double calculatePhase(ableton::Link* link, double quantum) {
-//     auto state = link->captureAppSessionState();
-//     auto hostTime = link->clock().micros();
-//     double beats = state.beatAtTime(hostTime, quantum);
-//     double phase = std::fmod(beats, quantum);
-//     if (phase < 0.0) phase += quantum;
-//     return phase / quantum;
-// }
-// } // anonymous namespace
-
-// JNI function naming: Java_<package>_<class>_<method>
-// Package: com.chromadmx.tempo.link
-// Class:   LinkSession
+#include <cstdint>
+#include <memory>
+#include "link_jni.h"
+#include "session_hooks.h"
+#include "session_registry.h"
+#include "shared_timeline.h"
+#include "trace.h"
+#include <ableton/Link.hpp>
 
-extern "C" {
+namespace {
+using chromadmx::SessionRef;
+
+/** Tempo reported for a stale handle; matches LinkSession's fallback tempo. */
+constexpr double kIdleBpm = 120.0;
+
+/**
+ * Slot layout of the jdoubleArray filled by nativeCaptureSnapshot().
+ *
+ * Must stay in sync with the SNAPSHOT_* constants in LinkSession.android.kt.
+ */
+enum SnapshotSlot : jsize {
+    kSnapshotTempo = 0,
+    kSnapshotBeat,
+    kSnapshotBeatPhase,
+    kSnapshotBarPhase,
+    kSnapshotNumPeers,
+    kSnapshotHostMicros,
+    kSnapshotIsPlaying,
+    kSnapshotPlayStateMicros,
+    kSnapshotStartStopSync,
+    kSnapshotSize
+};
+
+/**
+ * Normalize a timeline beat position into [0, 1) relative to [quantum].
+ */
+inline double normalizePhase(double beats, double quantum) {
+    double phase = std::fmod(beats, quantum);
+    if (phase < 0.0) phase += quantum;
+    return phase / quantum;
+}
+
+/**
+ * Sample the session for the shared timeline publisher.
+ *
+ * The monotonic clock is sampled on both sides of the Link clock read and
+ * averaged, so the two origins describe the same instant to within a few
+ * hundred nanoseconds.
+ *
+ * A stale handle yields an idle reading anchored at the current time.
+ *
+ * @param handle  Session handle from nativeCreate().
+ * @param quantum Quantum the anchor beat is computed with.
+ */
+chromadmx::AnchorReading captureAnchor(jlong handle, double quantum) {
+    CHROMADMX_TRACE_SECTION("captureAnchor");
+    chromadmx::AnchorReading reading{};
+    SessionRef link(handle);
+    if (!link) {
+        reading.tempo = kIdleBpm;
+        reading.monotonicMicros = chromadmx::monotonicMicros();
+        return reading;
+    }
+    auto state = link->captureAppSessionState();
+    int64_t before = chromadmx::monotonicMicros();
+    auto hostTime = link->clock().micros();
+    int64_t after = chromadmx::monotonicMicros();
+    reading.tempo = state.tempo();
+    reading.beat = state.beatAtTime(hostTime, quantum);
+    reading.hostMicros = hostTime.count();
+    reading.monotonicMicros = before + (after - before) / 2;
+    reading.numPeers = static_cast<int32_t>(link->numPeers());
+    reading.flags = (state.isPlaying() ? chromadmx::kTimelinePlaying : 0U)
+                  | (link->isStartStopSyncEnabled() ? chromadmx::kTimelineStartStopSync : 0U);
+    return reading;
+}
+
+/**
+ * Common helper for computing normalized phase from the Link timeline.
+ *
+ * Captures the app session state, reads the current beat position, and
+ * normalizes it into [0, 1) relative to the given quantum.
+ *
+ * @param link    Validated session.
+ * @param quantum Number of beats per phase cycle (1.0 for beat, 4.0 for bar).
+ * @return Phase in [0.0, 1.0).
+ */
+double calculatePhase(const SessionRef& link, double quantum) {
+    auto state = link->captureAppSessionState();
+    auto hostTime = link->clock().micros();
+    double beats = state.beatAtTime(hostTime, quantum);
+    return normalizePhase(beats, quantum);
+}
+} // anonymous namespace
+
+// Native methods of com.chromadmx.tempo.link.LinkSession, bound by
+// JNI_OnLoad below. Functions without JNIEnv/jclass parameters back
+// @CriticalNative declarations; see kNativeMethods.
+
+namespace chromadmx::jni {
 
 /**
  * Create a new Ableton Link session at the given initial tempo.
  *
  * @param initialBpm Initial tempo in BPM (typically 120.0).
- * @return Opaque pointer to the native Link instance (cast to jlong).
+ * @return Session handle, or 0 if kMaxSessions sessions are already live.
  */
-JNIEXPORT jlong JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeCreate(
+jlong nativeCreate(
     JNIEnv* /*env*/, jobject /*thiz*/, jdouble initialBpm)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = new ableton::Link(initialBpm);
-    // return reinterpret_cast<jlong>(link);
+    CHROMADMX_TRACE_SECTION("nativeCreate");
+    jlong handle = chromadmx::createSession(initialBpm);
+    SessionRef link(handle);
+    if (!link) return 0;
 
-    (void)initialBpm;
-    return 0L; // Stub: no native instance
+    auto hooks = chromadmx::SessionHooks::forSession(handle);
+    link->setNumPeersCallback([hooks](std::size_t numPeers) { hooks->onNumPeers(numPeers); });
+    link->setTempoCallback([hooks](double bpm) { hooks->onTempo(bpm); });
+    link->setStartStopCallback([hooks](bool isPlaying) { hooks->onStartStop(isPlaying); });
+    return handle;
 }
 
 /**
  * Destroy the native Link instance and free resources.
  *
- * @param ptr Opaque pointer from nativeCreate().
+ * Safe to call twice or concurrently with other natives on the same
+ * handle; only the first call destroys anything.
+ *
+ * @param handle Session handle from nativeCreate().
  */
-JNIEXPORT void JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeDestroy(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr)
+void nativeDestroy(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // delete link;
-
-    (void)ptr;
+    CHROMADMX_TRACE_SECTION("nativeDestroy");
+    // Deleting the instance unregisters the callbacks before the hooks go away.
+    if (chromadmx::destroySession(handle)) chromadmx::SessionHooks::remove(handle);
 }
 
 /**
  * Enable or disable the Link session (joins/leaves the network mesh).
  *
- * @param ptr     Opaque pointer from nativeCreate().
+ * @param handle  Session handle from nativeCreate().
  * @param enabled True to join the mesh, false to leave.
  */
-JNIEXPORT void JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeSetEnabled(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr, jboolean enabled)
+void nativeSetEnabled(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle, jboolean enabled)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // link->enable(enabled);
-
-    (void)ptr;
-    (void)enabled;
+    CHROMADMX_TRACE_SECTION("nativeSetEnabled");
+    SessionRef link(handle);
+    if (!link) return;
+    link->enable(enabled == JNI_TRUE);
+    // A disabled session has nothing to sample; its publisher sleeps until woken.
+    chromadmx::setPublisherActive(handle, enabled == JNI_TRUE);
 }
 
 /**
  * Check if the Link session is currently enabled.
  *
- * @param ptr Opaque pointer from nativeCreate().
+ * @param handle Session handle from nativeCreate().
  * @return True if the session is active.
  */
-JNIEXPORT jboolean JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeIsEnabled(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr)
+jboolean nativeIsEnabled(jlong handle)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // return static_cast<jboolean>(link->isEnabled());
-
-    (void)ptr;
-    return JNI_FALSE; // Stub
+    CHROMADMX_TRACE_SECTION("nativeIsEnabled");
+    SessionRef link(handle);
+    return static_cast<jboolean>(link && link->isEnabled() ? JNI_TRUE : JNI_FALSE);
 }
 
 /**
@@ -138,20 +229,16 @@ Java_com_chromadmx_tempo_link_LinkSession_nativeIsEnabled(
  *
  * Uses captureAppSessionState() for non-audio-thread access.
  *
- * @param ptr Opaque pointer from nativeCreate().
+ * @param handle Session handle from nativeCreate().
  * @return Current tempo in BPM.
  */
-JNIEXPORT jdouble JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBpm(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr)
+jdouble nativeCaptureBpm(jlong handle)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // auto state = link->captureAppSessionState();
-    // return state.tempo();
-
-    (void)ptr;
-    return 120.0; // Stub: default BPM
+    CHROMADMX_TRACE_SECTION("nativeCaptureBpm");
+    SessionRef link(handle);
+    if (!link) return kIdleBpm;
+    auto state = link->captureAppSessionState();
+    return state.tempo();
 }
 
 /**
@@ -159,80 +246,351 @@ Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBpm(
  *
  * Phase is computed as: beats % quantum / quantum, giving a value in [0, 1).
  *
- * @param ptr     Opaque pointer from nativeCreate().
+ * @param handle  Session handle from nativeCreate().
  * @param quantum The quantum for phase calculation (1.0 for beat phase).
  * @return Phase value in [0.0, 1.0).
  */
-JNIEXPORT jdouble JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBeatPhase(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr, jdouble quantum)
+jdouble nativeCaptureBeatPhase(jlong handle, jdouble quantum)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // return calculatePhase(link, quantum);
-
-    (void)ptr;
-    (void)quantum;
-    return 0.0; // Stub
+    CHROMADMX_TRACE_SECTION("nativeCaptureBeatPhase");
+    SessionRef link(handle);
+    return link ? calculatePhase(link, quantum) : 0.0;
 }
 
 /**
  * Capture the current bar phase from the Link timeline.
  *
- * @param ptr     Opaque pointer from nativeCreate().
+ * @param handle  Session handle from nativeCreate().
  * @param quantum The quantum for phase calculation (4.0 for bar phase in 4/4).
  * @return Phase value in [0.0, 1.0).
  */
-JNIEXPORT jdouble JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBarPhase(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr, jdouble quantum)
+jdouble nativeCaptureBarPhase(jlong handle, jdouble quantum)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // return calculatePhase(link, quantum);
+    CHROMADMX_TRACE_SECTION("nativeCaptureBarPhase");
+    SessionRef link(handle);
+    return link ? calculatePhase(link, quantum) : 0.0;
+}
 
-    (void)ptr;
-    (void)quantum;
-    return 0.0; // Stub
+/**
+ * Capture tempo, beat position, beat/bar phase, peer count, host time and
+ * transport state in one call.
+ *
+ * The session state is captured once and evaluated at a single host time,
+ * so a Kotlin poll costs one JNI transition and every value is consistent.
+ * Results are written into the caller-owned [out] array using the
+ * SnapshotSlot layout; the array must hold at least kSnapshotSize elements.
+ * A stale handle writes an idle snapshot (kIdleBpm, everything else zero).
+ *
+ * kSnapshotPlayStateMicros is the time of the last transport start/stop on
+ * the CLOCK_MONOTONIC (System.nanoTime) clock, unlike kSnapshotHostMicros,
+ * which is on the Link clock.
+ *
+ * @param handle  Session handle from nativeCreate().
+ * @param quantum Bar quantum (4.0 in 4/4); beat phase always uses 1.0.
+ * @param out     double[kSnapshotSize] receiving the snapshot.
+ */
+void nativeCaptureSnapshot(
+    JNIEnv* env, jobject /*thiz*/, jlong handle, jdouble quantum, jdoubleArray out)
+{
+    CHROMADMX_TRACE_SECTION("nativeCaptureSnapshot");
+    if (out == nullptr || env->GetArrayLength(out) < kSnapshotSize) return;
+
+    jdouble values[kSnapshotSize] = {};
+
+    SessionRef link(handle);
+    if (!link) {
+        values[kSnapshotTempo] = kIdleBpm;
+        env->SetDoubleArrayRegion(out, 0, kSnapshotSize, values);
+        return;
+    }
+    auto state = link->captureAppSessionState();
+    auto hostTime = link->clock().micros();
+    double beats = state.beatAtTime(hostTime, quantum);
+    values[kSnapshotTempo] = state.tempo();
+    values[kSnapshotBeat] = beats;
+    values[kSnapshotBeatPhase] = normalizePhase(beats, 1.0);
+    values[kSnapshotBarPhase] = normalizePhase(beats, quantum);
+    values[kSnapshotNumPeers] = static_cast<jdouble>(link->numPeers());
+    values[kSnapshotHostMicros] = static_cast<jdouble>(hostTime.count());
+    auto offset = hostTime.count() - chromadmx::monotonicMicros();
+    values[kSnapshotIsPlaying] = state.isPlaying() ? 1.0 : 0.0;
+    values[kSnapshotPlayStateMicros] = static_cast<jdouble>(state.timeForIsPlaying().count() - offset);
+    values[kSnapshotStartStopSync] = link->isStartStopSyncEnabled() ? 1.0 : 0.0;
+
+    env->SetDoubleArrayRegion(out, 0, kSnapshotSize, values);
 }
 
 /**
  * Return the number of peers currently connected to this Link session.
  *
- * @param ptr Opaque pointer from nativeCreate().
+ * @param handle Session handle from nativeCreate().
  * @return Number of connected peers (0 if none).
  */
-JNIEXPORT jint JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeNumPeers(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr)
+jint nativeNumPeers(jlong handle)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // return static_cast<jint>(link->numPeers());
-
-    (void)ptr;
-    return 0; // Stub
+    CHROMADMX_TRACE_SECTION("nativeNumPeers");
+    SessionRef link(handle);
+    return link ? static_cast<jint>(link->numPeers()) : 0;
 }
 
 /**
  * Request a tempo change that will be propagated to all peers.
  *
- * @param ptr Opaque pointer from nativeCreate().
+ * @param handle Session handle from nativeCreate().
  * @param bpm Desired tempo in BPM.
  */
-JNIEXPORT void JNICALL
-Java_com_chromadmx_tempo_link_LinkSession_nativeRequestBpm(
-    JNIEnv* /*env*/, jobject /*thiz*/, jlong ptr, jdouble bpm)
+void nativeRequestBpm(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle, jdouble bpm)
+{
+    CHROMADMX_TRACE_SECTION("nativeRequestBpm");
+    SessionRef link(handle);
+    if (!link) return;
+    auto state = link->captureAppSessionState();
+    auto hostTime = link->clock().micros();
+    state.setTempo(bpm, hostTime);
+    link->commitAppSessionState(state);
+}
+
+// ---- Transport ----
+
+/**
+ * Share transport start/stop with peers that have start/stop sync enabled.
+ *
+ * @param handle  Session handle from nativeCreate().
+ * @param enabled True to follow and propagate start/stop.
+ */
+void nativeEnableStartStopSync(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle, jboolean enabled)
+{
+    CHROMADMX_TRACE_SECTION("nativeEnableStartStopSync");
+    SessionRef link(handle);
+    if (link) link->enableStartStopSync(enabled == JNI_TRUE);
+}
+
+/**
+ * Start or stop the transport now.
+ *
+ * Starting also maps beat 0 to the next [quantum] boundary the session
+ * allows (immediately when alone), so the first beat after play is a
+ * downbeat on every peer.
+ *
+ * @param handle    Session handle from nativeCreate().
+ * @param isPlaying True to start, false to stop.
+ * @param quantum   Quantum beat 0 is aligned to (4.0 for bars in 4/4).
+ */
+void nativeSetIsPlaying(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle, jboolean isPlaying, jdouble quantum)
+{
+    CHROMADMX_TRACE_SECTION("nativeSetIsPlaying");
+    SessionRef link(handle);
+    if (!link) return;
+    auto state = link->captureAppSessionState();
+    auto hostTime = link->clock().micros();
+    if (isPlaying == JNI_TRUE) {
+        state.setIsPlayingAndRequestBeatAtTime(true, hostTime, 0.0, quantum);
+    } else {
+        state.setIsPlaying(false, hostTime);
+    }
+    link->commitAppSessionState(state);
+}
+
+// ---- Look-ahead queries ----
+
+/**
+ * Beat position at a (possibly future) time on the System.nanoTime() clock.
+ *
+ * The caller passes e.g. "now + output latency" so a frame can be rendered
+ * for the moment it actually reaches the fixtures. The monotonic time is
+ * mapped onto the Link clock through the current offset between the two.
+ *
+ * @param handle     Session handle from nativeCreate().
+ * @param hostMicros Query time in CLOCK_MONOTONIC microseconds.
+ * @param quantum    Quantum the beat is aligned to.
+ * @return Beat position at that time.
+ */
+jdouble nativeBeatAtTime(jlong handle, jlong hostMicros, jdouble quantum)
+{
+    CHROMADMX_TRACE_SECTION("nativeBeatAtTime");
+    SessionRef link(handle);
+    if (!link) return 0.0;
+    auto state = link->captureAppSessionState();
+    auto offset = link->clock().micros().count() - chromadmx::monotonicMicros();
+    return state.beatAtTime(std::chrono::microseconds(hostMicros + offset), quantum);
+}
+
+/**
+ * Time on the System.nanoTime() clock at which the timeline reaches a beat.
+ *
+ * @param handle  Session handle from nativeCreate().
+ * @param beat    Beat position to look up.
+ * @param quantum Quantum the beat is aligned to.
+ * @return CLOCK_MONOTONIC microseconds of that beat.
+ */
+jlong nativeTimeAtBeat(jlong handle, jdouble beat, jdouble quantum)
 {
-    // TODO: Replace with real Link SDK call:
-    // auto* link = reinterpret_cast<ableton::Link*>(ptr);
-    // auto state = link->captureAppSessionState();
-    // auto hostTime = link->clock().micros();
-    // state.setTempo(bpm, hostTime);
-    // link->commitAppSessionState(state);
+    CHROMADMX_TRACE_SECTION("nativeTimeAtBeat");
+    SessionRef link(handle);
+    if (!link) return 0;
+    auto state = link->captureAppSessionState();
+    auto offset = link->clock().micros().count() - chromadmx::monotonicMicros();
+    return static_cast<jlong>(state.timeAtBeat(beat, quantum).count() - offset);
+}
+
+// ---- Shared-memory timeline ----
+
+/**
+ * Start a publisher thread that mirrors the session timeline into a
+ * seqlock-protected struct (see shared_timeline.h). The publisher belongs
+ * to the session's registry slot; Kotlin never sees a pointer to it.
+ *
+ * @param handle  Session handle from nativeCreate().
+ * @param quantum Quantum for the published beat anchor (4.0 for bars in 4/4).
+ * @return True if the session has a publisher (newly started or already
+ *         running), false for a stale handle.
+ */
+jboolean nativeTimelineCreate(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle, jdouble quantum)
+{
+    CHROMADMX_TRACE_SECTION("nativeTimelineCreate");
+    chromadmx::SharedTimeline* timeline = chromadmx::sessionTimeline(handle);
+    if (timeline == nullptr) return JNI_FALSE;
+    auto publisher = std::make_unique<chromadmx::TimelinePublisher>(
+        timeline, quantum, [handle, quantum] { return captureAnchor(handle, quantum); });
+    // Link callbacks reach it by handle through wakePublisher().
+    if (!chromadmx::attachPublisher(handle, std::move(publisher))) return JNI_FALSE;
+    SessionRef link(handle);
+    chromadmx::setPublisherActive(handle, link && link->isEnabled());
+    return JNI_TRUE;
+}
+
+/**
+ * Wrap the session's shared timeline struct in a direct ByteBuffer.
+ *
+ * The buffer aliases the session's registry slot, which is never freed, so
+ * it stays safe to read after nativeTimelineDestroy() and nativeDestroy();
+ * it just stops being updated.
+ *
+ * @param handle Session handle from nativeCreate().
+ * @return Direct ByteBuffer of sizeof(SharedTimeline) bytes, or null for a stale handle.
+ */
+jobject nativeTimelineBuffer(
+    JNIEnv* env, jobject /*thiz*/, jlong handle)
+{
+    CHROMADMX_TRACE_SECTION("nativeTimelineBuffer");
+    chromadmx::SharedTimeline* timeline = chromadmx::sessionTimeline(handle);
+    if (timeline == nullptr) return nullptr;
+    return env->NewDirectByteBuffer(timeline, sizeof(chromadmx::SharedTimeline));
+}
+
+/**
+ * Stop the publisher thread. The shared struct stays mapped (see
+ * nativeTimelineBuffer()).
+ *
+ * Safe to call twice, on a session without a publisher, or with a stale
+ * handle: the publisher is looked up in the registry, so at most one call
+ * ever deletes it.
+ *
+ * @param handle Session handle the publisher is bound to.
+ */
+void nativeTimelineDestroy(
+    JNIEnv* /*env*/, jobject /*thiz*/, jlong handle)
+{
+    CHROMADMX_TRACE_SECTION("nativeTimelineDestroy");
+    chromadmx::detachPublisher(handle);  // Deleted here
+}
+
+// ---- Push callbacks ----
+
+/**
+ * Route Link peer, tempo and start/stop callbacks to [listener].
+ *
+ * [listener] is the Kotlin LinkSession; it must declare
+ * onNativeNumPeers(I)V, onNativeTempo(D)V and onNativeStartStop(Z)V.
+ * Pass null to stop forwarding (e.g. before close()).
+ *
+ * @param handle   Session handle from nativeCreate().
+ * @param listener LinkSession instance to call back, or null.
+ * @return True if callbacks will be delivered.
+ */
+jboolean nativeSetListener(
+    JNIEnv* env, jobject /*thiz*/, jlong handle, jobject listener)
+{
+    CHROMADMX_TRACE_SECTION("nativeSetListener");
+    SessionRef link(handle);
+    if (!link) return JNI_FALSE;
+    // find(), not forSession(): after nativeDestroy's remove() a racing call
+    // must not re-create the entry and pin a global ref to [listener].
+    auto hooks = chromadmx::SessionHooks::find(handle);
+    if (!hooks) return JNI_FALSE;
+    bool ok = hooks->setListener(env, listener);
+    return static_cast<jboolean>(ok && listener != nullptr ? JNI_TRUE : JNI_FALSE);
+}
+
+} // namespace chromadmx::jni
+
+// ---- Registration ----
+
+namespace {
+
+using namespace chromadmx::jni;
+
+/**
+ * Every LinkSession native, registered in one RegisterNatives call.
+ *
+ * Signatures must match the `external fun` declarations in
+ * LinkSession.android.kt. The @CriticalNative entries are static methods
+ * taking and returning primitives only; ART calls them without a JNIEnv,
+ * without a jclass and without a thread state transition, which is
+ * required for @CriticalNative to take effect (Android 8–11 cannot find
+ * such methods by name at all).
+ */
+const JNINativeMethod kNativeMethods[] = {
+    {"nativeCreate", "(D)J", reinterpret_cast<void*>(nativeCreate)},
+    {"nativeDestroy", "(J)V", reinterpret_cast<void*>(nativeDestroy)},
+    {"nativeSetEnabled", "(JZ)V", reinterpret_cast<void*>(nativeSetEnabled)},
+    {"nativeRequestBpm", "(JD)V", reinterpret_cast<void*>(nativeRequestBpm)},
+    {"nativeEnableStartStopSync", "(JZ)V", reinterpret_cast<void*>(nativeEnableStartStopSync)},
+    {"nativeSetIsPlaying", "(JZD)V", reinterpret_cast<void*>(nativeSetIsPlaying)},
+    {"nativeCaptureSnapshot", "(JD[D)V", reinterpret_cast<void*>(nativeCaptureSnapshot)},  // @FastNative
+    {"nativeTimelineCreate", "(JD)Z", reinterpret_cast<void*>(nativeTimelineCreate)},
+    {"nativeTimelineBuffer", "(J)Ljava/nio/ByteBuffer;", reinterpret_cast<void*>(nativeTimelineBuffer)},
+    {"nativeTimelineDestroy", "(J)V", reinterpret_cast<void*>(nativeTimelineDestroy)},
+    {"nativeSetListener", "(JLjava/lang/Object;)Z", reinterpret_cast<void*>(nativeSetListener)},
+    // @CriticalNative
+    {"nativeIsEnabled", "(J)Z", reinterpret_cast<void*>(nativeIsEnabled)},
+    {"nativeCaptureBpm", "(J)D", reinterpret_cast<void*>(nativeCaptureBpm)},
+    {"nativeCaptureBeatPhase", "(JD)D", reinterpret_cast<void*>(nativeCaptureBeatPhase)},
+    {"nativeCaptureBarPhase", "(JD)D", reinterpret_cast<void*>(nativeCaptureBarPhase)},
+    {"nativeNumPeers", "(J)I", reinterpret_cast<void*>(nativeNumPeers)},
+    {"nativeBeatAtTime", "(JJD)D", reinterpret_cast<void*>(nativeBeatAtTime)},
+    {"nativeTimeAtBeat", "(JDD)J", reinterpret_cast<void*>(nativeTimeAtBeat)},
+};
+
+constexpr const char* kLinkSessionClass = "com/chromadmx/tempo/link/LinkSession";
+
+} // anonymous namespace
+
+extern "C" {
+
+/**
+ * Bind all natives and cache the callback method IDs.
+ *
+ * Runs once, when LinkSession's System.loadLibrary() loads this library,
+ * on a thread whose class loader can see LinkSession.
+ */
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /*reserved*/) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) return JNI_ERR;
+
+    jclass cls = env->FindClass(kLinkSessionClass);
+    if (cls == nullptr) return JNI_ERR;
+
+    constexpr auto count = static_cast<jint>(sizeof(kNativeMethods) / sizeof(kNativeMethods[0]));
+    if (env->RegisterNatives(cls, kNativeMethods, count) != JNI_OK) return JNI_ERR;
+    if (!chromadmx::cacheSessionClass(env, vm, cls)) return JNI_ERR;
 
-    (void)ptr;
-    (void)bpm;
+    env->DeleteLocalRef(cls);
+    return JNI_VERSION_1_6;
 }
 
 } // extern "C"
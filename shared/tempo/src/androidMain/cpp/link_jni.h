@@ -0,0 +1,53 @@
+/**
+ * link_jni.h — Native methods of the Kotlin LinkSession.
+ *
+ * ## Purpose
+ *
+ * Declares the functions link_jni.cpp binds to LinkSession through
+ * RegisterNatives in JNI_OnLoad, so native callers (link_bench) can reach
+ * the same bodies without going through the JVM.
+ *
+ * ## Calling conventions
+ *
+ * Functions taking (JNIEnv*, jobject) back regular or @FastNative instance
+ * methods. Functions taking primitives only back @CriticalNative static
+ * methods: ART passes neither a JNIEnv nor a jclass, so they must not call
+ * into JNI, and they must stay short — the calling thread stays runnable
+ * and holds up GC suspension until they return. The capture calls only take
+ * Link's brief session-state lock.
+ *
+ * Every `handle` is a session_registry.h handle, validated on each call;
+ * stale handles get idle values rather than undefined behaviour.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+namespace chromadmx::jni {
+
+// ---- Regular ----
+jlong nativeCreate(JNIEnv* env, jobject thiz, jdouble initialBpm);
+void nativeDestroy(JNIEnv* env, jobject thiz, jlong handle);
+void nativeSetEnabled(JNIEnv* env, jobject thiz, jlong handle, jboolean enabled);
+void nativeRequestBpm(JNIEnv* env, jobject thiz, jlong handle, jdouble bpm);
+void nativeEnableStartStopSync(JNIEnv* env, jobject thiz, jlong handle, jboolean enabled);
+void nativeSetIsPlaying(JNIEnv* env, jobject thiz, jlong handle, jboolean isPlaying, jdouble quantum);
+jboolean nativeTimelineCreate(JNIEnv* env, jobject thiz, jlong handle, jdouble quantum);
+jobject nativeTimelineBuffer(JNIEnv* env, jobject thiz, jlong handle);
+void nativeTimelineDestroy(JNIEnv* env, jobject thiz, jlong handle);
+jboolean nativeSetListener(JNIEnv* env, jobject thiz, jlong handle, jobject listener);
+
+// ---- @FastNative ----
+void nativeCaptureSnapshot(JNIEnv* env, jobject thiz, jlong handle, jdouble quantum, jdoubleArray out);
+
+// ---- @CriticalNative ----
+jboolean nativeIsEnabled(jlong handle);
+jdouble nativeCaptureBpm(jlong handle);
+jdouble nativeCaptureBeatPhase(jlong handle, jdouble quantum);
+jdouble nativeCaptureBarPhase(jlong handle, jdouble quantum);
+jint nativeNumPeers(jlong handle);
+jdouble nativeBeatAtTime(jlong handle, jlong hostMicros, jdouble quantum);
+jlong nativeTimeAtBeat(jlong handle, jdouble beat, jdouble quantum);
+
+} // namespace chromadmx::jni
@@ -0,0 +1,136 @@
+/**
+ * link_test.cpp — Native tests for the Link JNI bridge.
+ *
+ * ## Purpose
+ *
+ * Covers the session registry and shared-timeline invariants that the
+ * Kotlin tests cannot reach: at most one publisher ever writes a slot's
+ * seqlock, a stale handle never writes into a reused slot, and a listener
+ * set on a destroyed session is never retained. The natives
+ * (link_jni.h) are called directly, as in link_bench.cpp.
+ *
+ * ## Running
+ *
+ * Configure with `-DCHROMADMX_LINK_TESTS=ON`, then `ctest`, or on a device:
+ *
+ *     adb push link_test /data/local/tmp/
+ *     adb shell /data/local/tmp/link_test
+ *
+ * Exits non-zero if any check fails.
+ */
+
+#include <jni.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "link_jni.h"
+#include "session_hooks.h"
+#include "session_registry.h"
+#include "shared_timeline.h"
+
+using namespace chromadmx::jni;
+
+namespace {
+
+int gFailures = 0;
+
+#define CHECK(condition)                                                     \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            ++gFailures;                                                     \
+        }                                                                    \
+    } while (0)
+
+JNIEnv* const env = nullptr;
+jobject const thiz = nullptr;
+
+/** True if [timeline] holds a complete, checksummed publication. */
+bool isConsistent(const chromadmx::SharedTimeline& timeline) {
+    uint64_t sequence = timeline.sequence.load(std::memory_order_acquire);
+    return (sequence & 1U) == 0 && chromadmx::timelineChecksum(timeline, sequence) == timeline.checksum;
+}
+
+void createTwiceKeepsTheFirstPublisher() {
+    jlong session = nativeCreate(env, thiz, 120.0);
+    CHECK(session != 0);
+    const chromadmx::SharedTimeline& timeline = *chromadmx::sessionTimeline(session);
+
+    CHECK(nativeTimelineCreate(env, thiz, session, 4.0) == JNI_TRUE);
+    uint64_t sequence = timeline.sequence.load(std::memory_order_acquire);
+    uint64_t generation = timeline.generation;
+
+    // The second publisher is discarded unstarted: it never writes
+    CHECK(nativeTimelineCreate(env, thiz, session, 4.0) == JNI_TRUE);
+    CHECK(timeline.sequence.load(std::memory_order_acquire) == sequence);
+    CHECK(timeline.generation == generation);
+    CHECK(isConsistent(timeline));
+
+    nativeTimelineDestroy(env, thiz, session);
+    nativeDestroy(env, thiz, session);
+}
+
+void concurrentCreatesLeaveOneWriter() {
+    jlong session = nativeCreate(env, thiz, 120.0);
+    const chromadmx::SharedTimeline& timeline = *chromadmx::sessionTimeline(session);
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 8; ++i) {
+            threads.emplace_back([session] {
+                nativeTimelineCreate(env, thiz, session, 4.0);
+                chromadmx::wakePublisher(session);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        nativeTimelineDestroy(env, thiz, session);
+        CHECK(isConsistent(timeline));
+    }
+
+    nativeDestroy(env, thiz, session);
+}
+
+void staleHandleNeverWrites() {
+    jlong session = nativeCreate(env, thiz, 120.0);
+    const chromadmx::SharedTimeline& timeline = *chromadmx::sessionTimeline(session);
+    nativeDestroy(env, thiz, session);
+    uint64_t sequence = timeline.sequence.load(std::memory_order_acquire);
+
+    CHECK(nativeTimelineCreate(env, thiz, session, 4.0) == JNI_FALSE);
+    CHECK(chromadmx::sessionTimeline(session) == nullptr);
+    CHECK(timeline.sequence.load(std::memory_order_acquire) == sequence);
+    nativeTimelineDestroy(env, thiz, session);  // Stale: a no-op
+}
+
+void listenerAfterDestroyIsDropped() {
+    jlong session = nativeCreate(env, thiz, 120.0);
+    CHECK(chromadmx::SessionHooks::find(session) != nullptr);
+    nativeDestroy(env, thiz, session);
+
+    CHECK(nativeSetListener(env, thiz, session, nullptr) == JNI_FALSE);
+    CHECK(chromadmx::SessionHooks::find(session) == nullptr);
+}
+
+} // anonymous namespace
+
+int main() {
+    struct Case {
+        const char* name;
+        void (*run)();
+    };
+    const Case cases[] = {
+        {"createTwiceKeepsTheFirstPublisher", createTwiceKeepsTheFirstPublisher},
+        {"concurrentCreatesLeaveOneWriter", concurrentCreatesLeaveOneWriter},
+        {"staleHandleNeverWrites", staleHandleNeverWrites},
+        {"listenerAfterDestroyIsDropped", listenerAfterDestroyIsDropped},
+    };
+    for (const Case& test : cases) {
+        int before = gFailures;
+        test.run();
+        std::printf("%s %s\n", gFailures == before ? "PASS" : "FAIL", test.name);
+    }
+    return gFailures == 0 ? 0 : 1;
+}
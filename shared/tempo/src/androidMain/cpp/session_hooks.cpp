@@ -0,0 +1,158 @@
+/**
+ * session_hooks.cpp — Link callback fan-out and JVM thread attachment.
+ *
+ * See session_hooks.h for the threading model.
+ */
+
+#include "session_hooks.h"
+
+#include "session_registry.h"
+
+#include <unordered_map>
+
+namespace chromadmx {
+
+namespace {
+
+/** Detaches the owning thread from the JVM when the thread exits. */
+struct ThreadAttachment {
+    JavaVM* vm = nullptr;
+    JNIEnv* env = nullptr;
+
+    ~ThreadAttachment() {
+        if (vm != nullptr && env != nullptr) vm->DetachCurrentThread();
+    }
+};
+
+thread_local ThreadAttachment attachment;
+
+std::mutex registryMutex;
+std::unordered_map<jlong, std::shared_ptr<SessionHooks>> registry;
+
+/** Written once by cacheSessionClass() before any session exists. */
+struct SessionClassCache {
+    JavaVM* vm = nullptr;
+    jclass cls = nullptr;  // global ref, held for the life of the library
+    jmethodID onNumPeers = nullptr;
+    jmethodID onTempo = nullptr;
+    jmethodID onStartStop = nullptr;
+};
+
+SessionClassCache sessionClass;
+
+} // anonymous namespace
+
+JNIEnv* attachedEnv(JavaVM* vm) {
+    if (vm == nullptr) return nullptr;
+
+    JNIEnv* env = nullptr;
+    // Already attached (a Java thread, or attached by us earlier)?
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) return env;
+
+    JavaVMAttachArgs args{JNI_VERSION_1_6, "LinkCallbacks", nullptr};
+    if (vm->AttachCurrentThreadAsDaemon(&env, &args) != JNI_OK) return nullptr;
+    attachment.vm = vm;
+    attachment.env = env;
+    return env;
+}
+
+bool cacheSessionClass(JNIEnv* env, JavaVM* vm, jclass cls) {
+    jmethodID onNumPeers = env->GetMethodID(cls, "onNativeNumPeers", "(I)V");
+    jmethodID onTempo = env->GetMethodID(cls, "onNativeTempo", "(D)V");
+    jmethodID onStartStop = env->GetMethodID(cls, "onNativeStartStop", "(Z)V");
+    if (onNumPeers == nullptr || onTempo == nullptr || onStartStop == nullptr) {
+        env->ExceptionClear(); // NoSuchMethodError
+        return false;
+    }
+    sessionClass.vm = vm;
+    sessionClass.cls = static_cast<jclass>(env->NewGlobalRef(cls));
+    sessionClass.onNumPeers = onNumPeers;
+    sessionClass.onTempo = onTempo;
+    sessionClass.onStartStop = onStartStop;
+    return true;
+}
+
+std::shared_ptr<SessionHooks> SessionHooks::forSession(jlong sessionPtr) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& hooks = registry[sessionPtr];
+    if (!hooks) {
+        hooks = std::make_shared<SessionHooks>();
+        hooks->session_ = sessionPtr;
+    }
+    return hooks;
+}
+
+std::shared_ptr<SessionHooks> SessionHooks::find(jlong sessionPtr) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(sessionPtr);
+    return it != registry.end() ? it->second : nullptr;
+}
+
+void SessionHooks::remove(jlong sessionPtr) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(sessionPtr);
+}
+
+SessionHooks::~SessionHooks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseListener(attachedEnv(sessionClass.vm));
+}
+
+bool SessionHooks::setListener(JNIEnv* env, jobject target) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseListener(env);
+    if (target == nullptr) return true;
+    if (sessionClass.cls == nullptr) return false;
+
+    target_ = env->NewGlobalRef(target);
+    return true;
+}
+
+void SessionHooks::wakePublisher() const {
+    chromadmx::wakePublisher(session_);
+}
+
+void SessionHooks::releaseListener(JNIEnv* env) {
+    if (target_ != nullptr && env != nullptr) env->DeleteGlobalRef(target_);
+    target_ = nullptr;
+}
+
+jobject SessionHooks::acquireTarget(JNIEnv* env) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return target_ != nullptr ? env->NewLocalRef(target_) : nullptr;
+}
+
+void SessionHooks::onNumPeers(std::size_t numPeers) {
+    wakePublisher();
+    JNIEnv* env = attachedEnv(sessionClass.vm);
+    if (env == nullptr) return;
+    jobject target = acquireTarget(env);
+    if (target == nullptr) return;
+    env->CallVoidMethod(target, sessionClass.onNumPeers, static_cast<jint>(numPeers));
+    if (env->ExceptionCheck()) env->ExceptionClear();
+    env->DeleteLocalRef(target);
+}
+
+void SessionHooks::onTempo(double bpm) {
+    wakePublisher();
+    JNIEnv* env = attachedEnv(sessionClass.vm);
+    if (env == nullptr) return;
+    jobject target = acquireTarget(env);
+    if (target == nullptr) return;
+    env->CallVoidMethod(target, sessionClass.onTempo, static_cast<jdouble>(bpm));
+    if (env->ExceptionCheck()) env->ExceptionClear();
+    env->DeleteLocalRef(target);
+}
+
+void SessionHooks::onStartStop(bool isPlaying) {
+    wakePublisher();
+    JNIEnv* env = attachedEnv(sessionClass.vm);
+    if (env == nullptr) return;
+    jobject target = acquireTarget(env);
+    if (target == nullptr) return;
+    env->CallVoidMethod(target, sessionClass.onStartStop, static_cast<jboolean>(isPlaying ? JNI_TRUE : JNI_FALSE));
+    if (env->ExceptionCheck()) env->ExceptionClear();
+    env->DeleteLocalRef(target);
+}
+
+} // namespace chromadmx
@@ -0,0 +1,94 @@
+/**
+ * session_hooks.h — Fan-out of Ableton Link callbacks to Kotlin and native consumers.
+ *
+ * ## Purpose
+ *
+ * ableton::Link accepts exactly one callback per event (peers, tempo,
+ * start/stop). [SessionHooks] is that single callback target for a session:
+ * it wakes the shared timeline publisher so changes are republished at once,
+ * and forwards the event to the Kotlin LinkSession through cached jmethodIDs.
+ *
+ * ## Threading
+ *
+ * Link invokes callbacks on its own internal thread. That thread is attached
+ * to the JVM once, on first use, and detached automatically when it exits
+ * (see attachedEnv()). A mutex guards the listener, but is held only long
+ * enough to copy it into a local reference: the Java call runs with the lock
+ * released, so a listener that calls back into the session (or a
+ * setListener() from another thread) can never deadlock against it. The
+ * local reference keeps the listener alive even if setListener() releases
+ * the global one mid-call.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace chromadmx {
+
+/**
+ * JNIEnv for the calling thread, attaching it as a daemon thread on first
+ * use. The attachment is released when the thread exits.
+ *
+ * @return The env, or nullptr if the thread could not be attached.
+ */
+JNIEnv* attachedEnv(JavaVM* vm);
+
+/**
+ * Cache the JavaVM, a global reference to the LinkSession class and its
+ * onNative* callback method IDs. Called once from JNI_OnLoad; listeners
+ * registered afterwards reuse the IDs instead of looking them up.
+ *
+ * @return False if a callback method is missing (e.g. stripped by R8).
+ */
+bool cacheSessionClass(JNIEnv* env, JavaVM* vm, jclass sessionClass);
+
+/** Callback target for one native Link session. */
+class SessionHooks {
+public:
+    /** Hooks for [sessionPtr], created on first request. Only nativeCreate should call this. */
+    static std::shared_ptr<SessionHooks> forSession(jlong sessionPtr);
+
+    /** Hooks for [sessionPtr], or nullptr if none were created. */
+    static std::shared_ptr<SessionHooks> find(jlong sessionPtr);
+
+    /** Forget the hooks for [sessionPtr]; in-flight callbacks keep them alive. */
+    static void remove(jlong sessionPtr);
+
+    ~SessionHooks();
+
+    /**
+     * Route events to [target] (a LinkSession instance), or stop routing when
+     * [target] is null. Uses the method IDs cached by cacheSessionClass().
+     *
+     * @return False if the session class was never cached.
+     */
+    bool setListener(JNIEnv* env, jobject target);
+
+    void onNumPeers(std::size_t numPeers);
+    void onTempo(double bpm);
+    void onStartStop(bool isPlaying);
+
+private:
+    void releaseListener(JNIEnv* env);
+
+    /**
+     * Local reference to the current listener, or nullptr. Taken under
+     * [mutex_] so the global ref cannot be released mid-copy; the caller
+     * calls into Java with the lock released and deletes the local ref.
+     */
+    jobject acquireTarget(JNIEnv* env);
+
+    /** Wake the session's timeline publisher through the registry. */
+    void wakePublisher() const;
+
+    jlong session_ = 0;
+    std::mutex mutex_;
+    jobject target_ = nullptr;  // global ref
+};
+
+} // namespace chromadmx
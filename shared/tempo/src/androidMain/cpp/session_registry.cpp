@@ -0,0 +1,173 @@
+/**
+ * session_registry.cpp — Slab of generation-tagged Link session slots.
+ *
+ * See session_registry.h for the handle layout and the slot state word.
+ */
+
+#include "session_registry.h"
+
+#include "shared_timeline.h"
+
+#include <ableton/Link.hpp>
+
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace chromadmx {
+
+namespace {
+
+constexpr uint64_t kReaderMask = 0xFFFFFFFFULL;
+constexpr int kGenerationShift = 32;
+
+struct alignas(64) Slot {  // One cache line each: readers of different sessions never contend
+    std::atomic<uint64_t> state{0};  // {generation:32, readers:32}
+    ableton::Link* link = nullptr;   // Written only while the generation is even
+    alignas(64) SharedTimeline timeline{};  // Process lifetime; see sessionTimeline()
+    TimelinePublisher* publisher = nullptr;  // Owned; guarded by publisherMutex
+    std::mutex publisherMutex;                // Never held while deleting a Link
+};
+
+Slot slots[kMaxSessions];
+
+/** Serializes create/destroy; never taken by SessionRef. */
+std::mutex lifecycleMutex;
+
+inline uint32_t generationOf(uint64_t state) {
+    return static_cast<uint32_t>(state >> kGenerationShift);
+}
+
+inline jlong makeHandle(uint32_t index, uint32_t generation) {
+    return static_cast<jlong>((static_cast<uint64_t>(generation) << kGenerationShift) | index);
+}
+
+/** Live slot named by [handle], or nullptr. Call with lifecycleMutex held. */
+Slot* liveSlot(jlong handle) {
+    auto bits = static_cast<uint64_t>(handle);
+    auto index = static_cast<uint32_t>(bits & kReaderMask);
+    uint32_t generation = generationOf(bits);
+    if (index >= kMaxSessions || (generation & 1U) == 0) return nullptr;
+    Slot& slot = slots[index];
+    return generationOf(slot.state.load(std::memory_order_relaxed)) == generation ? &slot : nullptr;
+}
+
+/** Run [action] on [handle]'s publisher under its slot's publisherMutex. */
+template <typename Action>
+void withPublisher(jlong handle, Action action) {
+    auto bits = static_cast<uint64_t>(handle);
+    auto index = static_cast<uint32_t>(bits & kReaderMask);
+    if (index >= kMaxSessions) return;
+    Slot& slot = slots[index];
+    std::lock_guard<std::mutex> guard(slot.publisherMutex);
+    // A publisher is only ever installed for the live generation, and is
+    // taken out under this mutex before it is deleted.
+    if (generationOf(slot.state.load(std::memory_order_acquire)) != generationOf(bits)) return;
+    if (slot.publisher != nullptr) action(*slot.publisher);
+}
+
+} // anonymous namespace
+
+jlong createSession(double initialBpm) {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    for (uint32_t index = 0; index < kMaxSessions; ++index) {
+        Slot& slot = slots[index];
+        uint32_t generation = generationOf(slot.state.load(std::memory_order_relaxed));
+        if (generation & 1U) continue;  // Live
+
+        slot.link = new ableton::Link(initialBpm);
+        // Odd generation publishes the instance; readers acquire it.
+        uint64_t next = slot.state.fetch_add(1ULL << kGenerationShift, std::memory_order_release);
+        return makeHandle(index, generationOf(next) + 1);
+    }
+    return 0;
+}
+
+bool destroySession(jlong handle) {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    Slot* live = liveSlot(handle);
+    if (live == nullptr) return false;
+    Slot& slot = *live;
+
+    // Even generation: every new SessionRef for this handle now fails.
+    slot.state.fetch_add(1ULL << kGenerationShift, std::memory_order_acq_rel);
+    TimelinePublisher* publisher = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(slot.publisherMutex);
+        std::swap(publisher, slot.publisher);
+    }
+    // Joins the publisher thread, whose captures then only see a stale handle.
+    delete publisher;
+    while ((slot.state.load(std::memory_order_acquire) & kReaderMask) != 0) {
+        std::this_thread::yield();
+    }
+    delete slot.link;  // Unregisters the Link callbacks
+    slot.link = nullptr;
+    return true;
+}
+
+bool attachPublisher(jlong handle, std::unique_ptr<TimelinePublisher> publisher) {
+    std::unique_ptr<TimelinePublisher> unused;  // Destroyed after the lock is released
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) {
+        unused = std::move(publisher);
+        return false;
+    }
+    // Only this thread can install a publisher while lifecycleMutex is held,
+    // so checking, starting, then installing leaves no second writer.
+    if (slot->publisher != nullptr) {
+        unused = std::move(publisher);
+        return true;
+    }
+    publisher->start();
+    std::lock_guard<std::mutex> guard(slot->publisherMutex);
+    slot->publisher = publisher.release();
+    return true;
+}
+
+std::unique_ptr<TimelinePublisher> detachPublisher(jlong handle) {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    Slot* slot = liveSlot(handle);
+    if (slot == nullptr) return nullptr;
+    std::lock_guard<std::mutex> guard(slot->publisherMutex);
+    std::unique_ptr<TimelinePublisher> publisher(slot->publisher);
+    slot->publisher = nullptr;
+    return publisher;
+}
+
+void wakePublisher(jlong handle) {
+    withPublisher(handle, [](TimelinePublisher& publisher) { publisher.wake(); });
+}
+
+void setPublisherActive(jlong handle, bool active) {
+    withPublisher(handle, [active](TimelinePublisher& publisher) { publisher.setActive(active); });
+}
+
+SharedTimeline* sessionTimeline(jlong handle) {
+    SessionRef link(handle);
+    if (!link) return nullptr;
+    return &slots[static_cast<uint32_t>(static_cast<uint64_t>(handle) & kReaderMask)].timeline;
+}
+
+SessionRef::SessionRef(jlong handle) {
+    auto bits = static_cast<uint64_t>(handle);
+    auto index = static_cast<uint32_t>(bits & kReaderMask);
+    uint32_t generation = generationOf(bits);
+    if (index >= kMaxSessions || (generation & 1U) == 0) return;  // Never issued (e.g. 0)
+
+    Slot& slot = slots[index];
+    uint64_t state = slot.state.fetch_add(1, std::memory_order_acquire);
+    if (generationOf(state) != generation) {
+        slot.state.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    state_ = &slot.state;
+    link_ = slot.link;
+}
+
+SessionRef::~SessionRef() {
+    if (state_ != nullptr) state_->fetch_sub(1, std::memory_order_release);
+}
+
+} // namespace chromadmx
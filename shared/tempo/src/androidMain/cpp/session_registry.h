@@ -0,0 +1,123 @@
+/**
+ * session_registry.h — Generation-tagged handles for native Link sessions.
+ *
+ * ## Purpose
+ *
+ * Kotlin holds each native session as a jlong. Rather than the raw
+ * ableton::Link address, that jlong is a handle: a slot index in a fixed
+ * slab plus the slot's generation at creation time. Destroying a session
+ * bumps the generation, so every copy of the old handle — a late poll, a
+ * racing close() — fails validation and gets a defined idle value instead
+ * of dereferencing freed memory. Several sessions (e.g. the main session
+ * and an isolated preview session) can live side by side.
+ *
+ * ## Hot path
+ *
+ * SessionRef is the only way to reach a Link instance. Acquiring one is a
+ * single atomic add on the slot's state word plus one generation compare;
+ * releasing is one atomic subtract. There is no lock, so the
+ * @CriticalNative reads stay non-blocking.
+ *
+ * ## Slot state
+ *
+ * Each slot packs {generation:32, readers:32} into one atomic word. An odd
+ * generation means the slot is live. Handles carry the odd generation, and
+ * 0 is never a valid handle. destroy() makes the generation even first, so
+ * new acquisitions fail, waits for in-flight readers to drain, and only
+ * then deletes the instance.
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace ableton {
+class Link;
+}
+
+namespace chromadmx {
+
+struct SharedTimeline;
+class TimelinePublisher;
+
+/** Maximum number of concurrently live sessions. */
+constexpr uint32_t kMaxSessions = 8;
+
+/**
+ * Create a Link session at [initialBpm].
+ *
+ * @return Its handle, or 0 if all kMaxSessions slots are in use.
+ */
+jlong createSession(double initialBpm);
+
+/**
+ * Invalidate [handle] and delete its session (and its timeline publisher,
+ * if any) once no SessionRef is using it.
+ *
+ * @return False if [handle] was already stale.
+ */
+bool destroySession(jlong handle);
+
+/**
+ * Shared timeline storage of [handle]'s slot, or nullptr for a stale handle.
+ *
+ * The storage belongs to the slot, not the session, and is never freed: a
+ * direct ByteBuffer Kotlin took over it stays readable after close(), and
+ * a later session in the same slot keeps publishing into it with the same
+ * seqlock, so such a reader sees consistent (if foreign) values, never
+ * freed memory.
+ */
+SharedTimeline* sessionTimeline(jlong handle);
+
+/**
+ * Give [handle]'s slot ownership of [publisher] and start it. The registry,
+ * not Kotlin, holds the only pointer to it, so a stale or repeated teardown
+ * can never delete it twice.
+ *
+ * [publisher] must not be started yet: only the one that claims the slot
+ * starts, so the slot's seqlock never has two writers, and a stale handle
+ * never writes into a slot that has been reused.
+ *
+ * @return False if [handle] is stale; [publisher] is then destroyed unstarted.
+ *         If the slot already has a publisher it is kept, [publisher] is
+ *         destroyed unstarted, and the result is true.
+ */
+bool attachPublisher(jlong handle, std::unique_ptr<TimelinePublisher> publisher);
+
+/** Take [handle]'s publisher back out; empty if the handle is stale or has none. */
+std::unique_ptr<TimelinePublisher> detachPublisher(jlong handle);
+
+/**
+ * Wake [handle]'s publisher, if it has one, so a change is republished at
+ * once. Safe from any thread, including Link's callback thread while the
+ * session is being destroyed: it never waits on session teardown.
+ */
+void wakePublisher(jlong handle);
+
+/** TimelinePublisher::setActive() on [handle]'s publisher, if it has one. */
+void setPublisherActive(jlong handle, bool active);
+
+/** Scoped, validated access to a live session. */
+class SessionRef {
+public:
+    explicit SessionRef(jlong handle);
+    ~SessionRef();
+
+    SessionRef(const SessionRef&) = delete;
+    SessionRef& operator=(const SessionRef&) = delete;
+
+    /** False if the handle was stale or never valid. */
+    explicit operator bool() const { return link_ != nullptr; }
+
+    ableton::Link* operator->() const { return link_; }
+
+private:
+    std::atomic<uint64_t>* state_ = nullptr;
+    ableton::Link* link_ = nullptr;
+};
+
+} // namespace chromadmx
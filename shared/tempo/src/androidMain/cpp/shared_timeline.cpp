@@ -0,0 +1,145 @@
+/**
+ * shared_timeline.cpp — Publisher thread for the seqlock Link timeline.
+ *
+ * See shared_timeline.h for the memory layout and read protocol.
+ */
+
+#include "shared_timeline.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <time.h>
+
+namespace chromadmx {
+
+namespace {
+constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+inline uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t mix(uint64_t hash, uint64_t word) {
+    return (hash ^ word) * kFnvPrime;
+}
+} // anonymous namespace
+
+int64_t monotonicMicros() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000LL + ts.tv_nsec / 1000;
+}
+
+uint64_t timelineChecksum(const SharedTimeline& timeline, uint64_t sequence) {
+    uint64_t hash = kFnvOffset;
+    hash = mix(hash, sequence);
+    hash = mix(hash, bitsOf(timeline.tempo));
+    hash = mix(hash, bitsOf(timeline.beatOrigin));
+    hash = mix(hash, static_cast<uint64_t>(timeline.hostMicrosOrigin));
+    hash = mix(hash, static_cast<uint64_t>(timeline.monotonicMicrosOrigin));
+    hash = mix(hash, bitsOf(timeline.quantum));
+    hash = mix(hash, static_cast<uint64_t>(static_cast<uint32_t>(timeline.numPeers))
+                     | (static_cast<uint64_t>(timeline.flags) << 32));
+    hash = mix(hash, timeline.generation);
+    return hash;
+}
+
+TimelinePublisher::TimelinePublisher(SharedTimeline* timeline, double quantum, Capture capture)
+    : timeline_(timeline), quantum_(quantum), capture_(std::move(capture))
+{
+}
+
+void TimelinePublisher::start() {
+    // Publish synchronously so the buffer is valid before Kotlin maps it.
+    // The sequence continues from whatever an earlier publisher left in the
+    // storage, so a reader still holding it never sees a stale even value.
+    publish(capture_());
+    thread_ = std::thread(&TimelinePublisher::run, this);
+}
+
+TimelinePublisher::~TimelinePublisher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void TimelinePublisher::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeRequested_ = true;
+    }
+    wakeCondition_.notify_one();
+}
+
+void TimelinePublisher::setActive(bool active) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (active_ == active) return;
+        active_ = active;
+        wakeRequested_ = wakeRequested_ || active;
+    }
+    wakeCondition_.notify_one();
+}
+
+void TimelinePublisher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto woken = [this] { return stopping_ || wakeRequested_; };
+    while (!stopping_) {
+        if (active_) {
+            wakeCondition_.wait_for(lock, std::chrono::milliseconds(kRefreshIntervalMs), woken);
+        } else {
+            wakeCondition_.wait(lock, woken);
+        }
+        if (stopping_) break;
+        wakeRequested_ = false;
+
+        lock.unlock();
+        AnchorReading reading = capture_();
+        if (needsRefresh(reading)) publish(reading);
+        lock.lock();
+    }
+}
+
+bool TimelinePublisher::needsRefresh(const AnchorReading& reading) const {
+    // Only the publisher thread writes the payload, so plain reads are safe here.
+    if (reading.tempo != timeline_->tempo) return true;
+    if (reading.numPeers != timeline_->numPeers) return true;
+    if (reading.flags != timeline_->flags) return true;
+
+    double elapsedMicros = static_cast<double>(reading.hostMicros - timeline_->hostMicrosOrigin);
+    double predicted = timeline_->beatOrigin + elapsedMicros * timeline_->tempo / 60.0e6;
+    if (std::fabs(predicted - reading.beat) > kMaxBeatError) return true;
+
+    // The Kotlin side extrapolates on CLOCK_MONOTONIC; re-anchor if it has
+    // slewed against the Link clock by more than the same tolerance.
+    double monotonicElapsed = static_cast<double>(reading.monotonicMicros - timeline_->monotonicMicrosOrigin);
+    double predictedMonotonic = timeline_->beatOrigin + monotonicElapsed * timeline_->tempo / 60.0e6;
+    return std::fabs(predictedMonotonic - reading.beat) > kMaxBeatError;
+}
+
+void TimelinePublisher::publish(const AnchorReading& reading) {
+    uint64_t sequence = timeline_->sequence.load(std::memory_order_relaxed);
+    timeline_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    timeline_->tempo = reading.tempo;
+    timeline_->beatOrigin = reading.beat;
+    timeline_->hostMicrosOrigin = reading.hostMicros;
+    timeline_->monotonicMicrosOrigin = reading.monotonicMicros;
+    timeline_->quantum = quantum_;
+    timeline_->numPeers = reading.numPeers;
+    timeline_->flags = reading.flags;
+    timeline_->generation += 1;
+    timeline_->checksum = timelineChecksum(*timeline_, sequence + 2);
+
+    timeline_->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace chromadmx
@@ -0,0 +1,153 @@
+/**
+ * shared_timeline.h — Seqlock-protected Link timeline shared with Kotlin.
+ *
+ * ## Purpose
+ *
+ * Polling Link over JNI costs a native transition per read. Instead, a
+ * native publisher thread keeps a small [SharedTimeline] struct up to date and
+ * Kotlin maps it as a direct ByteBuffer (NewDirectByteBuffer), so reading
+ * tempo, the beat anchor and peer count is a handful of plain memory loads.
+ *
+ * The struct holds an *anchor* — the beat position at a known host time —
+ * rather than a phase. Kotlin extrapolates the current beat from the anchor
+ * and tempo, so the anchor only has to be republished when tempo, peers or
+ * the timeline itself actually change.
+ *
+ * ## Seqlock protocol
+ *
+ * The single writer bumps [SharedTimeline::sequence] to an odd value, writes
+ * the payload, then stores the next even value. Kotlin cannot issue acquire
+ * fences on every supported API level (VarHandle fences need API 33), so the
+ * writer also stores a [SharedTimeline::checksum] over the payload words and
+ * the final sequence. A reading is accepted only when the sequence is even,
+ * unchanged across the read, and the checksum matches.
+ *
+ * Field offsets are mirrored in LinkSharedTimeline.kt — keep them in sync.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace chromadmx {
+
+/** Shared memory layout read by LinkSharedTimeline.kt (native byte order). */
+struct SharedTimeline {
+    std::atomic<uint64_t> sequence;  // 0:  seqlock counter, odd while writing
+    double tempo;                    // 8:  BPM
+    double beatOrigin;               // 16: beat at the origin time (quantum-aligned)
+    int64_t hostMicrosOrigin;        // 24: origin on the Link clock
+    int64_t monotonicMicrosOrigin;   // 32: origin on CLOCK_MONOTONIC (System.nanoTime base)
+    double quantum;                  // 40: quantum the beat was computed with
+    int32_t numPeers;                // 48: connected peers
+    uint32_t flags;                  // 52: kTimelinePlaying | kTimelineStartStopSync
+    uint64_t generation;             // 56: bumps on every republished anchor
+    uint64_t checksum;               // 64: see timelineChecksum()
+};
+
+/** [SharedTimeline::flags] bit: the transport is playing. */
+constexpr uint32_t kTimelinePlaying = 1U << 0;
+
+/** [SharedTimeline::flags] bit: start/stop sync is enabled, so kTimelinePlaying follows the session. */
+constexpr uint32_t kTimelineStartStopSync = 1U << 1;
+
+static_assert(offsetof(SharedTimeline, tempo) == 8, "layout mirrored in Kotlin");
+static_assert(offsetof(SharedTimeline, flags) == 52, "layout mirrored in Kotlin");
+static_assert(offsetof(SharedTimeline, generation) == 56, "layout mirrored in Kotlin");
+static_assert(offsetof(SharedTimeline, checksum) == 64, "layout mirrored in Kotlin");
+static_assert(sizeof(SharedTimeline) == 72, "layout mirrored in Kotlin");
+
+/** One reading of the Link session used to (re)anchor the shared timeline. */
+struct AnchorReading {
+    double tempo;
+    double beat;
+    int64_t hostMicros;
+    int64_t monotonicMicros;
+    int32_t numPeers;
+    uint32_t flags;  // SharedTimeline::flags bits
+};
+
+/** Current CLOCK_MONOTONIC time in microseconds (same base as System.nanoTime). */
+int64_t monotonicMicros();
+
+/**
+ * FNV-1a style hash over the payload words and the final even sequence.
+ * Mirrored bit-for-bit by LinkSharedTimeline.checksum().
+ */
+uint64_t timelineChecksum(const SharedTimeline& timeline, uint64_t sequence);
+
+/**
+ * Keeps a [SharedTimeline] fresh from its own thread.
+ *
+ * The struct itself is not owned: it lives in the session's registry slot
+ * for the whole process (sessionTimeline() in session_registry.h), because
+ * Kotlin aliases it with a direct ByteBuffer that may still be read after
+ * the publisher is gone. A publisher never frees memory a reader can see.
+ *
+ * Updates are driven by [wake]: Link callbacks call it on every tempo, peer
+ * and start/stop change, so those are published at once. The thread also
+ * samples the session through [capture] every [kRefreshIntervalMs] to catch
+ * what no callback reports (a peer realigned the beat, the transport
+ * restarted at beat zero, or the Link and monotonic clocks slewed apart),
+ * and republishes only when the reading drifts from the published anchor by
+ * more than [kMaxBeatError] beats. While the session is disabled
+ * ([setActive] false) that periodic sample stops and the thread sleeps until
+ * woken.
+ */
+class TimelinePublisher {
+public:
+    using Capture = std::function<AnchorReading()>;
+
+    /** How often an active publisher samples the session without a wake. */
+    static constexpr int kRefreshIntervalMs = 1000;
+
+    /** Anchor error tolerated before republishing (~25us at 120 BPM). */
+    static constexpr double kMaxBeatError = 5e-5;
+
+    /**
+     * Publisher for [timeline], which must outlive every reader (not just
+     * the publisher). Nothing is written until [start]: the seqlock allows
+     * one writer, so a publisher only starts once it owns the slot.
+     */
+    TimelinePublisher(SharedTimeline* timeline, double quantum, Capture capture);
+    ~TimelinePublisher();
+
+    /** Publish the first anchor and start the thread. Call once. */
+    void start();
+
+    TimelinePublisher(const TimelinePublisher&) = delete;
+    TimelinePublisher& operator=(const TimelinePublisher&) = delete;
+
+    /** Sample and (if needed) republish right away. Safe from any thread. */
+    void wake();
+
+    /**
+     * Start or stop the periodic sample; [wake] works either way. Activating
+     * also samples right away. Safe from any thread.
+     */
+    void setActive(bool active);
+
+private:
+    void run();
+    bool needsRefresh(const AnchorReading& reading) const;
+    void publish(const AnchorReading& reading);
+
+    SharedTimeline* const timeline_;
+    const double quantum_;
+    const Capture capture_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    bool stopping_ = false;
+    bool wakeRequested_ = false;
+    bool active_ = true;
+    std::thread thread_;
+};
+
+} // namespace chromadmx
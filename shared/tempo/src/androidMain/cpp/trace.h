@@ -0,0 +1,44 @@
+/**
+ * trace.h — Compile-time gated systrace sections for the native bridge.
+ *
+ * CHROMADMX_TRACE_SECTION("name") opens an ATrace section (visible in
+ * Perfetto and systrace under the app's process) that closes at the end
+ * of the enclosing scope.
+ *
+ * Sections are compiled in only when CHROMADMX_TRACE is defined
+ * (CMake option CHROMADMX_TRACE, or the `chromadmx.trace` Gradle property).
+ * Otherwise the macro expands to nothing, so release builds carry no trace
+ * code at all. With the gate on and no trace running, a section costs one
+ * check of the atrace enable flag on each end.
+ */
+
+#pragma once
+
+#ifdef CHROMADMX_TRACE
+
+#include <android/trace.h>
+
+namespace chromadmx {
+
+/** RAII ATrace section; names must be string literals. */
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name) noexcept { ATrace_beginSection(name); }
+    ~ScopedTrace() { ATrace_endSection(); }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+};
+
+} // namespace chromadmx
+
+#define CHROMADMX_TRACE_CONCAT_(a, b) a##b
+#define CHROMADMX_TRACE_CONCAT(a, b) CHROMADMX_TRACE_CONCAT_(a, b)
+#define CHROMADMX_TRACE_SECTION(name) \
+    ::chromadmx::ScopedTrace CHROMADMX_TRACE_CONCAT(chromadmxTrace_, __LINE__)(name)
+
+#else
+
+#define CHROMADMX_TRACE_SECTION(name) static_cast<void>(0)
+
+#endif
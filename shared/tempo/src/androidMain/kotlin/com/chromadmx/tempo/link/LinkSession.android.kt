@@ -1,5 +1,8 @@
 package com.chromadmx.tempo.link
 
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
+
 /**
  * Android actual for [LinkSession].
  *
@@ -8,158 +11,334 @@ package com.chromadmx.tempo.link
  * ## Architecture
  *
  * The native library (`libableton_link_jni.so`) exposes a thin C++ wrapper around
- * the Link SDK. An opaque `Long` pointer represents the native `ableton::Link`
- * instance. All JNI methods accept this pointer as their first argument.
+ * the Link SDK. An opaque `Long` handle names the native `ableton::Link`
+ * instance in the native session registry. All JNI methods accept this
+ * handle as their first argument and validate it, so a call racing [close]
+ * sees idle values instead of freed memory. Several sessions can be live at
+ * once (up to `kMaxSessions` in `session_registry.h`).
  *
  * ## JNI Native Methods
  *
- * The following native functions must be implemented in `link_jni.cpp`:
- *
- * ```c
- * JNIEXPORT jlong JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeCreate(JNIEnv*, jobject, jdouble);
- *
- * JNIEXPORT void JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeDestroy(JNIEnv*, jobject, jlong);
- *
- * JNIEXPORT void JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeSetEnabled(JNIEnv*, jobject, jlong, jboolean);
- *
- * JNIEXPORT jboolean JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeIsEnabled(JNIEnv*, jobject, jlong);
- *
- * JNIEXPORT jdouble JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBpm(JNIEnv*, jobject, jlong);
- *
- * JNIEXPORT jdouble JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBeatPhase(JNIEnv*, jobject, jlong, jdouble);
- *
- * JNIEXPORT jdouble JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeCaptureBarPhase(JNIEnv*, jobject, jlong, jdouble);
+ * `JNI_OnLoad` in `link_jni.cpp` binds every `external fun` below with one
+ * `RegisterNatives` table and caches the callback method IDs, so nothing is
+ * looked up by name per call. Signatures must match that table.
  *
- * JNIEXPORT jint JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeNumPeers(JNIEnv*, jobject, jlong);
+ * The per-frame reads (phase, tempo, peers, beat/time look-ups) are
+ * `@CriticalNative` statics: primitives in and out, no JNIEnv, no thread
+ * state transition. [captureSnapshot] fills an array, so it is
+ * `@FastNative` instead. Everything else is a plain native call.
  *
- * JNIEXPORT void JNICALL
- * Java_com_chromadmx_tempo_link_LinkSession_nativeRequestBpm(JNIEnv*, jobject, jlong, jdouble);
- * ```
+ * ## Callbacks
  *
- * ## Build Setup
+ * Once `nativeSetListener(ptr, this)` is called, the native side invokes
+ * [onNativeNumPeers], [onNativeTempo] and [onNativeStartStop] from Link's
+ * callback thread. They forward to the registered [LinkSessionListener].
  *
- * 1. Clone Ableton Link SDK into `shared/tempo/src/androidMain/cpp/link/`.
- * 2. The CMakeLists.txt at `shared/tempo/src/androidMain/cpp/CMakeLists.txt`
- *    builds Link + JNI glue as `libableton_link_jni.so`.
- * 3. Wire CMake in the android build via `externalNativeBuild`.
+ * ## Native Library
  *
- * ## Current Status
- *
- * This is a **stub implementation** — the JNI native library is not yet built.
- * All methods return safe defaults (120 BPM, 0 phase, 0 peers). The enable/disable
- * methods track state locally but do not interact with the native SDK.
- *
- * When the Link SDK is integrated:
- * 1. Uncomment `System.loadLibrary("ableton_link_jni")` in the companion.
- * 2. Replace the stub property implementations with calls to the `external fun` methods.
- * 3. Store the native pointer from `nativeCreate()` and pass it to all other calls.
+ * `libableton_link_jni.so` is built from `shared/tempo/src/androidMain/cpp/`
+ * by the app's `externalNativeBuild` and loaded lazily, the first time a
+ * session is enabled ([nativeLibrary]), so app startup never waits on it.
+ * Where the library is missing (host unit tests, an ABI without a build)
+ * the session degrades to safe defaults — 120 BPM, 0 phase, 0 peers — and
+ * the tempo subsystem falls back to tap tempo.
  */
 actual class LinkSession actual constructor() : LinkSessionApi {
 
     // ---- JNI native method declarations ----
-    // These map to the C++ functions in link_jni.cpp.
-    // Uncomment when the native library is built.
+    // These map to the C++ functions in link_jni.cpp; the @CriticalNative
+    // reads are statics in the companion.
 
-    // private external fun nativeCreate(initialBpm: Double): Long
-    // private external fun nativeDestroy(ptr: Long)
-    // private external fun nativeSetEnabled(ptr: Long, enabled: Boolean)
-    // private external fun nativeIsEnabled(ptr: Long): Boolean
-    // private external fun nativeCaptureBpm(ptr: Long): Double
-    // private external fun nativeCaptureBeatPhase(ptr: Long, quantum: Double): Double
-    // private external fun nativeCaptureBarPhase(ptr: Long, quantum: Double): Double
-    // private external fun nativeNumPeers(ptr: Long): Int
-    // private external fun nativeRequestBpm(ptr: Long, bpm: Double)
+    private external fun nativeCreate(initialBpm: Double): Long
+    private external fun nativeDestroy(ptr: Long)
+    private external fun nativeSetEnabled(ptr: Long, enabled: Boolean)
+    private external fun nativeRequestBpm(ptr: Long, bpm: Double)
+    private external fun nativeEnableStartStopSync(ptr: Long, enabled: Boolean)
+    private external fun nativeSetIsPlaying(ptr: Long, isPlaying: Boolean, quantum: Double)
+    @FastNative
+    private external fun nativeCaptureSnapshot(ptr: Long, quantum: Double, out: DoubleArray)
+    private external fun nativeTimelineCreate(ptr: Long, quantum: Double): Boolean
+    private external fun nativeTimelineBuffer(ptr: Long): java.nio.ByteBuffer?
+    private external fun nativeTimelineDestroy(ptr: Long)
+    private external fun nativeSetListener(ptr: Long, listener: Any?): Boolean
 
-    // ---- Stub state (replace with native pointer when SDK is integrated) ----
+    // ---- Native state ----
 
     /**
-     * Native session pointer. Will hold the result of `nativeCreate()` once
-     * the JNI library is loaded. Currently unused (stub mode).
+     * Serialises the handle transitions in [enable], [disable],
+     * [setListener] and [close], so two threads never both create a native
+     * session or timeline publisher. The per-frame reads never take it.
      */
-    @Suppress("unused")
+    private val lifecycleLock = Any()
+
+    /**
+     * Native session handle from `nativeCreate()`; 0 until the first
+     * [enable] with the library loaded, and again after [close]. Stays 0
+     * if the registry was full, leaving this session on the fallbacks.
+     */
+    @Volatile
     private var nativePtr: Long = 0L
 
+    /**
+     * Reader over the session's shared timeline struct. Its publisher is
+     * owned by the native registry slot and addressed by [nativePtr], so
+     * Kotlin holds no pointer that could be freed twice. Created on [enable],
+     * torn down on [close]. The struct lives in the registry slot for the
+     * whole process, so a reader that took [sharedTimeline] just before
+     * [close] still reads valid memory.
+     */
+    @Volatile
+    private var sharedTimeline: LinkSharedTimeline? = null
+
+    /** Start/stop sync requested before the native session existed; applied on [enable]. */
+    @Volatile
+    private var startStopSync = false
+
+    /** Enabled flag reported while no native session exists. */
+    @Volatile
     private var _enabled = false
 
-    // ---- LinkSessionApi implementation (stub) ----
+    /** Output array for [captureSnapshot]; doubles as its lock. */
+    private val snapshotScratch = DoubleArray(SNAPSHOT_SIZE)
+
+    /** Listener fed from the native callback thread; see [setListener]. */
+    @Volatile
+    private var listener: LinkSessionListener? = null
+
+    // ---- LinkSessionApi implementation ----
 
     actual override fun enable() {
-        _enabled = true
-        // TODO: When native library is available:
-        // if (nativePtr == 0L) nativePtr = nativeCreate(DEFAULT_BPM)
-        // nativeSetEnabled(nativePtr, true)
+        if (!nativeLibrary) {
+            _enabled = true
+            return
+        }
+        synchronized(lifecycleLock) {
+            _enabled = true
+            var ptr = nativePtr
+            if (ptr == 0L) {
+                ptr = nativeCreate(DEFAULT_BPM)
+                if (ptr == 0L) return
+                listener?.let { nativeSetListener(ptr, this) }
+                if (startStopSync) nativeEnableStartStopSync(ptr, true)
+                nativePtr = ptr
+            }
+            nativeSetEnabled(ptr, true)
+            if (sharedTimeline == null && nativeTimelineCreate(ptr, BAR_QUANTUM)) {
+                sharedTimeline = nativeTimelineBuffer(ptr)?.let(::LinkSharedTimeline)
+            }
+        }
     }
 
     actual override fun disable() {
-        _enabled = false
-        // TODO: When native library is available:
-        // if (nativePtr != 0L) nativeSetEnabled(nativePtr, false)
+        synchronized(lifecycleLock) {
+            _enabled = false
+            val ptr = nativePtr
+            if (ptr != 0L) nativeSetEnabled(ptr, false)
+        }
     }
 
     actual override val isEnabled: Boolean
-        get() = _enabled
-        // TODO: When native library is available:
-        // get() = if (nativePtr != 0L) nativeIsEnabled(nativePtr) else false
+        get() {
+            val ptr = nativePtr
+            return if (ptr != 0L) nativeIsEnabled(ptr) else _enabled
+        }
 
     actual override val peerCount: Int
-        get() = 0
-        // TODO: When native library is available:
-        // get() = if (nativePtr != 0L) nativeNumPeers(nativePtr) else 0
+        get() {
+            val ptr = nativePtr
+            return if (ptr != 0L) nativeNumPeers(ptr) else 0
+        }
 
     actual override val bpm: Double
-        get() = DEFAULT_BPM
-        // TODO: When native library is available:
-        // get() = if (nativePtr != 0L) nativeCaptureBpm(nativePtr) else DEFAULT_BPM
+        get() {
+            val ptr = nativePtr
+            return if (ptr != 0L) nativeCaptureBpm(ptr) else DEFAULT_BPM
+        }
 
     actual override val beatPhase: Double
-        get() = 0.0
-        // TODO: When native library is available:
-        // get() = if (nativePtr != 0L) nativeCaptureBeatPhase(nativePtr, BEAT_QUANTUM) else 0.0
+        get() {
+            val ptr = nativePtr
+            return if (ptr != 0L) nativeCaptureBeatPhase(ptr, BEAT_QUANTUM) else 0.0
+        }
 
     actual override val barPhase: Double
-        get() = 0.0
-        // TODO: When native library is available:
-        // get() = if (nativePtr != 0L) nativeCaptureBarPhase(nativePtr, BAR_QUANTUM) else 0.0
+        get() {
+            val ptr = nativePtr
+            return if (ptr != 0L) nativeCaptureBarPhase(ptr, BAR_QUANTUM) else 0.0
+        }
 
     actual override fun requestBpm(bpm: Double) {
-        // TODO: When native library is available:
-        // if (nativePtr != 0L) nativeRequestBpm(nativePtr, bpm)
+        val ptr = nativePtr
+        if (ptr != 0L) nativeRequestBpm(ptr, bpm)
+    }
+
+    override fun enableStartStopSync(enabled: Boolean) {
+        startStopSync = enabled
+        val ptr = nativePtr
+        if (ptr != 0L) nativeEnableStartStopSync(ptr, enabled)
+    }
+
+    override fun setIsPlaying(isPlaying: Boolean) {
+        val ptr = nativePtr
+        if (ptr != 0L) nativeSetIsPlaying(ptr, isPlaying, BAR_QUANTUM)
+    }
+
+    /**
+     * Capture the whole timeline reading with a single JNI transition.
+     *
+     * The native side fills [snapshotScratch], one array per session, so
+     * polling allocates nothing but the [LinkSnapshot] itself. The array is
+     * locked for the fill and unpack, keeping this safe to call from any
+     * thread; the lock is uncontended on the usual single poller.
+     */
+    actual override fun captureSnapshot(): LinkSnapshot {
+        val ptr = nativePtr
+        if (ptr == 0L) return LinkSnapshot.IDLE
+        val out = snapshotScratch
+        synchronized(out) {
+            nativeCaptureSnapshot(ptr, BAR_QUANTUM, out)
+            return LinkSnapshot(
+                bpm = out[SNAPSHOT_TEMPO],
+                beat = out[SNAPSHOT_BEAT],
+                beatPhase = out[SNAPSHOT_BEAT_PHASE],
+                barPhase = out[SNAPSHOT_BAR_PHASE],
+                peerCount = out[SNAPSHOT_NUM_PEERS].toInt(),
+                hostMicros = out[SNAPSHOT_HOST_MICROS].toLong(),
+                isPlaying = out[SNAPSHOT_IS_PLAYING] != 0.0,
+                playStateMicros = out[SNAPSHOT_PLAY_STATE_MICROS].toLong(),
+                startStopSync = out[SNAPSHOT_START_STOP_SYNC] != 0.0
+            )
+        }
+    }
+
+    /**
+     * Anchor read from the native shared timeline with plain memory loads;
+     * null until [enable] has started the publisher.
+     */
+    actual override val timelineAnchor: LinkTimelineAnchor?
+        get() = sharedTimeline?.read()
+
+    /**
+     * `System.nanoTime()` is CLOCK_MONOTONIC on Android — the clock the
+     * shared timeline anchors are published against.
+     */
+    actual override fun hostMicros(): Long = System.nanoTime() / 1_000L
+
+    /**
+     * Beat at a (possibly future) [hostMicros] on the `System.nanoTime()`
+     * clock; the native side maps it onto the Link clock.
+     */
+    actual override fun beatAtTime(hostMicros: Long, quantum: Double): Double {
+        val ptr = nativePtr
+        return if (ptr != 0L) nativeBeatAtTime(ptr, hostMicros, quantum) else 0.0
+    }
+
+    /** Inverse of [beatAtTime], in `System.nanoTime()` microseconds. */
+    actual override fun timeAtBeat(beat: Double, quantum: Double): Long {
+        val ptr = nativePtr
+        return if (ptr != 0L) nativeTimeAtBeat(ptr, beat, quantum) else 0L
+    }
+
+    /**
+     * Native callbacks are only delivered once a native session exists;
+     * until then consumers keep polling.
+     */
+    override val supportsListener: Boolean
+        get() = nativePtr != 0L
+
+    override fun setListener(listener: LinkSessionListener?) {
+        synchronized(lifecycleLock) {
+            this.listener = listener
+            val ptr = nativePtr
+            if (ptr != 0L) nativeSetListener(ptr, if (listener != null) this else null)
+        }
+    }
+
+    // ---- Native callbacks (called from Link's thread via session_hooks.cpp) ----
+
+    @Suppress("unused")
+    private fun onNativeNumPeers(count: Int) {
+        listener?.onPeersChanged(count)
+    }
+
+    @Suppress("unused")
+    private fun onNativeTempo(bpm: Double) {
+        listener?.onTempoChanged(bpm)
+    }
+
+    @Suppress("unused")
+    private fun onNativeStartStop(isPlaying: Boolean) {
+        listener?.onStartStopChanged(isPlaying)
     }
 
     /**
      * Release native resources. Call when the session is no longer needed.
      */
     actual override fun close() {
-        // TODO: When native library is available:
-        // if (nativePtr != 0L) {
-        //     nativeDestroy(nativePtr)
-        //     nativePtr = 0L
-        // }
-        _enabled = false
+        synchronized(lifecycleLock) {
+            sharedTimeline = null
+            listener = null
+            val ptr = nativePtr
+            nativePtr = 0L
+            if (ptr != 0L) {
+                nativeSetListener(ptr, null)
+                nativeTimelineDestroy(ptr)
+                nativeDestroy(ptr)
+            }
+            _enabled = false
+        }
     }
 
     companion object {
         private const val DEFAULT_BPM = 120.0
 
         /** Quantum of 1 beat for beat-phase calculation. */
-        @Suppress("unused")
         private const val BEAT_QUANTUM = 1.0
 
         /** Quantum of 4 beats for bar-phase calculation (4/4 time). */
-        @Suppress("unused")
         private const val BAR_QUANTUM = 4.0
 
-        // TODO: Uncomment when native library is built:
-        // init {
-        //     System.loadLibrary("ableton_link_jni")
-        // }
+        // Slot layout of the nativeCaptureSnapshot() output array.
+        // Must stay in sync with the SnapshotSlot enum in link_jni.cpp.
+        private const val SNAPSHOT_TEMPO = 0
+        private const val SNAPSHOT_BEAT = 1
+        private const val SNAPSHOT_BEAT_PHASE = 2
+        private const val SNAPSHOT_BAR_PHASE = 3
+        private const val SNAPSHOT_NUM_PEERS = 4
+        private const val SNAPSHOT_HOST_MICROS = 5
+        private const val SNAPSHOT_IS_PLAYING = 6
+        private const val SNAPSHOT_PLAY_STATE_MICROS = 7
+        private const val SNAPSHOT_START_STOP_SYNC = 8
+        private const val SNAPSHOT_SIZE = 9
+
+        // ---- @CriticalNative reads (static, primitives only) ----
+
+        @JvmStatic @CriticalNative
+        private external fun nativeIsEnabled(ptr: Long): Boolean
+        @JvmStatic @CriticalNative
+        private external fun nativeCaptureBpm(ptr: Long): Double
+        @JvmStatic @CriticalNative
+        private external fun nativeCaptureBeatPhase(ptr: Long, quantum: Double): Double
+        @JvmStatic @CriticalNative
+        private external fun nativeCaptureBarPhase(ptr: Long, quantum: Double): Double
+        @JvmStatic @CriticalNative
+        private external fun nativeNumPeers(ptr: Long): Int
+        @JvmStatic @CriticalNative
+        private external fun nativeBeatAtTime(ptr: Long, hostMicros: Long, quantum: Double): Double
+        @JvmStatic @CriticalNative
+        private external fun nativeTimeAtBeat(ptr: Long, beat: Double, quantum: Double): Long
+
+        /**
+         * Whether `libableton_link_jni` is loaded. Loading runs once, on the
+         * first [enable], rather than when the class is initialized.
+         */
+        private val nativeLibrary: Boolean by lazy {
+            try {
+                System.loadLibrary("ableton_link_jni")
+                true
+            } catch (e: UnsatisfiedLinkError) {
+                false
+            }
+        }
     }
 }
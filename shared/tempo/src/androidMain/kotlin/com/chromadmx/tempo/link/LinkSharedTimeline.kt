@@ -0,0 +1,129 @@
+package com.chromadmx.tempo.link
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Reader for the seqlock-protected timeline struct published by the native
+ * `TimelinePublisher` (see `shared_timeline.h`).
+ *
+ * [buffer] is a direct ByteBuffer aliasing native memory, so [read] is a few
+ * plain loads with no JNI transition. Absolute reads never touch the buffer
+ * position, which makes [read] safe to call from any thread.
+ *
+ * ART offers no acquire fence below API 33, so a reading is validated with
+ * both the sequence counter and the payload checksum written by the native
+ * side; a torn read fails one of the two and is retried.
+ */
+internal class LinkSharedTimeline(buffer: ByteBuffer) {
+
+    private val buffer: ByteBuffer = buffer.order(ByteOrder.nativeOrder())
+
+    /** Last successfully validated anchor, returned if the writer keeps racing us. */
+    @Volatile
+    private var lastGood: LinkTimelineAnchor? = null
+
+    init {
+        require(buffer.capacity() >= SIZE) {
+            "Shared timeline buffer too small: ${buffer.capacity()} < $SIZE"
+        }
+    }
+
+    /**
+     * Read the current anchor. Returns the previous valid anchor (or null
+     * before the first one) if every attempt overlapped a native write.
+     */
+    fun read(): LinkTimelineAnchor? {
+        repeat(MAX_ATTEMPTS) {
+            val before = buffer.getLong(OFFSET_SEQUENCE)
+            if ((before and 1L) != 0L) return@repeat
+
+            val tempoBits = buffer.getLong(OFFSET_TEMPO)
+            val beatBits = buffer.getLong(OFFSET_BEAT_ORIGIN)
+            val hostMicros = buffer.getLong(OFFSET_HOST_MICROS_ORIGIN)
+            val monotonicMicros = buffer.getLong(OFFSET_MONOTONIC_MICROS_ORIGIN)
+            val quantumBits = buffer.getLong(OFFSET_QUANTUM)
+            val numPeers = buffer.getInt(OFFSET_NUM_PEERS)
+            val flags = buffer.getInt(OFFSET_FLAGS)
+            val generation = buffer.getLong(OFFSET_GENERATION)
+            val storedChecksum = buffer.getLong(OFFSET_CHECKSUM)
+
+            val after = buffer.getLong(OFFSET_SEQUENCE)
+            if (after != before) return@repeat
+
+            val expected = checksum(
+                before, tempoBits, beatBits, hostMicros, monotonicMicros,
+                quantumBits, numPeers, flags, generation
+            )
+            if (expected != storedChecksum) return@repeat
+
+            // Kotlin extrapolates on System.nanoTime(), i.e. CLOCK_MONOTONIC,
+            // so the anchor uses the monotonic origin rather than the Link clock.
+            val anchor = LinkTimelineAnchor(
+                tempo = Double.fromBits(tempoBits),
+                beatOrigin = Double.fromBits(beatBits),
+                hostMicrosOrigin = monotonicMicros,
+                quantum = Double.fromBits(quantumBits),
+                peerCount = numPeers,
+                generation = generation,
+                isPlaying = (flags and FLAG_PLAYING) != 0,
+                startStopSync = (flags and FLAG_START_STOP_SYNC) != 0,
+                clockOffsetMicros = hostMicros - monotonicMicros
+            )
+            lastGood = anchor
+            return anchor
+        }
+        return lastGood
+    }
+
+    companion object {
+        // Field offsets — must match struct SharedTimeline in shared_timeline.h.
+        private const val OFFSET_SEQUENCE = 0
+        private const val OFFSET_TEMPO = 8
+        private const val OFFSET_BEAT_ORIGIN = 16
+        private const val OFFSET_HOST_MICROS_ORIGIN = 24
+        private const val OFFSET_MONOTONIC_MICROS_ORIGIN = 32
+        private const val OFFSET_QUANTUM = 40
+        private const val OFFSET_NUM_PEERS = 48
+        private const val OFFSET_FLAGS = 52
+        private const val OFFSET_GENERATION = 56
+        private const val OFFSET_CHECKSUM = 64
+
+        // SharedTimeline::flags bits (kTimelinePlaying, kTimelineStartStopSync).
+        private const val FLAG_PLAYING = 1
+        private const val FLAG_START_STOP_SYNC = 2
+
+        /** sizeof(SharedTimeline). */
+        const val SIZE = 72
+
+        /** A write takes well under a microsecond; a few retries always suffice. */
+        private const val MAX_ATTEMPTS = 8
+
+        private const val FNV_OFFSET = -0x340d631b7bdddcdbL // 0xcbf29ce484222325
+        private const val FNV_PRIME = 0x100000001b3L
+
+        /** Bit-for-bit mirror of timelineChecksum() in shared_timeline.cpp. */
+        internal fun checksum(
+            sequence: Long,
+            tempoBits: Long,
+            beatBits: Long,
+            hostMicros: Long,
+            monotonicMicros: Long,
+            quantumBits: Long,
+            numPeers: Int,
+            flags: Int,
+            generation: Long
+        ): Long {
+            var hash = FNV_OFFSET
+            hash = (hash xor sequence) * FNV_PRIME
+            hash = (hash xor tempoBits) * FNV_PRIME
+            hash = (hash xor beatBits) * FNV_PRIME
+            hash = (hash xor hostMicros) * FNV_PRIME
+            hash = (hash xor monotonicMicros) * FNV_PRIME
+            hash = (hash xor quantumBits) * FNV_PRIME
+            hash = (hash xor ((numPeers.toLong() and 0xFFFFFFFFL) or (flags.toLong() shl 32))) * FNV_PRIME
+            hash = (hash xor generation) * FNV_PRIME
+            return hash
+        }
+    }
+}
@@ -33,12 +33,27 @@ interface BeatClock {
     /** Whether the clock is actively advancing phase. */
     val isRunning: StateFlow<Boolean>
 
+    /**
+     * Whether the musical transport is playing. Clocks that follow a shared
+     * transport (Link start/stop sync) report it here; the default is
+     * [isRunning].
+     */
+    val isPlaying: StateFlow<Boolean> get() = isRunning
+
     /**
      * Composite snapshot of the current timing state, suitable for
      * passing into the effect engine each frame.
      */
     val beatState: StateFlow<BeatState>
 
+    /**
+     * Timing state at this instant, for per-frame consumers such as the
+     * render loop. Clocks that can extrapolate between updates (e.g. from a
+     * Link timeline anchor) override this with pure arithmetic; the default
+     * returns the last published [beatState].
+     */
+    fun sampleBeatState(): BeatState = beatState.value
+
     /** Start phase advancement. */
     fun start()
 
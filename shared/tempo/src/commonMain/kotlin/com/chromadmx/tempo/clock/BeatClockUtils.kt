@@ -20,6 +20,8 @@ object BeatClockUtils {
     /** Number of beats per bar (4/4 time). */
     const val BEATS_PER_BAR: Int = 4
 
+    private const val MICROS_PER_MINUTE: Double = 60_000_000.0
+
     /**
      * Duration of one beat in seconds at the given [bpm].
      */
@@ -58,6 +60,33 @@ object BeatClockUtils {
         return (totalBars % 1.0).toFloat()
     }
 
+    /**
+     * Extrapolate a timeline beat position [elapsedMicros] after a known
+     * anchor at [beatOrigin], assuming a constant [tempo] in between.
+     */
+    fun extrapolateBeat(beatOrigin: Double, tempo: Double, elapsedMicros: Long): Double =
+        beatOrigin + elapsedMicros.toDouble() * tempo / MICROS_PER_MINUTE
+
+    /**
+     * Microseconds spanned by [beats] at a constant [tempo]; the inverse of
+     * [extrapolateBeat]. Returns 0 for a non-positive tempo.
+     */
+    fun beatsToMicros(beats: Double, tempo: Double): Long {
+        if (tempo <= 0.0) return 0L
+        return (beats * MICROS_PER_MINUTE / tempo).toLong()
+    }
+
+    /**
+     * Normalize a timeline [beat] position into a phase in [0.0, 1.0)
+     * relative to [quantum] beats. Negative beats (before the timeline
+     * origin) wrap the same way as positive ones.
+     */
+    fun phaseInQuantum(beat: Double, quantum: Double): Double {
+        if (quantum <= 0.0) return 0.0
+        val phase = beat % quantum
+        return (if (phase < 0.0) phase + quantum else phase) / quantum
+    }
+
     /**
      * Clamp a BPM value to the supported range [MIN_BPM]..[MAX_BPM].
      */
@@ -49,7 +49,8 @@ val tempoModule = module {
     single {
         AbletonLinkClock(
             scope = get<CoroutineScope>(),
-            linkSession = get<LinkSessionApi>()
+            linkSession = get<LinkSessionApi>(),
+            telemetry = getOrNull()
         )
     }
 
@@ -1,16 +1,20 @@
 package com.chromadmx.tempo.link
 
 import com.chromadmx.core.model.BeatState
+import com.chromadmx.core.telemetry.PerformanceTelemetry
 import com.chromadmx.tempo.clock.BeatClock
 import com.chromadmx.tempo.clock.BeatClockUtils
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.withTimeoutOrNull
+import kotlin.concurrent.Volatile
 import kotlin.time.TimeSource
 
 /**
@@ -19,7 +23,21 @@ import kotlin.time.TimeSource
  *
  * This is a shared (common) implementation that delegates to [LinkSession]
  * for the actual native Link SDK communication. The class polls the session
- * at ~60fps and publishes updates via StateFlows.
+ * at ~60fps and publishes updates via StateFlows. When the session exposes a
+ * shared-memory [LinkSessionApi.timelineAnchor], phase is extrapolated from
+ * it with no native call; otherwise each poll is one
+ * [LinkSessionApi.captureSnapshot]. [sampleBeatState] extrapolates from the
+ * anchor on demand, so the render loop gets a fresh phase every frame without
+ * calling into Link. [outputLatencyMicros] shifts that sample forward to
+ * when the frame will actually reach the fixtures.
+ *
+ * ## Transport
+ *
+ * With [startStopSync] on, [isPlaying] (and [BeatState.isPlaying]) follows
+ * the session transport — a DJ pressing stop in their software stops the
+ * show. [requestPlaying] starts the transport with beat 0 on the next bar,
+ * so first-beat effects land on a downbeat. With sync off, [isPlaying]
+ * simply mirrors [isRunning].
  *
  * ## Automatic "no link" detection
  *
@@ -27,6 +45,16 @@ import kotlin.time.TimeSource
  * this clock sets [linkState] to [LinkState.NO_LINK], signaling the UI to show
  * a "no peers" indicator and potentially fall back to tap tempo.
  *
+ * ## Event-driven idle
+ *
+ * When the session [supports a listener][LinkSessionApi.supportsListener],
+ * peer, tempo and start/stop changes are pushed from native callbacks. Once
+ * in [LinkState.NO_LINK] the loop drops from every frame to every
+ * [idleUpdateIntervalMs], waking early for a pushed event, so an idle rig
+ * with no peers does not wake a coroutine every frame. [bpm], [beatPhase],
+ * [barPhase] and [isPlaying] keep advancing at that slower rate; the render
+ * loop should use [sampleBeatState], which is exact at any rate.
+ *
  * ## Usage
  *
  * ```kotlin
@@ -39,15 +67,19 @@ import kotlin.time.TimeSource
  * @param scope           Coroutine scope for the phase polling loop.
  * @param linkSession     Platform-specific Link session (implements [LinkSessionApi]).
  * @param updateIntervalMs  How often to poll Link and refresh StateFlows (default 16ms).
+ * @param idleUpdateIntervalMs  How often to refresh them while idle in [LinkState.NO_LINK].
  * @param noLinkTimeoutMs  Duration in ms with 0 peers before emitting [LinkState.NO_LINK].
  * @param timeSource      Injectable time source for testing (returns nanoseconds).
+ * @param telemetry       Receives native read durations and Link clock drift, if set.
  */
 class AbletonLinkClock(
     private val scope: CoroutineScope,
     private val linkSession: LinkSessionApi,
     private val updateIntervalMs: Long = 16L,
     private val noLinkTimeoutMs: Long = 5_000L,
-    private val timeSource: () -> Long = defaultTimeSource
+    private val timeSource: () -> Long = defaultTimeSource,
+    private val telemetry: PerformanceTelemetry? = null,
+    private val idleUpdateIntervalMs: Long = 100L
 ) : BeatClock {
 
     /** Represents the state of the Link connection. */
@@ -76,6 +108,24 @@ class AbletonLinkClock(
     /** Whether we have ever seen a peer since the session was enabled. */
     private var hasSeenPeer: Boolean = false
 
+    /** Last anchor generation seen by the poll loop, for drift telemetry. */
+    private var lastAnchorGeneration: Long = -1L
+
+    /** Anchor clock offset when this run started; drift is measured against it. */
+    private var baselineClockOffsetMicros: Long = 0L
+
+    /** Whether [linkSession] pushes changes, so NO_LINK can idle without polling. */
+    private var eventDriven: Boolean = false
+
+    /** Poll requests pushed from Link's callback thread; conflated, payload-free. */
+    private val wakeups = Channel<Unit>(Channel.CONFLATED)
+
+    private val sessionListener = object : LinkSessionListener {
+        override fun onPeersChanged(count: Int) { wakeups.trySend(Unit) }
+        override fun onTempoChanged(bpm: Double) { wakeups.trySend(Unit) }
+        override fun onStartStopChanged(isPlaying: Boolean) { wakeups.trySend(Unit) }
+    }
+
     // ---- StateFlows (BeatClock) ----
 
     private val _bpm = MutableStateFlow(BeatClockUtils.DEFAULT_BPM)
@@ -90,9 +140,31 @@ class AbletonLinkClock(
     private val _isRunning = MutableStateFlow(false)
     override val isRunning: StateFlow<Boolean> = _isRunning.asStateFlow()
 
+    private val _isPlaying = MutableStateFlow(false)
+    override val isPlaying: StateFlow<Boolean> = _isPlaying.asStateFlow()
+
     private val _beatState = MutableStateFlow(BeatState.IDLE)
     override val beatState: StateFlow<BeatState> = _beatState.asStateFlow()
 
+    /**
+     * How far ahead of now [sampleBeatState] evaluates the timeline, in
+     * microseconds: the delay between rendering a frame and its light leaving
+     * the fixtures (engine-to-DMX handoff, send interval, network, fixture).
+     * Zero renders for "now"; set it per rig so strobes land on the beat.
+     */
+    @Volatile
+    var outputLatencyMicros: Long = 0L
+
+    /**
+     * Follow and propagate Link transport start/stop. Off by default, so an
+     * app with no transport in the session never freezes the show.
+     */
+    var startStopSync: Boolean = false
+        set(value) {
+            field = value
+            linkSession.enableStartStopSync(value)
+        }
+
     // ---- Additional StateFlows for Link-specific info ----
 
     private val _peerCount = MutableStateFlow(0)
@@ -116,10 +188,15 @@ class AbletonLinkClock(
         startTimeNanos = timeSource()
         lastPeerSeenNanos = startTimeNanos
         hasSeenPeer = false
+        lastAnchorGeneration = -1L
 
         linkSession.enable()
         _linkState.value = LinkState.SEARCHING
 
+        wakeups.tryReceive() // drop a wakeup left over from a previous run
+        eventDriven = linkSession.supportsListener
+        if (eventDriven) linkSession.setListener(sessionListener)
+
         startPollLoop()
     }
 
@@ -132,10 +209,38 @@ class AbletonLinkClock(
         pollJob?.cancel()
         pollJob = null
 
+        if (eventDriven) linkSession.setListener(null)
+        eventDriven = false
         linkSession.disable()
+        _isPlaying.value = false
         _linkState.value = LinkState.DISABLED
     }
 
+    /**
+     * Start or stop the session transport for every peer with start/stop
+     * sync enabled. Starting maps beat 0 to the next bar.
+     */
+    fun requestPlaying(playing: Boolean) {
+        linkSession.setIsPlaying(playing)
+    }
+
+    /**
+     * Beat state at the expected output time of a frame rendered now
+     * (now + [outputLatencyMicros]), extrapolated from the session's timeline
+     * anchor. Pure arithmetic over shared memory, so it is safe to call from
+     * the render loop; falls back to the last polled [beatState] when the
+     * session has no anchor.
+     */
+    override fun sampleBeatState(): BeatState {
+        if (!_isRunning.value) return _beatState.value
+        val anchor = linkSession.timelineAnchor ?: return _beatState.value
+        val latency = outputLatencyMicros
+        return toBeatState(
+            anchor.snapshotAt(linkSession.hostMicros() + latency),
+            timeSource() + latency * NANOS_PER_MICRO
+        )
+    }
+
     // ---- Internal ----
 
     private fun startPollLoop() {
@@ -143,7 +248,13 @@ class AbletonLinkClock(
         pollJob = scope.launch {
             while (isActive) {
                 pollLinkSession()
-                delay(updateIntervalMs)
+                if (eventDriven && _linkState.value == LinkState.NO_LINK) {
+                    // Peers and tempo are pushed; only the phases need the slow refresh.
+                    withTimeoutOrNull(idleUpdateIntervalMs) { wakeups.receive() }
+                } else {
+                    delay(updateIntervalMs)
+                    wakeups.tryReceive() // this poll already covers it
+                }
             }
         }
     }
@@ -154,7 +265,22 @@ class AbletonLinkClock(
      */
     internal fun pollLinkSession() {
         val now = timeSource()
-        val currentPeers = linkSession.peerCount
+
+        // Prefer the shared-memory anchor (no native call at all); otherwise
+        // one capture per poll, so beat/bar phase share the same host time.
+        val anchor = linkSession.timelineAnchor
+        val snapshot = if (anchor != null) {
+            if (telemetry != null) recordClockDrift(anchor, telemetry)
+            anchor.snapshotAt(linkSession.hostMicros())
+        } else if (telemetry != null) {
+            val callStart = timeSource()
+            linkSession.captureSnapshot().also {
+                telemetry.linkCall.record((timeSource() - callStart) / NANOS_PER_MICRO)
+            }
+        } else {
+            linkSession.captureSnapshot()
+        }
+        val currentPeers = snapshot.peerCount
         _peerCount.value = currentPeers
 
         // Track peer visibility for no-link detection
@@ -175,32 +301,43 @@ class AbletonLinkClock(
             else -> LinkState.SEARCHING
         }
 
-        // Read phase and tempo from Link
-        val linkBpm = linkSession.bpm.toFloat()
-        val clampedBpm = BeatClockUtils.clampBpm(linkBpm)
-        val linkBeatPhase = linkSession.beatPhase.toFloat().coerceIn(0f, 1f)
-        val linkBarPhase = linkSession.barPhase.toFloat().coerceIn(0f, 1f)
-
-        _bpm.value = clampedBpm
-        _beatPhase.value = linkBeatPhase
-        _barPhase.value = linkBarPhase
+        // Phase and tempo from the same snapshot
+        val state = toBeatState(snapshot, now)
+        _bpm.value = state.bpm
+        _beatPhase.value = state.beatPhase
+        _barPhase.value = state.barPhase
+        _isPlaying.value = state.isPlaying && _isRunning.value
+        _beatState.value = state
+    }
 
+    /** Clamp a snapshot's tempo and phases into a [BeatState] at [now]. */
+    private fun toBeatState(snapshot: LinkSnapshot, now: Long): BeatState {
         // Elapsed time since start
         val elapsedSec = (now - startTimeNanos).toDouble() / NANOS_PER_SEC
-
-        _beatState.value = BeatState(
-            bpm = clampedBpm,
-            beatPhase = linkBeatPhase,
-            barPhase = linkBarPhase,
-            elapsed = elapsedSec.toFloat()
+        return BeatState(
+            bpm = BeatClockUtils.clampBpm(snapshot.bpm.toFloat()),
+            beatPhase = snapshot.beatPhase.toFloat().coerceIn(0f, 1f),
+            barPhase = snapshot.barPhase.toFloat().coerceIn(0f, 1f),
+            elapsed = elapsedSec.toFloat(),
+            isPlaying = snapshot.transportPlaying
         )
     }
 
     private fun nanosSinceLastPeer(now: Long): Long = now - lastPeerSeenNanos
 
+    /** On each newly published anchor, record how far its clock offset moved this run. */
+    private fun recordClockDrift(anchor: LinkTimelineAnchor, telemetry: PerformanceTelemetry) {
+        if (anchor.generation == lastAnchorGeneration) return
+        if (lastAnchorGeneration < 0L) baselineClockOffsetMicros = anchor.clockOffsetMicros
+        lastAnchorGeneration = anchor.generation
+        val drift = anchor.clockOffsetMicros - baselineClockOffsetMicros
+        telemetry.linkClockDrift.record(if (drift < 0L) -drift else drift)
+    }
+
     companion object {
         internal const val NANOS_PER_SEC: Double = 1_000_000_000.0
         internal const val NANOS_PER_MS: Long = 1_000_000L
+        internal const val NANOS_PER_MICRO: Long = 1_000L
 
         private val monotonicStart = TimeSource.Monotonic.markNow()
         private val defaultTimeSource: () -> Long = {
@@ -110,6 +110,15 @@ class LinkFallbackClock(
         _syncSource.value = SyncSource.NONE
     }
 
+    /**
+     * Per-frame sample from the active source: extrapolated from the Link
+     * timeline while on Link, the last published state otherwise.
+     */
+    override fun sampleBeatState(): BeatState = when (_syncSource.value) {
+        SyncSource.LINK -> linkClock.sampleBeatState()
+        else -> _beatState.value
+    }
+
     // ---- Internal ----
 
     private fun startMonitorLoop() {
@@ -18,7 +18,8 @@ package com.chromadmx.tempo.link
  *
  * 1. Create a [LinkSession] instance.
  * 2. Call [enable] to join the Link mesh on the local network.
- * 3. Poll [bpm], [beatPhase], [barPhase], and [peerCount] at your desired rate.
+ * 3. Read [timelineAnchor] and extrapolate from [hostMicros] every frame, or
+ *    poll [captureSnapshot] (or the individual properties) at your desired rate.
  * 4. Call [disable] when the user turns Link off or the app backgrounds.
  *
  * ## Platform bridges
@@ -42,5 +43,10 @@ expect class LinkSession() : LinkSessionApi {
     override val beatPhase: Double
     override val barPhase: Double
     override fun requestBpm(bpm: Double)
+    override fun captureSnapshot(): LinkSnapshot
+    override val timelineAnchor: LinkTimelineAnchor?
+    override fun hostMicros(): Long
+    override fun beatAtTime(hostMicros: Long, quantum: Double): Double
+    override fun timeAtBeat(beat: Double, quantum: Double): Long
     override fun close()
 }
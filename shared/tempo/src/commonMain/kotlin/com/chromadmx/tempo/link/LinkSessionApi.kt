@@ -39,4 +39,95 @@ interface LinkSessionApi : AutoCloseable {
 
     /** Request a tempo change propagated to all peers. */
     fun requestBpm(bpm: Double)
+
+    /**
+     * Follow and propagate transport start/stop with peers that also have
+     * start/stop sync enabled. A no-op where the platform leaves this to a
+     * user setting (LinkKit on iOS).
+     */
+    fun enableStartStopSync(enabled: Boolean) {}
+
+    /**
+     * Start or stop the session transport now. Starting maps beat 0 to the
+     * next bar the session allows, so first-beat effects start on a downbeat.
+     */
+    fun setIsPlaying(isPlaying: Boolean) {}
+
+    /**
+     * Read tempo, phase and peer count from one timeline capture.
+     *
+     * Platform sessions override this so that a poll costs a single native
+     * transition and all fields share one host time. The default composes the
+     * individual properties, which is sufficient for test fakes.
+     */
+    fun captureSnapshot(): LinkSnapshot {
+        val bar = barPhase
+        return LinkSnapshot(
+            bpm = bpm,
+            beat = bar * BAR_QUANTUM,
+            beatPhase = beatPhase,
+            barPhase = bar,
+            peerCount = peerCount,
+            hostMicros = 0L
+        )
+    }
+
+    /** Transport state; see [LinkSnapshot.isPlaying]. */
+    val isPlaying: Boolean get() = captureSnapshot().isPlaying
+
+    /**
+     * Latest timeline anchor published by the native side, or null when the
+     * platform has no shared timeline (or it is not running).
+     *
+     * Reading this must not call into Link: implementations back it with
+     * shared memory, so it is safe to read every frame.
+     */
+    val timelineAnchor: LinkTimelineAnchor? get() = null
+
+    /**
+     * Current time, in microseconds, on the clock [timelineAnchor] origins
+     * are expressed in. Like [timelineAnchor], this must not call into Link.
+     */
+    fun hostMicros(): Long = 0L
+
+    /**
+     * Beat position at [hostMicros] (on the [hostMicros] clock), aligned to
+     * [quantum]. Unlike the phase properties this may be a future time, so a
+     * renderer can ask for the beat at the moment a frame will actually be
+     * output.
+     *
+     * Platforms answer from the Link session itself. The default extrapolates
+     * [timelineAnchor], which is exact for any quantum dividing the anchor's,
+     * and returns 0.0 without one.
+     */
+    fun beatAtTime(hostMicros: Long, quantum: Double): Double =
+        timelineAnchor?.beatAt(hostMicros) ?: 0.0
+
+    /**
+     * Host time, in microseconds on the [hostMicros] clock, at which the
+     * timeline reaches [beat] (aligned to [quantum]). The inverse of
+     * [beatAtTime]; the default extrapolates [timelineAnchor] and returns 0
+     * without one.
+     */
+    fun timeAtBeat(beat: Double, quantum: Double): Long =
+        timelineAnchor?.timeAtBeat(beat) ?: 0L
+
+    /**
+     * Whether this session pushes changes to a [LinkSessionListener]. When
+     * true, consumers may stop polling while nothing is happening and wait
+     * for the next event instead.
+     */
+    val supportsListener: Boolean get() = false
+
+    /**
+     * Register [listener] for peer, tempo and start/stop changes, replacing
+     * any previous one; null unregisters. A no-op when [supportsListener] is
+     * false.
+     */
+    fun setListener(listener: LinkSessionListener?) {}
+
+    companion object {
+        /** Quantum of 4 beats used for bar phase (4/4 time). */
+        const val BAR_QUANTUM: Double = 4.0
+    }
 }
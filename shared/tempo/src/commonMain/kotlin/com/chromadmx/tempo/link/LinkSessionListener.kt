@@ -0,0 +1,21 @@
+package com.chromadmx.tempo.link
+
+/**
+ * Receives Link session changes as they happen, instead of the consumer
+ * having to poll for them.
+ *
+ * Callbacks arrive on a platform thread owned by the Link session (never the
+ * caller's thread), so implementations must only hand the event off — e.g.
+ * `trySend` into a channel — and return immediately.
+ */
+interface LinkSessionListener {
+
+    /** The number of connected peers changed to [count]. */
+    fun onPeersChanged(count: Int) {}
+
+    /** The session tempo changed to [bpm]. */
+    fun onTempoChanged(bpm: Double) {}
+
+    /** Transport start/stop state changed. */
+    fun onStartStopChanged(isPlaying: Boolean) {}
+}
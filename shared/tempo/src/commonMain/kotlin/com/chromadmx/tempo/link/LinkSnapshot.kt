@@ -0,0 +1,51 @@
+package com.chromadmx.tempo.link
+
+/**
+ * One consistent reading of the Link timeline.
+ *
+ * Every field is derived from a single captured session state evaluated at a
+ * single host time, so [beatPhase] and [barPhase] can never disagree the way
+ * two separate captures a few microseconds apart can.
+ *
+ * @property bpm        Session tempo in BPM.
+ * @property beat       Beat position on the timeline at [hostMicros] (bar-quantum aligned).
+ * @property beatPhase  Phase within the current beat, 0.0 to just below 1.0.
+ * @property barPhase   Phase within the current bar, 0.0 to just below 1.0.
+ * @property peerCount  Number of connected Link peers.
+ * @property hostMicros Host time (microseconds) the reading was taken at, 0 if unknown.
+ * @property isPlaying  Transport state of the session. Only meaningful to
+ *                      follow when [startStopSync] is on; see [transportPlaying].
+ * @property playStateMicros Time of the last transport start/stop on the
+ *                      [LinkSessionApi.hostMicros] clock, 0 if unknown.
+ * @property startStopSync Whether start/stop sync is enabled on this session.
+ */
+data class LinkSnapshot(
+    val bpm: Double,
+    val beat: Double,
+    val beatPhase: Double,
+    val barPhase: Double,
+    val peerCount: Int,
+    val hostMicros: Long,
+    val isPlaying: Boolean = false,
+    val playStateMicros: Long = 0L,
+    val startStopSync: Boolean = false
+) {
+    /**
+     * Whether a consumer should treat the transport as playing: always when
+     * start/stop sync is off (the session has no shared transport to follow),
+     * otherwise [isPlaying].
+     */
+    val transportPlaying: Boolean get() = !startStopSync || isPlaying
+
+    companion object {
+        /** Reading reported when no native session exists (120 BPM, no phase, no peers). */
+        val IDLE = LinkSnapshot(
+            bpm = 120.0,
+            beat = 0.0,
+            beatPhase = 0.0,
+            barPhase = 0.0,
+            peerCount = 0,
+            hostMicros = 0L
+        )
+    }
+}
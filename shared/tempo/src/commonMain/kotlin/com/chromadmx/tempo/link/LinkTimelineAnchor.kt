@@ -0,0 +1,61 @@
+package com.chromadmx.tempo.link
+
+import com.chromadmx.tempo.clock.BeatClockUtils
+
+/**
+ * A beat position on the Link timeline pinned to a host time.
+ *
+ * Between tempo or phase changes the timeline is linear, so the beat at any
+ * other host time follows from [tempo] alone. Platforms publish a new anchor
+ * only when that stops being true; consumers extrapolate locally instead of
+ * capturing session state on every read.
+ *
+ * @property tempo            Session tempo in BPM.
+ * @property beatOrigin       Beat position at [hostMicrosOrigin], aligned to [quantum].
+ * @property hostMicrosOrigin Origin time in microseconds on the clock of [LinkSessionApi.hostMicros].
+ * @property quantum          Quantum [beatOrigin] was computed with (4.0 for bars in 4/4).
+ * @property peerCount        Connected peers when the anchor was published.
+ * @property generation       Increments every time a new anchor is published.
+ * @property isPlaying        Session transport state when the anchor was published.
+ * @property startStopSync    Whether start/stop sync was enabled when the anchor was published.
+ * @property clockOffsetMicros Link clock minus [hostMicrosOrigin]'s clock at the origin, where
+ *                             the platform measures both (0 otherwise); its change over time is
+ *                             the Link clock's drift.
+ */
+data class LinkTimelineAnchor(
+    val tempo: Double,
+    val beatOrigin: Double,
+    val hostMicrosOrigin: Long,
+    val quantum: Double,
+    val peerCount: Int,
+    val generation: Long,
+    val isPlaying: Boolean = false,
+    val startStopSync: Boolean = false,
+    val clockOffsetMicros: Long = 0L
+) {
+    /** Beat position at [hostMicros], extrapolated from this anchor. */
+    fun beatAt(hostMicros: Long): Double =
+        BeatClockUtils.extrapolateBeat(beatOrigin, tempo, hostMicros - hostMicrosOrigin)
+
+    /** Host time, in microseconds, at which the timeline reaches [beat]. */
+    fun timeAtBeat(beat: Double): Long =
+        hostMicrosOrigin + BeatClockUtils.beatsToMicros(beat - beatOrigin, tempo)
+
+    /**
+     * A full [LinkSnapshot] at [hostMicros], computed without touching the
+     * native session.
+     */
+    fun snapshotAt(hostMicros: Long): LinkSnapshot {
+        val beat = beatAt(hostMicros)
+        return LinkSnapshot(
+            bpm = tempo,
+            beat = beat,
+            beatPhase = BeatClockUtils.phaseInQuantum(beat, 1.0),
+            barPhase = BeatClockUtils.phaseInQuantum(beat, quantum),
+            peerCount = peerCount,
+            hostMicros = hostMicros,
+            isPlaying = isPlaying,
+            startStopSync = startStopSync
+        )
+    }
+}
@@ -0,0 +1,208 @@
+package com.chromadmx.tempo.link
+
+import com.chromadmx.core.model.BeatState
+import com.chromadmx.tempo.clock.BeatClockUtils
+
+/**
+ * Deterministic [LinkSessionApi] on a caller-controlled clock.
+ *
+ * Time moves only through [advanceMicros] and [setHostMicros], and tempo
+ * follows a tempo map of [TempoChange]s, so the same script yields
+ * bit-identical beat positions on every run and every platform. One
+ * [timelineAnchor] is published per tempo segment, like the native shared
+ * timeline, so an [AbletonLinkClock] on top of this session runs its
+ * production extrapolation path unchanged.
+ *
+ * This lets shows render offline faster than real time: the renderer
+ * advances the clock one frame interval per frame instead of waiting it
+ * out. [beatStateAt] gives the same result without a clock in between.
+ *
+ * Not thread-safe: drive the clock and read the session from one thread,
+ * as offline rendering and tests do.
+ *
+ * @param initialBpm Tempo from time 0 until the first [TempoChange].
+ * @param tempoMap   Scripted tempo changes; order does not matter.
+ * @param peerCount  Peers the session reports, e.g. to test CONNECTED handling.
+ */
+class VirtualLinkSession(
+    initialBpm: Double = BeatClockUtils.DEFAULT_BPM.toDouble(),
+    tempoMap: List<TempoChange> = emptyList(),
+    peerCount: Int = 0
+) : LinkSessionApi {
+
+    /** Tempo becomes [bpm] at [atMicros] on the virtual clock. */
+    data class TempoChange(val atMicros: Long, val bpm: Double)
+
+    /** Linear stretch of the timeline: [beat] at [startMicros], then [bpm]. */
+    private class Segment(val startMicros: Long, val beat: Double, val bpm: Double)
+
+    private val changes = ArrayList<TempoChange>()
+    private var segments: List<Segment> = emptyList()
+
+    private var nowMicros = 0L
+    private var enabled = false
+    private var peers = peerCount
+    private var playing = false
+    private var startStopSync = false
+
+    /** Bumped whenever the published anchor would change. */
+    private var revision = 0L
+    private var cachedAnchor: LinkTimelineAnchor? = null
+    private var cachedSegment = -1
+    private var cachedRevision = -1L
+
+    init {
+        require(initialBpm > 0.0) { "initialBpm must be > 0, got $initialBpm" }
+        changes += TempoChange(0L, initialBpm)
+        for (change in tempoMap) addChange(change)
+        rebuildSegments()
+    }
+
+    // ---- Virtual clock ----
+
+    /** Move the clock forward by [micros]. */
+    fun advanceMicros(micros: Long) {
+        require(micros >= 0L) { "The virtual clock only moves forward, got $micros" }
+        nowMicros += micros
+    }
+
+    /** Jump the clock to [micros]; seeking backwards is allowed. */
+    fun setHostMicros(micros: Long) {
+        require(micros >= 0L) { "Host time must be >= 0, got $micros" }
+        nowMicros = micros
+    }
+
+    /** Set the number of peers the session reports. */
+    fun setPeerCount(count: Int) {
+        require(count >= 0) { "peer count must be >= 0, got $count" }
+        if (count != peers) revision++
+        peers = count
+    }
+
+    /** Beat state at [hostMicros], exact across tempo changes; does not move the clock. */
+    fun beatStateAt(hostMicros: Long): BeatState {
+        val segment = segments[segmentIndexAt(hostMicros)]
+        val bpm = segment.bpm
+        val beat = BeatClockUtils.extrapolateBeat(segment.beat, bpm, hostMicros - segment.startMicros)
+        return BeatState(
+            bpm = BeatClockUtils.clampBpm(bpm.toFloat()),
+            beatPhase = BeatClockUtils.phaseInQuantum(beat, 1.0).toFloat(),
+            barPhase = BeatClockUtils.phaseInQuantum(beat, LinkSessionApi.BAR_QUANTUM).toFloat(),
+            elapsed = (hostMicros / MICROS_PER_SECOND).toFloat(),
+            isPlaying = !startStopSync || playing
+        )
+    }
+
+    // ---- LinkSessionApi ----
+
+    override fun enable() { enabled = true }
+
+    override fun disable() { enabled = false }
+
+    override val isEnabled: Boolean get() = enabled
+
+    override val peerCount: Int get() = peers
+
+    override val bpm: Double get() = segments[segmentIndexAt(nowMicros)].bpm
+
+    override val beatPhase: Double get() = captureSnapshot().beatPhase
+
+    override val barPhase: Double get() = captureSnapshot().barPhase
+
+    /** Takes effect now; scripted changes later in the map still apply. */
+    override fun requestBpm(bpm: Double) {
+        if (bpm <= 0.0) return
+        addChange(TempoChange(nowMicros, bpm))
+        rebuildSegments()
+    }
+
+    override fun enableStartStopSync(enabled: Boolean) {
+        if (enabled != startStopSync) revision++
+        startStopSync = enabled
+    }
+
+    /** Transport state only: unlike Link, starting does not remap beat 0. */
+    override fun setIsPlaying(isPlaying: Boolean) {
+        if (isPlaying != playing) revision++
+        playing = isPlaying
+    }
+
+    override fun captureSnapshot(): LinkSnapshot = anchorAt(nowMicros).snapshotAt(nowMicros)
+
+    override val timelineAnchor: LinkTimelineAnchor? get() = anchorAt(nowMicros)
+
+    override fun hostMicros(): Long = nowMicros
+
+    override fun beatAtTime(hostMicros: Long, quantum: Double): Double {
+        val segment = segments[segmentIndexAt(hostMicros)]
+        return BeatClockUtils.extrapolateBeat(segment.beat, segment.bpm, hostMicros - segment.startMicros)
+    }
+
+    override fun timeAtBeat(beat: Double, quantum: Double): Long {
+        var index = segments.lastIndex
+        while (index > 0 && segments[index].beat > beat) index--
+        val segment = segments[index]
+        return segment.startMicros + BeatClockUtils.beatsToMicros(beat - segment.beat, segment.bpm)
+    }
+
+    override fun close() {}
+
+    // ---- Internal ----
+
+    private fun addChange(change: TempoChange) {
+        require(change.atMicros >= 0L) { "Tempo change time must be >= 0, got ${change.atMicros}" }
+        require(change.bpm > 0.0) { "Tempo change bpm must be > 0, got ${change.bpm}" }
+        // A later change at the same instant replaces the earlier one.
+        changes.removeAll { it.atMicros == change.atMicros }
+        changes += change
+        changes.sortBy { it.atMicros }
+    }
+
+    private fun rebuildSegments() {
+        val built = ArrayList<Segment>(changes.size)
+        var beat = 0.0
+        var previous: TempoChange? = null
+        for (change in changes) {
+            if (previous != null) {
+                beat = BeatClockUtils.extrapolateBeat(beat, previous.bpm, change.atMicros - previous.atMicros)
+            }
+            built += Segment(change.atMicros, beat, change.bpm)
+            previous = change
+        }
+        segments = built
+        revision++
+    }
+
+    private fun segmentIndexAt(hostMicros: Long): Int {
+        var index = segments.lastIndex
+        while (index > 0 && segments[index].startMicros > hostMicros) index--
+        return index
+    }
+
+    /** The anchor of the segment holding [hostMicros], reused until something changes. */
+    private fun anchorAt(hostMicros: Long): LinkTimelineAnchor {
+        val index = segmentIndexAt(hostMicros)
+        val cached = cachedAnchor
+        if (cached != null && index == cachedSegment && revision == cachedRevision) return cached
+        val segment = segments[index]
+        val generation = (cachedAnchor?.generation ?: -1L) + 1
+        return LinkTimelineAnchor(
+            tempo = segment.bpm,
+            beatOrigin = segment.beat,
+            hostMicrosOrigin = segment.startMicros,
+            quantum = LinkSessionApi.BAR_QUANTUM,
+            peerCount = peers,
+            generation = generation,
+            isPlaying = playing,
+            startStopSync = startStopSync
+        ).also {
+            cachedAnchor = it
+            cachedSegment = index
+            cachedRevision = revision
+        }
+    }
+
+    private companion object {
+        const val MICROS_PER_SECOND = 1_000_000.0
+    }
+}
@@ -3,6 +3,8 @@ package com.chromadmx.tempo.link
 import com.chromadmx.core.model.BeatState
 import com.chromadmx.tempo.clock.BeatClockUtils
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runCurrent
 import kotlinx.coroutines.test.runTest
 import kotlin.math.abs
 import kotlin.test.Test
@@ -24,7 +26,8 @@ class AbletonLinkClockTest {
 
     private class FakeLinkSession(
         initialBpm: Double = 120.0,
-        initialPeerCount: Int = 0
+        initialPeerCount: Int = 0,
+        private val pushesEvents: Boolean = false
     ) : LinkSessionApi {
         private var _enabled = false
         private var _peerCount = initialPeerCount
@@ -42,12 +45,73 @@ class AbletonLinkClockTest {
         override fun requestBpm(bpm: Double) { _bpm = bpm }
         override fun close() { _enabled = false }
 
+        var snapshotCaptures = 0
+            private set
+
+        var syncEnabled = false
+            private set
+        var playing = false
+            private set
+
+        override fun enableStartStopSync(enabled: Boolean) { syncEnabled = enabled }
+
+        override fun setIsPlaying(isPlaying: Boolean) {
+            playing = isPlaying
+            if (isPlaying) {
+                _beatPhase = 0.0
+                _barPhase = 0.0
+            }
+        }
+
+        override fun captureSnapshot(): LinkSnapshot {
+            snapshotCaptures++
+            return super.captureSnapshot().copy(isPlaying = playing, startStopSync = syncEnabled)
+        }
+
+        override val supportsListener: Boolean get() = pushesEvents
+
+        var listener: LinkSessionListener? = null
+            private set
+
+        override fun setListener(listener: LinkSessionListener?) { this.listener = listener }
+
+        /** Change the peer count and push it the way the native callback would. */
+        fun pushPeers(count: Int) {
+            _peerCount = count
+            listener?.onPeersChanged(count)
+        }
+
         fun setPeerCount(count: Int) { _peerCount = count }
         fun setBpm(value: Double) { _bpm = value }
         fun setBeatPhase(value: Double) { _beatPhase = value }
         fun setBarPhase(value: Double) { _barPhase = value }
     }
 
+    /** Session that exposes a fixed shared-memory anchor and a controllable host clock. */
+    private class AnchoredLinkSession(
+        override val timelineAnchor: LinkTimelineAnchor
+    ) : LinkSessionApi {
+        var nowMicros: Long = 0L
+        var snapshotCaptures = 0
+            private set
+
+        override fun enable() {}
+        override fun disable() {}
+        override val isEnabled: Boolean get() = true
+        override val peerCount: Int get() = timelineAnchor.peerCount
+        override val bpm: Double get() = timelineAnchor.tempo
+        override val beatPhase: Double get() = 0.0
+        override val barPhase: Double get() = 0.0
+        override fun requestBpm(bpm: Double) {}
+        override fun close() {}
+        override fun hostMicros(): Long = nowMicros
+
+        override fun captureSnapshot(): LinkSnapshot {
+            snapshotCaptures++
+            return super.captureSnapshot()
+        }
+    }
+
     private class FakeTimeSource(startNanos: Long = 0L) {
         var nowNanos: Long = startNanos
             private set
@@ -308,6 +372,120 @@ class AbletonLinkClockTest {
         clock.stop()
     }
 
+    @Test
+    fun pollCapturesOneSnapshotPerTick() = runTest {
+        val time = FakeTimeSource()
+        val session = FakeLinkSession(initialPeerCount = 1)
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            timeSource = time.provider
+        )
+
+        clock.start()
+        val before = session.snapshotCaptures
+        clock.pollLinkSession()
+        clock.pollLinkSession()
+
+        assertEquals(2, session.snapshotCaptures - before)
+        clock.stop()
+    }
+
+    @Test
+    fun pollPrefersTimelineAnchorOverCapture() = runTest {
+        val time = FakeTimeSource()
+        val session = AnchoredLinkSession(
+            LinkTimelineAnchor(
+                tempo = 120.0,
+                beatOrigin = 0.0,
+                hostMicrosOrigin = 0L,
+                quantum = 4.0,
+                peerCount = 2,
+                generation = 1L
+            )
+        )
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            timeSource = time.provider
+        )
+
+        clock.start()
+        session.nowMicros = 1_250_000L // beat 2.5
+        clock.pollLinkSession()
+
+        assertEquals(0, session.snapshotCaptures)
+        assertApprox(0.5f, clock.beatPhase.value)
+        assertApprox(0.625f, clock.barPhase.value)
+        assertEquals(2, clock.peerCount.value)
+        assertEquals(AbletonLinkClock.LinkState.CONNECTED, clock.linkState.value)
+        clock.stop()
+    }
+
+    @Test
+    fun sampleBeatStateExtrapolatesBetweenPolls() = runTest {
+        val time = FakeTimeSource()
+        val session = AnchoredLinkSession(
+            LinkTimelineAnchor(
+                tempo = 120.0,
+                beatOrigin = 0.0,
+                hostMicrosOrigin = 0L,
+                quantum = 4.0,
+                peerCount = 1,
+                generation = 1L
+            )
+        )
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            timeSource = time.provider
+        )
+
+        clock.start()
+        clock.pollLinkSession()
+
+        // No poll in between: the sample still follows the host clock
+        session.nowMicros = 1_750_000L // beat 3.5
+        time.advanceMs(1750)
+        val sampled = clock.sampleBeatState()
+
+        assertEquals(0, session.snapshotCaptures)
+        assertApprox(0.5f, sampled.beatPhase)
+        assertApprox(0.875f, sampled.barPhase)
+        assertApprox(120f, sampled.bpm)
+        assertApprox(1.75f, sampled.elapsed)
+        assertApprox(0f, clock.beatState.value.beatPhase, message = "Polled state untouched")
+        clock.stop()
+    }
+
+    @Test
+    fun sampleBeatStateLooksAheadByOutputLatency() = runTest {
+        val session = AnchoredLinkSession(
+            LinkTimelineAnchor(
+                tempo = 120.0,
+                beatOrigin = 0.0,
+                hostMicrosOrigin = 0L,
+                quantum = 4.0,
+                peerCount = 1,
+                generation = 1L
+            )
+        )
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            timeSource = FakeTimeSource().provider
+        )
+        clock.outputLatencyMicros = 125_000L // a quarter beat at 120 BPM
+
+        clock.start()
+        session.nowMicros = 1_000_000L // beat 2.0 now, 2.25 at output time
+        val sampled = clock.sampleBeatState()
+
+        assertApprox(0.25f, sampled.beatPhase)
+        assertApprox(0.5625f, sampled.barPhase)
+        clock.stop()
+    }
+
     @Test
     fun bpmClampedToMin() = runTest {
         val time = FakeTimeSource()
@@ -489,6 +667,77 @@ class AbletonLinkClockTest {
         clock.stop()
     }
 
+    @Test
+    fun idleInNoLinkUntilPeersArePushed() = runTest {
+        val time = FakeTimeSource()
+        val session = FakeLinkSession(initialPeerCount = 0, pushesEvents = true)
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            noLinkTimeoutMs = 3000,
+            timeSource = time.provider,
+            idleUpdateIntervalMs = 250
+        )
+
+        clock.start()
+        assertTrue(session.listener != null, "Listener registered on start")
+        runCurrent()
+
+        // Poll loop drives itself into NO_LINK
+        time.advanceMs(4000)
+        advanceTimeBy(20)
+        runCurrent()
+        assertEquals(AbletonLinkClock.LinkState.NO_LINK, clock.linkState.value)
+
+        // While idle, polling drops to the idle interval
+        val capturesWhenIdle = session.snapshotCaptures
+        advanceTimeBy(1_000)
+        runCurrent()
+        assertEquals(capturesWhenIdle + 4, session.snapshotCaptures)
+
+        // A pushed peer change wakes the loop immediately
+        session.pushPeers(2)
+        runCurrent()
+        assertEquals(AbletonLinkClock.LinkState.CONNECTED, clock.linkState.value)
+        assertEquals(2, clock.peerCount.value)
+
+        clock.stop()
+        assertEquals(null, session.listener, "Listener cleared on stop")
+    }
+
+    @Test
+    fun phaseKeepsAdvancingWhileIdleInNoLink() = runTest {
+        val time = FakeTimeSource()
+        val session = FakeLinkSession(initialPeerCount = 0, pushesEvents = true)
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            noLinkTimeoutMs = 3000,
+            timeSource = time.provider,
+            idleUpdateIntervalMs = 250
+        )
+
+        clock.start()
+        runCurrent()
+        time.advanceMs(4000)
+        advanceTimeBy(20)
+        runCurrent()
+        assertEquals(AbletonLinkClock.LinkState.NO_LINK, clock.linkState.value)
+
+        // No event is pushed, yet the flows catch up on the idle timer
+        session.setBeatPhase(0.5)
+        session.setBarPhase(0.625)
+        session.setBpm(100.0)
+        advanceTimeBy(250)
+        runCurrent()
+        assertApprox(0.5f, clock.beatPhase.value)
+        assertApprox(0.625f, clock.barPhase.value)
+        assertApprox(100f, clock.bpm.value)
+        assertEquals(AbletonLinkClock.LinkState.NO_LINK, clock.linkState.value)
+
+        clock.stop()
+    }
+
     @Test
     fun disabledAfterStop() = runTest {
         val time = FakeTimeSource()
@@ -628,4 +877,45 @@ class AbletonLinkClockTest {
             assertFalse(session.isEnabled)
         }
     }
+
+    // ---- Transport ----
+
+    @Test
+    fun isPlayingMirrorsRunningWithoutStartStopSync() = runTest {
+        val session = FakeLinkSession()
+        val clock = AbletonLinkClock(scope = backgroundScope, linkSession = session)
+
+        clock.start()
+        clock.pollLinkSession()
+        assertTrue(clock.isPlaying.value)
+        assertTrue(clock.beatState.value.isPlaying)
+
+        clock.stop()
+        assertFalse(clock.isPlaying.value)
+    }
+
+    @Test
+    fun isPlayingFollowsSessionTransportWithStartStopSync() = runTest {
+        val session = FakeLinkSession()
+        val clock = AbletonLinkClock(scope = backgroundScope, linkSession = session)
+        clock.startStopSync = true
+        assertTrue(session.syncEnabled)
+
+        clock.start()
+        session.setBarPhase(0.6)
+        clock.pollLinkSession()
+        assertFalse(clock.isPlaying.value)
+        assertFalse(clock.beatState.value.isPlaying)
+
+        clock.requestPlaying(true)
+        clock.pollLinkSession()
+        assertTrue(clock.isPlaying.value)
+        assertTrue(clock.beatState.value.isPlaying)
+        assertEquals(0f, clock.barPhase.value, "play starts on a downbeat")
+
+        clock.requestPlaying(false)
+        clock.pollLinkSession()
+        assertFalse(clock.beatState.value.isPlaying)
+        clock.stop()
+    }
 }
@@ -0,0 +1,74 @@
+package com.chromadmx.tempo.link
+
+import com.chromadmx.tempo.clock.BeatClockUtils
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Unit tests for [LinkTimelineAnchor] extrapolation and the
+ * [BeatClockUtils] phase helpers it is built on.
+ */
+class LinkTimelineAnchorTest {
+
+    private fun assertApprox(expected: Double, actual: Double, eps: Double = 1e-9) {
+        assertTrue(abs(expected - actual) < eps, "Expected ~$expected but got $actual")
+    }
+
+    private val anchor = LinkTimelineAnchor(
+        tempo = 120.0,
+        beatOrigin = 8.0,
+        hostMicrosOrigin = 1_000_000L,
+        quantum = 4.0,
+        peerCount = 2,
+        generation = 1L
+    )
+
+    @Test
+    fun beatAtOriginIsBeatOrigin() {
+        assertApprox(8.0, anchor.beatAt(1_000_000L))
+    }
+
+    @Test
+    fun beatAdvancesWithTempo() {
+        // 120 BPM = 2 beats per second
+        assertApprox(9.0, anchor.beatAt(1_500_000L))
+        assertApprox(10.5, anchor.beatAt(2_250_000L))
+    }
+
+    @Test
+    fun beatExtrapolatesBackwards() {
+        assertApprox(7.0, anchor.beatAt(500_000L))
+    }
+
+    @Test
+    fun timeAtBeatInvertsBeatAt() {
+        assertEquals(1_000_000L, anchor.timeAtBeat(8.0))
+        assertEquals(2_250_000L, anchor.timeAtBeat(10.5))
+        assertApprox(12.0, anchor.beatAt(anchor.timeAtBeat(12.0)))
+    }
+
+    @Test
+    fun snapshotPhasesComeFromOneBeat() {
+        // 1.25 s after origin -> beat 10.5: half a beat, 2.5 beats into the bar
+        val snapshot = anchor.snapshotAt(2_250_000L)
+        assertApprox(120.0, snapshot.bpm)
+        assertApprox(10.5, snapshot.beat)
+        assertApprox(0.5, snapshot.beatPhase)
+        assertApprox(0.625, snapshot.barPhase)
+        assertEquals(2, snapshot.peerCount)
+        assertEquals(2_250_000L, snapshot.hostMicros)
+    }
+
+    @Test
+    fun phaseInQuantumWrapsNegativeBeats() {
+        assertApprox(0.75, BeatClockUtils.phaseInQuantum(-1.0, 4.0))
+        assertApprox(0.5, BeatClockUtils.phaseInQuantum(-0.5, 1.0))
+    }
+
+    @Test
+    fun phaseInQuantumIgnoresNonPositiveQuantum() {
+        assertApprox(0.0, BeatClockUtils.phaseInQuantum(3.3, 0.0))
+    }
+}
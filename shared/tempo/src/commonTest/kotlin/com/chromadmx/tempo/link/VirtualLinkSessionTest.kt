@@ -0,0 +1,119 @@
+package com.chromadmx.tempo.link
+
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNotEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+import kotlinx.coroutines.test.runTest
+
+class VirtualLinkSessionTest {
+
+    private fun assertApprox(expected: Double, actual: Double, eps: Double = 1e-9) {
+        assertTrue(abs(expected - actual) < eps, "Expected ~$expected but got $actual")
+    }
+
+    @Test
+    fun beatFollowsVirtualClockOnly() {
+        val session = VirtualLinkSession(initialBpm = 120.0)
+        assertApprox(0.0, session.captureSnapshot().beat)
+
+        session.advanceMicros(1_250_000L)
+        // 120 BPM = 2 beats per second
+        assertApprox(2.5, session.captureSnapshot().beat)
+        assertApprox(0.5, session.beatPhase)
+        assertApprox(0.625, session.barPhase)
+    }
+
+    @Test
+    fun tempoMapIsIntegratedAcrossChanges() {
+        val session = VirtualLinkSession(
+            initialBpm = 120.0,
+            tempoMap = listOf(VirtualLinkSession.TempoChange(atMicros = 2_000_000L, bpm = 60.0))
+        )
+
+        // 4 beats in the first 2 s, then 1 beat per second.
+        assertApprox(4.0, session.beatAtTime(2_000_000L, 4.0))
+        assertApprox(7.0, session.beatAtTime(5_000_000L, 4.0))
+        assertEquals(5_000_000L, session.timeAtBeat(7.0, 4.0))
+        assertEquals(1_000_000L, session.timeAtBeat(2.0, 4.0))
+
+        session.setHostMicros(3_000_000L)
+        assertEquals(60.0, session.bpm)
+        assertApprox(5.0, session.captureSnapshot().beat)
+    }
+
+    @Test
+    fun anchorIsReusedWithinSegmentAndReplacedAtTempoChange() {
+        val session = VirtualLinkSession(
+            tempoMap = listOf(VirtualLinkSession.TempoChange(atMicros = 1_000_000L, bpm = 90.0))
+        )
+        val first = session.timelineAnchor
+        session.advanceMicros(500_000L)
+        assertSame(first, session.timelineAnchor)
+
+        session.advanceMicros(600_000L)
+        val second = session.timelineAnchor!!
+        assertNotEquals(first!!.generation, second.generation)
+        assertEquals(90.0, second.tempo)
+        assertApprox(2.0, second.beatOrigin)
+    }
+
+    @Test
+    fun requestBpmTakesEffectAtCurrentTime() {
+        val session = VirtualLinkSession(initialBpm = 120.0)
+        session.advanceMicros(1_000_000L)
+        session.requestBpm(240.0)
+        session.advanceMicros(1_000_000L)
+
+        assertApprox(6.0, session.captureSnapshot().beat)
+    }
+
+    @Test
+    fun beatStateMatchesSnapshotAndTransport() {
+        val session = VirtualLinkSession(initialBpm = 120.0)
+        session.enableStartStopSync(true)
+        assertFalse(session.beatStateAt(0L).isPlaying)
+
+        session.setIsPlaying(true)
+        val state = session.beatStateAt(750_000L)
+        assertTrue(state.isPlaying)
+        assertEquals(0.5f, state.beatPhase)
+        assertEquals(0.375f, state.barPhase)
+        assertEquals(0.75f, state.elapsed)
+    }
+
+    @Test
+    fun renderingTwiceIsBitIdentical() {
+        fun run(): List<Float> {
+            val session = VirtualLinkSession(
+                initialBpm = 128.0,
+                tempoMap = listOf(
+                    VirtualLinkSession.TempoChange(10_000_000L, 132.5),
+                    VirtualLinkSession.TempoChange(20_000_000L, 97.0)
+                )
+            )
+            return (0 until 1200).map { frame -> session.beatStateAt(frame * 25_000L).barPhase }
+        }
+        assertEquals(run(), run())
+    }
+
+    @Test
+    fun abletonClockSamplesVirtualTimeline() = runTest {
+        val session = VirtualLinkSession(initialBpm = 120.0, peerCount = 1)
+        val clock = AbletonLinkClock(
+            scope = backgroundScope,
+            linkSession = session,
+            timeSource = { session.hostMicros() * 1_000L }
+        )
+        clock.start()
+
+        session.advanceMicros(1_500_000L)
+        val sampled = clock.sampleBeatState()
+        assertEquals(session.beatStateAt(1_500_000L).barPhase, sampled.barPhase)
+        assertEquals(0.75f, sampled.barPhase)
+        clock.stop()
+    }
+}
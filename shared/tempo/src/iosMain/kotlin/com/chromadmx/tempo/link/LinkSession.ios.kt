@@ -1,18 +1,45 @@
 package com.chromadmx.tempo.link
 
 import abletonLink.ABLLinkCaptureAppSessionState
+import abletonLink.ABLLinkCaptureTimeline
 import abletonLink.ABLLinkCommitAppSessionState
 import abletonLink.ABLLinkDelete
-import abletonLink.ABLLinkGetBeatAtTime
 import abletonLink.ABLLinkGetNumPeers
-import abletonLink.ABLLinkGetTempo
+import abletonLink.ABLLinkGetTimeAtBeat
 import abletonLink.ABLLinkIsEnabled
 import abletonLink.ABLLinkNew
 import abletonLink.ABLLinkRef
 import abletonLink.ABLLinkSetActive
+import abletonLink.ABLLinkSetIsConnectedCallback
+import abletonLink.ABLLinkSetIsPlaying
+import abletonLink.ABLLinkSetIsPlayingAndRequestBeatAtTime
+import abletonLink.ABLLinkSetSessionTempoCallback
+import abletonLink.ABLLinkSetStartStopCallback
 import abletonLink.ABLLinkSetTempo
-import kotlinx.cinterop.ExperimentalForeignApi
+import abletonLink.ABLLinkTimelineFirstBeat
+import abletonLink.ABLLinkTimelineHostTime
+import abletonLink.ABLLinkTimelineIsPlaying
+import abletonLink.ABLLinkTimelineNumPeers
+import abletonLink.ABLLinkTimelinePlayTime
+import abletonLink.ABLLinkTimelineStartStopSync
+import abletonLink.ABLLinkTimelineTempo
 import abletonLink.mach_absolute_time
+import abletonLink.mach_timebase_info
+import abletonLink.mach_timebase_info_data_t
+import kotlinx.cinterop.COpaquePointer
+import kotlinx.cinterop.DoubleVar
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.StableRef
+import kotlinx.cinterop.alloc
+import kotlinx.cinterop.allocArray
+import kotlinx.cinterop.asStableRef
+import kotlinx.cinterop.get
+import kotlinx.cinterop.memScoped
+import kotlinx.cinterop.ptr
+import kotlinx.cinterop.set
+import kotlinx.cinterop.staticCFunction
+import kotlin.concurrent.Volatile
+import kotlin.math.abs
 
 /**
  * iOS actual for [LinkSession].
@@ -30,7 +57,28 @@ import abletonLink.mach_absolute_time
  * - `ABLLinkCommitAppSessionState(ref, state)` — push changes to mesh
  * - `ABLLinkGetTempo(state)` / `ABLLinkSetTempo(state, bpm, hostTime)`
  * - `ABLLinkGetBeatAtTime(state, hostTime, quantum)` — beat position
+ * - `ABLLinkGetTimeAtBeat(state, beat, quantum)` — host time of a beat
  * - `ABLLinkGetNumPeers(ref)` — connected peer count
+ * - `ABLLinkIsPlaying(state)` / `ABLLinkSetIsPlayingAndRequestBeatAtTime(...)` — transport
+ *
+ * LinkKit has no API to turn start/stop sync on: it is a user toggle in the
+ * Link settings view, so [enableStartStopSync] is a no-op here and the
+ * snapshot reports the user's choice.
+ *
+ * Reads go through `ABLLinkCaptureTimeline` (ABLLinkTimeline.h), which
+ * captures the session, reads `mach_absolute_time()` and evaluates every
+ * quantum in one C call, so each reading is one cinterop transition sharing
+ * one host time. [captureSnapshot] is the preferred polling entry point.
+ *
+ * ## Timeline anchor
+ *
+ * [timelineAnchor] is re-captured only from the LinkKit tempo, connection and
+ * start/stop callbacks (plus [enable], [requestBpm] and [setIsPlaying]), so
+ * reading it every frame never calls into LinkKit. LinkKit runs on the
+ * `mach_absolute_time()` clock itself, so unlike Android there is no clock
+ * drift to re-anchor for.
+ * The anchor's peer count is refreshed when the session connects or
+ * disconnects; LinkKit has no callback for changes in between.
  *
  * Host time is provided by `mach_absolute_time()` (ticks, not nanoseconds;
  * LinkKit uses the same timebase internally on iOS).
@@ -46,10 +94,30 @@ actual class LinkSession actual constructor() : LinkSessionApi {
     /** Opaque reference to the native Link session, created at 120 BPM. */
     private var ref: ABLLinkRef? = ABLLinkNew(DEFAULT_BPM)
 
+    /** Callback context handed to LinkKit; disposed in [close]. */
+    private val selfRef = StableRef.create(this)
+
+    /** Latest anchor, replaced wholesale so readers never see a partial one. */
+    @Volatile
+    private var anchor: LinkTimelineAnchor? = null
+
+    @Volatile
+    private var listener: LinkSessionListener? = null
+
+    init {
+        ref?.let { r ->
+            val context = selfRef.asCPointer()
+            ABLLinkSetSessionTempoCallback(r, tempoCallback, context)
+            ABLLinkSetIsConnectedCallback(r, connectedCallback, context)
+            ABLLinkSetStartStopCallback(r, startStopCallback, context)
+        }
+    }
+
     // ---- LinkSessionApi implementation ----
 
     actual override fun enable() {
         ref?.let { ABLLinkSetActive(it, true) }
+        refreshAnchor()
     }
 
     actual override fun disable() {
@@ -63,31 +131,13 @@ actual class LinkSession actual constructor() : LinkSessionApi {
         get() = ref?.let { ABLLinkGetNumPeers(it).toInt() } ?: 0
 
     actual override val bpm: Double
-        get() {
-            val r = ref ?: return DEFAULT_BPM
-            val state = ABLLinkCaptureAppSessionState(r) ?: return DEFAULT_BPM
-            return ABLLinkGetTempo(state)
-        }
+        get() = captureSnapshot().bpm
 
     actual override val beatPhase: Double
-        get() {
-            val r = ref ?: return 0.0
-            val state = ABLLinkCaptureAppSessionState(r) ?: return 0.0
-            val hostTime = mach_absolute_time()
-            val beats = ABLLinkGetBeatAtTime(state, hostTime, BEAT_QUANTUM)
-            // Modulo to get fractional beat position [0.0, 1.0)
-            return beats % BEAT_QUANTUM
-        }
+        get() = captureSnapshot().beatPhase
 
     actual override val barPhase: Double
-        get() {
-            val r = ref ?: return 0.0
-            val state = ABLLinkCaptureAppSessionState(r) ?: return 0.0
-            val hostTime = mach_absolute_time()
-            val beats = ABLLinkGetBeatAtTime(state, hostTime, BAR_QUANTUM)
-            // Position within 4-beat bar, normalized to [0.0, 1.0)
-            return (beats % BAR_QUANTUM) / BAR_QUANTUM
-        }
+        get() = captureSnapshot().barPhase
 
     actual override fun requestBpm(bpm: Double) {
         val r = ref ?: return
@@ -95,6 +145,134 @@ actual class LinkSession actual constructor() : LinkSessionApi {
         val hostTime = mach_absolute_time()
         ABLLinkSetTempo(state, bpm, hostTime)
         ABLLinkCommitAppSessionState(r, state)
+        refreshAnchor()
+    }
+
+    override fun setIsPlaying(isPlaying: Boolean) {
+        val r = ref ?: return
+        val state = ABLLinkCaptureAppSessionState(r) ?: return
+        val hostTime = mach_absolute_time()
+        if (isPlaying) {
+            ABLLinkSetIsPlayingAndRequestBeatAtTime(state, true, hostTime, 0.0, BAR_QUANTUM)
+        } else {
+            ABLLinkSetIsPlaying(state, false, hostTime)
+        }
+        ABLLinkCommitAppSessionState(r, state)
+        refreshAnchor()
+    }
+
+    /**
+     * Capture tempo, both phases, peer count and transport state with one
+     * `ABLLinkCaptureTimeline` call evaluated at one host time.
+     */
+    actual override fun captureSnapshot(): LinkSnapshot {
+        val r = ref ?: return LinkSnapshot.IDLE
+        return memScoped {
+            val quanta = allocArray<DoubleVar>(2)
+            quanta[0] = BEAT_QUANTUM
+            quanta[1] = BAR_QUANTUM
+            val out = allocArray<DoubleVar>(ABLLinkTimelineFirstBeat + 2)
+            if (!ABLLinkCaptureTimeline(r, 0uL, quanta, 2uL, out)) return@memScoped LinkSnapshot.IDLE
+            val barBeats = out[ABLLinkTimelineFirstBeat + 1]
+            LinkSnapshot(
+                bpm = out[ABLLinkTimelineTempo],
+                beat = barBeats,
+                beatPhase = normalizePhase(out[ABLLinkTimelineFirstBeat], BEAT_QUANTUM),
+                barPhase = normalizePhase(barBeats, BAR_QUANTUM),
+                peerCount = out[ABLLinkTimelineNumPeers].toInt(),
+                hostMicros = hostTicksToMicros(out[ABLLinkTimelineHostTime].toULong()),
+                isPlaying = out[ABLLinkTimelineIsPlaying] != 0.0,
+                playStateMicros = hostTicksToMicros(out[ABLLinkTimelinePlayTime].toULong()),
+                startStopSync = out[ABLLinkTimelineStartStopSync] != 0.0
+            )
+        }
+    }
+
+    /** Cached anchor; null until [enable]. Reading it never calls into LinkKit. */
+    actual override val timelineAnchor: LinkTimelineAnchor?
+        get() = anchor
+
+    /** `mach_absolute_time()` in microseconds — the clock anchors are taken on. */
+    actual override fun hostMicros(): Long = hostTicksToMicros(mach_absolute_time())
+
+    actual override fun beatAtTime(hostMicros: Long, quantum: Double): Double {
+        val r = ref ?: return 0.0
+        return memScoped {
+            val quanta = allocArray<DoubleVar>(1)
+            quanta[0] = quantum
+            val out = allocArray<DoubleVar>(ABLLinkTimelineFirstBeat + 1)
+            val ticks = microsToHostTicks(hostMicros)
+            if (ABLLinkCaptureTimeline(r, ticks, quanta, 1uL, out)) out[ABLLinkTimelineFirstBeat] else 0.0
+        }
+    }
+
+    actual override fun timeAtBeat(beat: Double, quantum: Double): Long {
+        val r = ref ?: return 0L
+        val state = ABLLinkCaptureAppSessionState(r) ?: return 0L
+        return hostTicksToMicros(ABLLinkGetTimeAtBeat(state, beat, quantum))
+    }
+
+    override val supportsListener: Boolean
+        get() = ref != null
+
+    override fun setListener(listener: LinkSessionListener?) {
+        this.listener = listener
+    }
+
+    /**
+     * Capture the session once and publish a new anchor if tempo, peers or
+     * transport changed, or the timeline moved away from the current anchor.
+     */
+    private fun refreshAnchor() {
+        val snapshot = captureSnapshot()
+        if (snapshot === LinkSnapshot.IDLE) return // no session or capture failed
+        val tempo = snapshot.bpm
+        val beat = snapshot.beat
+        val micros = snapshot.hostMicros
+        val peers = snapshot.peerCount
+
+        val current = anchor
+        if (current != null &&
+            current.tempo == tempo &&
+            current.peerCount == peers &&
+            current.isPlaying == snapshot.isPlaying &&
+            current.startStopSync == snapshot.startStopSync &&
+            abs(current.beatAt(micros) - beat) <= MAX_BEAT_ERROR
+        ) return
+
+        anchor = LinkTimelineAnchor(
+            tempo = tempo,
+            beatOrigin = beat,
+            hostMicrosOrigin = micros,
+            quantum = BAR_QUANTUM,
+            peerCount = peers,
+            generation = (current?.generation ?: 0L) + 1L,
+            isPlaying = snapshot.isPlaying,
+            startStopSync = snapshot.startStopSync
+        )
+    }
+
+    // ---- LinkKit callbacks (main thread) ----
+
+    private fun onSessionTempo(bpm: Double) {
+        refreshAnchor()
+        listener?.onTempoChanged(bpm)
+    }
+
+    private fun onConnectionChanged() {
+        refreshAnchor()
+        listener?.onPeersChanged(anchor?.peerCount ?: 0)
+    }
+
+    private fun onStartStop(isPlaying: Boolean) {
+        refreshAnchor()
+        listener?.onStartStopChanged(isPlaying)
+    }
+
+    /** Position within [quantum] beats, normalized to [0.0, 1.0). */
+    private fun normalizePhase(beats: Double, quantum: Double): Double {
+        val phase = beats % quantum
+        return (if (phase < 0.0) phase + quantum else phase) / quantum
     }
 
     /**
@@ -104,12 +282,47 @@ actual class LinkSession actual constructor() : LinkSessionApi {
     actual override fun close() {
         ref?.let { r ->
             ABLLinkSetActive(r, false)
-            ABLLinkDelete(r)
+            ABLLinkDelete(r) // No callbacks after this, so the context can go
+            selfRef.dispose()
         }
         ref = null
+        anchor = null
+        listener = null
     }
 
     private companion object {
+        /** Anchor error tolerated before republishing (~25us at 120 BPM). */
+        const val MAX_BEAT_ERROR = 5e-5
+
+        // C trampolines for the LinkKit callbacks; context is the StableRef.
+        val tempoCallback = staticCFunction { bpm: Double, context: COpaquePointer? ->
+            context?.asStableRef<LinkSession>()?.get()?.onSessionTempo(bpm)
+            Unit
+        }
+        val connectedCallback = staticCFunction { _: Boolean, context: COpaquePointer? ->
+            context?.asStableRef<LinkSession>()?.get()?.onConnectionChanged()
+            Unit
+        }
+        val startStopCallback = staticCFunction { isPlaying: Boolean, context: COpaquePointer? ->
+            context?.asStableRef<LinkSession>()?.get()?.onStartStop(isPlaying)
+            Unit
+        }
+
+        /** mach_absolute_time() tick ratio, read once (125/3 on Apple silicon). */
+        val timebase: Pair<Long, Long> = memScoped {
+            val info = alloc<mach_timebase_info_data_t>()
+            mach_timebase_info(info.ptr)
+            info.numer.toLong() to info.denom.toLong()
+        }
+
+        /** Convert mach host ticks into microseconds. */
+        fun hostTicksToMicros(ticks: ULong): Long =
+            ticks.toLong() * timebase.first / timebase.second / 1_000L
+
+        /** Convert microseconds back into mach host ticks. */
+        fun microsToHostTicks(micros: Long): ULong =
+            (micros * 1_000L * timebase.second / timebase.first).toULong()
+
         /** Default initial tempo. */
         const val DEFAULT_BPM = 120.0
 
@@ -54,6 +54,43 @@ void ABLLinkSetTempo(ABLLinkSessionStateRef state, double bpm, uint64_t hostTime
 /** Get the beat position at the given host time and quantum. */
 double ABLLinkGetBeatAtTime(ABLLinkSessionStateRef state, uint64_t hostTime, double quantum);
 
+/** Get the host time at which the given beat (aligned to quantum) occurs. */
+uint64_t ABLLinkGetTimeAtBeat(ABLLinkSessionStateRef state, double beatTime, double quantum);
+
+/** Whether the user enabled start/stop sync (a LinkKit settings toggle). */
+bool ABLLinkIsStartStopSyncEnabled(ABLLinkRef ref);
+
+/** Transport state of a captured session state. */
+bool ABLLinkIsPlaying(ABLLinkSessionStateRef state);
+
+/** Host time of the last transport start/stop. */
+uint64_t ABLLinkTimeForIsPlaying(ABLLinkSessionStateRef state);
+
+/** Start or stop the transport at the given host time. */
+void ABLLinkSetIsPlaying(ABLLinkSessionStateRef state, bool isPlaying, uint64_t hostTime);
+
+/** Start or stop the transport and map [beatTime] to [hostTime], aligned to [quantum]. */
+void ABLLinkSetIsPlayingAndRequestBeatAtTime(
+    ABLLinkSessionStateRef state, bool isPlaying, uint64_t hostTime, double beatTime, double quantum);
+
+/** Called on the main thread when the session tempo changes. */
+typedef void (*ABLLinkSessionTempoCallback)(double sessionTempo, void* context);
+
+/** Called on the main thread when the session gains its first or loses its last peer. */
+typedef void (*ABLLinkIsConnectedCallback)(bool isConnected, void* context);
+
+/** Called on the main thread when the transport start/stop state changes. */
+typedef void (*ABLLinkStartStopCallback)(bool isPlaying, void* context);
+
+/** Register the tempo callback; [context] is passed back verbatim. */
+void ABLLinkSetSessionTempoCallback(ABLLinkRef ref, ABLLinkSessionTempoCallback callback, void* context);
+
+/** Register the connection callback; [context] is passed back verbatim. */
+void ABLLinkSetIsConnectedCallback(ABLLinkRef ref, ABLLinkIsConnectedCallback callback, void* context);
+
+/** Register the start/stop callback; [context] is passed back verbatim. */
+void ABLLinkSetStartStopCallback(ABLLinkRef ref, ABLLinkStartStopCallback callback, void* context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,73 @@
+/**
+ * Batched timeline capture on top of the LinkKit C API.
+ *
+ * Reading tempo, peers, transport state and the beat at several quanta
+ * through the plain LinkKit calls costs one cinterop transition per value, and
+ * each getter reads its own host time. ABLLinkCaptureTimeline() captures the session state once,
+ * reads the host clock once, and evaluates every requested quantum in one
+ * pass, so a Kotlin poll crosses into C exactly once.
+ *
+ * Defined inline so it is compiled into the cinterop klib and works the same
+ * against the real LinkKit framework and ABLLinkStubs.c. With CHROMADMX_TRACE
+ * each capture is an os_signpost interval (ABLLinkTrace.h).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "ABLLink.h"
+#include "ABLLinkTrace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Slots of the output array filled by ABLLinkCaptureTimeline(). */
+enum {
+    ABLLinkTimelineTempo = 0,     /**< Session tempo (BPM). */
+    ABLLinkTimelineNumPeers = 1,  /**< Connected peers. */
+    ABLLinkTimelineHostTime = 2,  /**< Host time (mach ticks) every beat was evaluated at. */
+    ABLLinkTimelineIsPlaying = 3, /**< 1.0 while the transport is playing, else 0.0. */
+    ABLLinkTimelinePlayTime = 4,  /**< Host time (mach ticks) of the last transport start/stop. */
+    ABLLinkTimelineStartStopSync = 5, /**< 1.0 if start/stop sync is enabled, else 0.0. */
+    ABLLinkTimelineFirstBeat = 6  /**< Beat at quanta[0]; quanta[i] follows at FirstBeat + i. */
+};
+
+/**
+ * Capture the session once and evaluate the beat at each of [count] quanta.
+ *
+ * @param ref      Link session.
+ * @param hostTime Host time to evaluate at, or 0 for mach_absolute_time() now.
+ * @param quanta   [count] quanta to evaluate the beat with.
+ * @param count    Number of quanta.
+ * @param out      At least ABLLinkTimelineFirstBeat + count doubles.
+ * @return false (and [out] untouched) if the session state could not be captured.
+ */
+static inline bool ABLLinkCaptureTimeline(
+    ABLLinkRef ref, uint64_t hostTime, const double* quanta, size_t count, double* out)
+{
+    if (ref == NULL || out == NULL) return false;
+    ABLLINK_TRACE_BEGIN("ABLLinkCaptureTimeline");
+    ABLLinkSessionStateRef state = ABLLinkCaptureAppSessionState(ref);
+    if (state == NULL) {
+        ABLLINK_TRACE_END("ABLLinkCaptureTimeline");
+        return false;
+    }
+
+    uint64_t time = hostTime != 0 ? hostTime : mach_absolute_time();
+    out[ABLLinkTimelineTempo] = ABLLinkGetTempo(state);
+    out[ABLLinkTimelineNumPeers] = (double)ABLLinkGetNumPeers(ref);
+    out[ABLLinkTimelineHostTime] = (double)time;
+    out[ABLLinkTimelineIsPlaying] = ABLLinkIsPlaying(state) ? 1.0 : 0.0;
+    out[ABLLinkTimelinePlayTime] = (double)ABLLinkTimeForIsPlaying(state);
+    out[ABLLinkTimelineStartStopSync] = ABLLinkIsStartStopSyncEnabled(ref) ? 1.0 : 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        out[ABLLinkTimelineFirstBeat + i] = ABLLinkGetBeatAtTime(state, time, quanta[i]);
+    }
+    ABLLINK_TRACE_END("ABLLinkCaptureTimeline");
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
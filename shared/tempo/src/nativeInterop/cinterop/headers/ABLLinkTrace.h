@@ -0,0 +1,49 @@
+/**
+ * Compile-time gated os_signpost intervals for the LinkKit shim.
+ *
+ * ABLLINK_TRACE_BEGIN(name) / ABLLINK_TRACE_END(name) bracket one interval
+ * in the "com.chromadmx" / "link" log, shown by Instruments' os_signpost
+ * and Points of Interest tracks. Names must be string literals, and each
+ * BEGIN must be matched by an END with the same name in the same scope.
+ *
+ * Intervals are compiled in only when CHROMADMX_TRACE is defined (the
+ * `chromadmx.trace` Gradle property passes it to cinterop); otherwise both
+ * macros expand to nothing. With the gate on and nothing recording, an
+ * interval costs the os_signpost enabled check.
+ */
+
+#pragma once
+
+#ifdef CHROMADMX_TRACE
+
+#include <os/signpost.h>
+#include <dispatch/dispatch.h>
+
+static os_log_t ABLLinkTraceLogHandle;
+static dispatch_once_t ABLLinkTraceLogOnce;
+
+static void ABLLinkTraceLogCreate(void* context) {
+    (void)context;
+    ABLLinkTraceLogHandle = os_log_create("com.chromadmx", "link");
+}
+
+/** Log the intervals are recorded in, created on first use. */
+static inline os_log_t ABLLinkTraceLog(void) {
+    dispatch_once_f(&ABLLinkTraceLogOnce, NULL, ABLLinkTraceLogCreate);
+    return ABLLinkTraceLogHandle;
+}
+
+#define ABLLINK_TRACE_BEGIN(name)                                               \
+    os_log_t ablTraceLog_ = ABLLinkTraceLog();                                  \
+    os_signpost_id_t ablTraceId_ = os_signpost_id_generate(ablTraceLog_);      \
+    os_signpost_interval_begin(ablTraceLog_, ablTraceId_, name)
+
+#define ABLLINK_TRACE_END(name) \
+    os_signpost_interval_end(ablTraceLog_, ablTraceId_, name)
+
+#else
+
+#define ABLLINK_TRACE_BEGIN(name) ((void)0)
+#define ABLLINK_TRACE_END(name) ((void)0)
+
+#endif
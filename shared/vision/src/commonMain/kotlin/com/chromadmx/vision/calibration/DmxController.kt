@@ -30,4 +30,16 @@ interface DmxController {
      * Turn off all fixtures (blackout).
      */
     suspend fun blackout()
+
+    /**
+     * Light exactly [fixtureIds] at full white and turn everything else off.
+     * Used by coded scans, which light many fixtures per frame.
+     *
+     * The default blacks out and fires each fixture in turn; implementations
+     * that can should override it to apply the whole pattern in one DMX frame.
+     */
+    suspend fun showPattern(fixtureIds: Collection<String>) {
+        blackout()
+        for (fixtureId in fixtureIds) fireFixture(fixtureId)
+    }
 }
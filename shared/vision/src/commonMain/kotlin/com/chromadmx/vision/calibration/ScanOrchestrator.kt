@@ -3,6 +3,7 @@ package com.chromadmx.vision.calibration
 import com.chromadmx.vision.camera.GrayscaleFrame
 import com.chromadmx.vision.detection.BlobDetector
 import com.chromadmx.vision.detection.Coord2D
+import com.chromadmx.vision.detection.GrayCodeDecoder
 import com.chromadmx.vision.mapping.SpatialMap
 import com.chromadmx.vision.mapping.SpatialMapBuilder
 import kotlinx.coroutines.delay
@@ -23,6 +24,21 @@ data class ScanFixture(
     val pixelCount: Int = 1
 )
 
+/**
+ * How the orchestrator lights fixtures to locate them.
+ */
+enum class ScanMode {
+    /** Fire one fixture per capture: N captures for N fixtures. */
+    SEQUENTIAL,
+
+    /**
+     * Flash single-cell fixtures in Gray-code patterns and decode them per
+     * pixel with [GrayCodeDecoder]: ⌈log2(N+1)⌉ + 1 captures for N fixtures.
+     * Multi-cell endpoint detection still runs one bar at a time.
+     */
+    GRAY_CODE
+}
+
 /**
  * Interface for capturing camera frames. Abstracts the platform camera so
  * the orchestrator can be tested with synthetic frames.
@@ -39,7 +55,11 @@ interface FrameCapture {
  *
  * ## Pipeline
  * 1. Capture ambient baseline
- * 2. For each fixture: fire at full white, capture, subtract ambient, detect blob centroid
+ * 2. Locate fixtures, depending on [scanMode]:
+ *    - [ScanMode.SEQUENTIAL]: for each fixture, fire at full white, capture,
+ *      subtract ambient, detect blob centroid
+ *    - [ScanMode.GRAY_CODE]: capture an all-on reference and one frame per
+ *      code bit across the single-cell fixtures, then decode per pixel
  * 3. For each multi-cell fixture: fire end-pixels, detect two endpoint blobs
  * 4. Build SpatialMap from all detected positions
  *
@@ -52,7 +72,8 @@ class ScanOrchestrator(
     private val frameCapture: FrameCapture,
     private val blobDetector: BlobDetector = BlobDetector(),
     private val fireSettleMs: Long = 80L,
-    private val decayMs: Long = 50L
+    private val decayMs: Long = 50L,
+    private val scanMode: ScanMode = ScanMode.SEQUENTIAL
 ) {
     private val _state = MutableStateFlow<ScanState>(ScanState.Idle)
 
@@ -80,43 +101,14 @@ class ScanOrchestrator(
 
             val mapBuilder = SpatialMapBuilder()
 
-            // Step 2: Scan each fixture individually
-            for ((index, scanFixture) in fixtures.withIndex()) {
-                _state.value = ScanState.Scanning(
-                    currentFixtureIndex = index,
-                    totalFixtures = fixtures.size,
-                    currentFixtureId = scanFixture.fixtureId
-                )
-
-                // Fire fixture at full white
-                dmxController.fireFixture(scanFixture.fixtureId)
-                delay(fireSettleMs)
-
-                // Capture and subtract ambient
-                val captured = frameCapture.captureFrame()
-                val diff = captured.subtract(ambient)
-
-                // Detect the brightest blob
-                val blobs = blobDetector.detect(diff)
-                if (blobs.isEmpty()) {
-                    _state.value = ScanState.Error(
-                        "No blob detected for fixture '${scanFixture.fixtureId}'"
-                    )
-                    dmxController.blackout()
-                    return null
-                }
-
-                // Use the brightest (first) blob
-                val centroid = blobs[0].centroid
-
-                if (!scanFixture.isMultiCell) {
-                    mapBuilder.addSingleCell(scanFixture.fixtureId, centroid)
-                }
-                // Multi-cell centroids stored temporarily; endpoints detected in step 3
-
-                // Turn off and wait for decay
-                dmxController.turnOffFixture(scanFixture.fixtureId)
-                delay(decayMs)
+            // Step 2: Locate fixtures
+            val located = when (scanMode) {
+                ScanMode.SEQUENTIAL -> scanSequential(fixtures, ambient, mapBuilder)
+                ScanMode.GRAY_CODE -> scanGrayCode(fixtures, ambient, mapBuilder)
+            }
+            if (!located) {
+                dmxController.blackout()
+                return null
             }
 
             // Step 3: Endpoint detection for multi-cell fixtures
@@ -132,12 +124,9 @@ class ScanOrchestrator(
                 dmxController.fireEndPixels(scanFixture.fixtureId)
                 delay(fireSettleMs)
 
-                // Capture and subtract ambient
+                // Capture, subtract ambient and detect two endpoint blobs
                 val captured = frameCapture.captureFrame()
-                val diff = captured.subtract(ambient)
-
-                // Detect two endpoint blobs
-                val blobs = blobDetector.detect(diff)
+                val blobs = blobDetector.detect(captured, ambient)
                 if (blobs.size < 2) {
                     _state.value = ScanState.Error(
                         "Expected 2 endpoint blobs for fixture '${scanFixture.fixtureId}', " +
@@ -174,6 +163,109 @@ class ScanOrchestrator(
         }
     }
 
+    /**
+     * Fire each fixture alone and record single-cell centroids.
+     *
+     * @return false if a fixture produced no blob ([state] is set to the error)
+     */
+    private suspend fun scanSequential(
+        fixtures: List<ScanFixture>,
+        ambient: GrayscaleFrame,
+        mapBuilder: SpatialMapBuilder
+    ): Boolean {
+        for ((index, scanFixture) in fixtures.withIndex()) {
+            _state.value = ScanState.Scanning(
+                currentFixtureIndex = index,
+                totalFixtures = fixtures.size,
+                currentFixtureId = scanFixture.fixtureId
+            )
+
+            // Fire fixture at full white
+            dmxController.fireFixture(scanFixture.fixtureId)
+            delay(fireSettleMs)
+
+            // Capture, subtract ambient and detect the brightest blob
+            val captured = frameCapture.captureFrame()
+            val blobs = blobDetector.detect(captured, ambient)
+            if (blobs.isEmpty()) {
+                _state.value = ScanState.Error(
+                    "No blob detected for fixture '${scanFixture.fixtureId}'"
+                )
+                return false
+            }
+
+            // Use the brightest (first) blob
+            val centroid = blobs[0].centroid
+
+            if (!scanFixture.isMultiCell) {
+                mapBuilder.addSingleCell(scanFixture.fixtureId, centroid)
+            }
+            // Multi-cell centroids stored temporarily; endpoints detected in step 3
+
+            // Turn off and wait for decay
+            dmxController.turnOffFixture(scanFixture.fixtureId)
+            delay(decayMs)
+        }
+        return true
+    }
+
+    /**
+     * Flash all single-cell fixtures in Gray-code patterns and decode their
+     * centroids. Multi-cell fixtures are left to endpoint detection.
+     *
+     * Each pattern is applied, settled and captured before the next is
+     * shown, so every frame is matched to its pattern by sequence alone.
+     *
+     * @return false if a fixture could not be decoded ([state] is set to the error)
+     */
+    private suspend fun scanGrayCode(
+        fixtures: List<ScanFixture>,
+        ambient: GrayscaleFrame,
+        mapBuilder: SpatialMapBuilder
+    ): Boolean {
+        val coded = fixtures.filter { !it.isMultiCell }
+        if (coded.isEmpty()) return true
+
+        val decoder = GrayCodeDecoder(
+            targetCount = coded.size,
+            brightnessThreshold = blobDetector.brightnessThreshold,
+            minBlobSize = blobDetector.minBlobSize
+        )
+        val totalPatterns = decoder.bitCount + 1
+        val allIds = coded.map { it.fixtureId }
+
+        // Pattern 0 is the all-on reference, then one pattern per code bit
+        _state.value = ScanState.ScanningPatterns(0, totalPatterns)
+        dmxController.showPattern(allIds)
+        delay(fireSettleMs)
+        val reference = frameCapture.captureFrame()
+
+        val bitFrames = ArrayList<GrayscaleFrame>(decoder.bitCount)
+        for (bit in 0 until decoder.bitCount) {
+            _state.value = ScanState.ScanningPatterns(bit + 1, totalPatterns)
+            val lit = coded.indices.filter { decoder.isLit(it, bit) }.map { coded[it].fixtureId }
+            dmxController.showPattern(lit)
+            delay(fireSettleMs)
+            bitFrames.add(frameCapture.captureFrame())
+        }
+
+        dmxController.blackout()
+        delay(decayMs)
+
+        val blobs = decoder.decode(ambient, reference, bitFrames)
+        for ((index, scanFixture) in coded.withIndex()) {
+            val blob = blobs[index]
+            if (blob == null) {
+                _state.value = ScanState.Error(
+                    "No blob detected for fixture '${scanFixture.fixtureId}'"
+                )
+                return false
+            }
+            mapBuilder.addSingleCell(scanFixture.fixtureId, blob.centroid)
+        }
+        return true
+    }
+
     /**
      * Reset the orchestrator to idle state.
      */
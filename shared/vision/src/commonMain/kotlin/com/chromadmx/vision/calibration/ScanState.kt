@@ -7,6 +7,7 @@ import com.chromadmx.vision.mapping.SpatialMap
  *
  * The scan progresses linearly through these states:
  * IDLE -> CAPTURING_BASELINE -> SCANNING -> DETECTING_ENDPOINTS -> COMPLETE
+ * A [ScanMode.GRAY_CODE] scan shows SCANNING_PATTERNS in place of SCANNING.
  * Any state may transition to ERROR on failure.
  */
 sealed class ScanState {
@@ -31,6 +32,19 @@ sealed class ScanState {
         val progress: Float get() = (currentFixtureIndex + 1).toFloat() / totalFixtures
     }
 
+    /**
+     * Capturing coded light patterns for a [ScanMode.GRAY_CODE] scan.
+     * @param currentPatternIndex 0-based index of the pattern being captured
+     * @param totalPatterns patterns in the sequence, including the all-on reference
+     */
+    data class ScanningPatterns(
+        val currentPatternIndex: Int,
+        val totalPatterns: Int
+    ) : ScanState() {
+        /** Progress as a fraction from 0.0 to 1.0. */
+        val progress: Float get() = (currentPatternIndex + 1).toFloat() / totalPatterns
+    }
+
     /**
      * Detecting endpoints for multi-cell fixtures.
      * @param currentFixtureIndex 0-based index of the multi-cell fixture
@@ -7,11 +7,17 @@ import com.chromadmx.vision.camera.GrayscaleFrame
  * thresholding and connected-component labeling (4-connectivity).
  *
  * Algorithm:
- * 1. Threshold the frame to produce a binary mask of "bright" pixels.
- * 2. Run single-pass flood-fill CCL with 4-connectivity (up/down/left/right).
+ * 1. Threshold the frame (optionally minus an ambient baseline) row by row,
+ *    collecting horizontal runs of "bright" pixels.
+ * 2. Union each run with the overlapping runs of the previous row
+ *    (4-connectivity: runs that only touch diagonally stay separate).
  * 3. For each connected component, compute the brightness-weighted centroid.
  * 4. Filter components smaller than [minBlobSize].
  * 5. Return detected blobs sorted by total brightness (brightest first).
+ *
+ * Working buffers are kept between calls and only grow, so scanning a rig
+ * does not allocate per frame beyond the returned list. A detector is
+ * therefore not thread-safe: use one per scanning loop.
  */
 class BlobDetector(
     /** Minimum brightness (0.0-1.0) for a pixel to be considered part of a blob. */
@@ -28,122 +34,196 @@ class BlobDetector(
         }
     }
 
+    // Per-run scratch, indexed by run id in raster order
+    private var runStart = IntArray(INITIAL_RUNS)
+    private var runEnd = IntArray(INITIAL_RUNS)
+    private var runParent = IntArray(INITIAL_RUNS)
+    private var runSumX = FloatArray(INITIAL_RUNS)
+    private var runSumY = FloatArray(INITIAL_RUNS)
+    private var runBrightness = FloatArray(INITIAL_RUNS)
+
+    // Per-component accumulators, indexed by root run id
+    private var compSumX = FloatArray(INITIAL_RUNS)
+    private var compSumY = FloatArray(INITIAL_RUNS)
+    private var compBrightness = FloatArray(INITIAL_RUNS)
+    private var compCount = IntArray(INITIAL_RUNS)
+
     /**
      * Detect blobs in the given difference frame.
      *
      * The frame is typically the result of subtracting an ambient baseline
-     * from a captured frame: `captured.subtract(ambient)`.
+     * from a captured frame: `captured.subtract(ambient)`. Prefer
+     * [detect] with a baseline, which gives the same result without
+     * materializing the difference frame.
      *
      * @return list of [DetectedBlob] sorted by total brightness descending
      */
-    fun detect(frame: GrayscaleFrame): List<DetectedBlob> {
-        val w = frame.width
-        val h = frame.height
-        val pixels = frame.pixels
+    fun detect(frame: GrayscaleFrame): List<DetectedBlob> =
+        label(frame.pixels, null, frame.width, frame.height)
 
-        // Label array: 0 = unlabeled, >0 = component label
-        val labels = IntArray(w * h)
-        var nextLabel = 1
+    /**
+     * Detect blobs in `frame.subtract(baseline)` in a single pass.
+     *
+     * Subtraction, clamping and thresholding are fused into the labeling
+     * scan, so the result is identical to `detect(frame.subtract(baseline))`
+     * without allocating the intermediate frame.
+     *
+     * @return list of [DetectedBlob] sorted by total brightness descending
+     */
+    fun detect(frame: GrayscaleFrame, baseline: GrayscaleFrame): List<DetectedBlob> {
+        require(frame.width == baseline.width && frame.height == baseline.height) {
+            "Frame dimensions must match for subtraction: " +
+                "${frame.width}x${frame.height} vs ${baseline.width}x${baseline.height}"
+        }
+        return label(frame.pixels, baseline.pixels, frame.width, frame.height)
+    }
 
-        // Accumulator per label: (sumX, sumY, sumBrightness, count)
-        val components = mutableMapOf<Int, BlobAccumulator>()
+    private fun label(pixels: FloatArray, baseline: FloatArray?, w: Int, h: Int): List<DetectedBlob> {
+        val threshold = brightnessThreshold
+        var runCount = 0
+        var prevRowFirst = 0
+        var prevRowEnd = 0
 
-        // Single-pass flood-fill CCL with 4-connectivity
         for (y in 0 until h) {
-            for (x in 0 until w) {
-                val idx = y * w + x
-                if (pixels[idx] >= brightnessThreshold && labels[idx] == 0) {
-                    val label = nextLabel++
-                    val acc = BlobAccumulator()
-                    floodFill(pixels, labels, w, h, x, y, label, acc)
-                    components[label] = acc
+            val rowOffset = y * w
+            val rowFirst = runCount
+            var x = 0
+            while (x < w) {
+                var v = pixelValue(pixels, baseline, rowOffset + x)
+                if (v < threshold) {
+                    x++
+                    continue
+                }
+
+                // Extend the run to the right, accumulating as we go
+                if (runCount == runStart.size) growRuns()
+                val start = x
+                var sumX = 0f
+                var brightness = 0f
+                while (true) {
+                    sumX += x * v
+                    brightness += v
+                    x++
+                    if (x >= w) break
+                    v = pixelValue(pixels, baseline, rowOffset + x)
+                    if (v < threshold) break
+                }
+                val run = runCount++
+                runStart[run] = start
+                runEnd[run] = x - 1
+                runParent[run] = run
+                runSumX[run] = sumX
+                runSumY[run] = y * brightness
+                runBrightness[run] = brightness
+            }
+
+            // Union with previous-row runs whose column ranges overlap
+            var p = prevRowFirst
+            for (run in rowFirst until runCount) {
+                val s = runStart[run]
+                val e = runEnd[run]
+                while (p < prevRowEnd && runEnd[p] < s) p++
+                var q = p
+                while (q < prevRowEnd && runStart[q] <= e) {
+                    union(run, q)
+                    q++
                 }
             }
+            prevRowFirst = rowFirst
+            prevRowEnd = runCount
         }
 
-        // Convert accumulators to DetectedBlob, filter by min size
-        return components.values
-            .filter { it.count >= minBlobSize }
-            .map { acc ->
+        if (runCount == 0) return emptyList()
+        ensureComponentCapacity(runCount)
+
+        // Fold runs into their roots. A root is the first run of its
+        // component, so visiting roots by run id keeps raster order.
+        for (run in 0 until runCount) {
+            if (find(run) == run) {
+                compSumX[run] = 0f
+                compSumY[run] = 0f
+                compBrightness[run] = 0f
+                compCount[run] = 0
+            }
+        }
+        for (run in 0 until runCount) {
+            val root = runParent[run]
+            compSumX[root] += runSumX[run]
+            compSumY[root] += runSumY[run]
+            compBrightness[root] += runBrightness[run]
+            compCount[root] += runEnd[run] - runStart[run] + 1
+        }
+
+        val blobs = ArrayList<DetectedBlob>()
+        for (root in 0 until runCount) {
+            if (runParent[root] != root) continue
+            val count = compCount[root]
+            if (count < minBlobSize) continue
+            val total = compBrightness[root]
+            blobs.add(
                 DetectedBlob(
                     centroid = Coord2D(
-                        x = acc.weightedSumX / acc.totalBrightness,
-                        y = acc.weightedSumY / acc.totalBrightness
+                        x = compSumX[root] / total,
+                        y = compSumY[root] / total
                     ),
-                    pixelCount = acc.count,
-                    totalBrightness = acc.totalBrightness
+                    pixelCount = count,
+                    totalBrightness = total
                 )
-            }
-            .sortedByDescending { it.totalBrightness }
+            )
+        }
+        blobs.sortByDescending { it.totalBrightness }
+        return blobs
     }
 
+    private fun pixelValue(pixels: FloatArray, baseline: FloatArray?, idx: Int): Float =
+        if (baseline == null) pixels[idx]
+        else (pixels[idx] - baseline[idx]).coerceAtLeast(0f)
+
     /**
-     * Iterative flood-fill using an explicit stack to avoid stack overflow
-     * on large blobs. Uses 4-connectivity (up/down/left/right).
+     * Root of [run], compressing the path so `runParent[run]` is the root
+     * afterwards. [union] always links to the lower id, so a root is the
+     * first run of its component.
      */
-    private fun floodFill(
-        pixels: FloatArray,
-        labels: IntArray,
-        w: Int,
-        h: Int,
-        startX: Int,
-        startY: Int,
-        label: Int,
-        acc: BlobAccumulator
-    ) {
-        val stack = ArrayDeque<Int>()
-        val startIdx = startY * w + startX
-        stack.addLast(startIdx)
-        labels[startIdx] = label
-
-        while (stack.isNotEmpty()) {
-            val idx = stack.removeLast()
-            val x = idx % w
-            val y = idx / w
-            val brightness = pixels[idx]
-
-            acc.weightedSumX += x * brightness
-            acc.weightedSumY += y * brightness
-            acc.totalBrightness += brightness
-            acc.count++
-
-            // 4-connectivity neighbors: right, left, down, up
-            if (x + 1 < w) {
-                val nIdx = idx + 1
-                if (labels[nIdx] == 0 && pixels[nIdx] >= brightnessThreshold) {
-                    labels[nIdx] = label
-                    stack.addLast(nIdx)
-                }
-            }
-            if (x - 1 >= 0) {
-                val nIdx = idx - 1
-                if (labels[nIdx] == 0 && pixels[nIdx] >= brightnessThreshold) {
-                    labels[nIdx] = label
-                    stack.addLast(nIdx)
-                }
-            }
-            if (y + 1 < h) {
-                val nIdx = idx + w
-                if (labels[nIdx] == 0 && pixels[nIdx] >= brightnessThreshold) {
-                    labels[nIdx] = label
-                    stack.addLast(nIdx)
-                }
-            }
-            if (y - 1 >= 0) {
-                val nIdx = idx - w
-                if (labels[nIdx] == 0 && pixels[nIdx] >= brightnessThreshold) {
-                    labels[nIdx] = label
-                    stack.addLast(nIdx)
-                }
-            }
+    private fun find(run: Int): Int {
+        var root = run
+        while (runParent[root] != root) root = runParent[root]
+        var node = run
+        while (runParent[node] != root) {
+            val next = runParent[node]
+            runParent[node] = root
+            node = next
         }
+        return root
+    }
+
+    private fun union(a: Int, b: Int) {
+        val ra = find(a)
+        val rb = find(b)
+        if (ra < rb) runParent[rb] = ra
+        else if (rb < ra) runParent[ra] = rb
+    }
+
+    private fun growRuns() {
+        val capacity = runStart.size * 2
+        runStart = runStart.copyOf(capacity)
+        runEnd = runEnd.copyOf(capacity)
+        runParent = runParent.copyOf(capacity)
+        runSumX = runSumX.copyOf(capacity)
+        runSumY = runSumY.copyOf(capacity)
+        runBrightness = runBrightness.copyOf(capacity)
+    }
+
+    private fun ensureComponentCapacity(runCount: Int) {
+        if (compCount.size >= runCount) return
+        val capacity = runStart.size
+        compSumX = FloatArray(capacity)
+        compSumY = FloatArray(capacity)
+        compBrightness = FloatArray(capacity)
+        compCount = IntArray(capacity)
     }
 
-    /** Mutable accumulator used during flood-fill to compute centroid stats. */
-    private class BlobAccumulator {
-        var weightedSumX: Float = 0f
-        var weightedSumY: Float = 0f
-        var totalBrightness: Float = 0f
-        var count: Int = 0
+    private companion object {
+        /** Enough runs for a typical scan frame with a few blobs. */
+        const val INITIAL_RUNS = 256
     }
 }
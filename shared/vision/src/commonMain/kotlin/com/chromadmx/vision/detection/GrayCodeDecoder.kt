@@ -0,0 +1,140 @@
+package com.chromadmx.vision.detection
+
+import com.chromadmx.vision.camera.GrayscaleFrame
+
+/**
+ * Decodes binary-coded structured-light frames into per-target centroids.
+ *
+ * Each of [targetCount] targets (fixtures) is assigned the Gray code of
+ * `index + 1`, so no target is ever dark in every frame. Frame `b` lights
+ * exactly the targets whose code has bit `b` set ([isLit]). Together with
+ * one reference frame with every target lit, [bitCount] + 1 captures
+ * localize all targets instead of one capture per target.
+ *
+ * Decoding is per pixel:
+ * 1. Pixels whose reference brightness (minus ambient) is below
+ *    [brightnessThreshold] are background.
+ * 2. Each remaining pixel reads bit `b` as set when frame `b` (minus
+ *    ambient) is at least half as bright as the reference there, which
+ *    keeps dim and bright fixtures on the same footing.
+ * 3. The Gray code is decoded back to a target index, and the pixel adds
+ *    to that target's reference-brightness-weighted centroid.
+ *
+ * Gray codes differ by one bit between neighbouring indices, so a pixel
+ * misread at a blob edge lands on a nearby index rather than an arbitrary
+ * one; such strays are dropped by [minBlobSize].
+ */
+class GrayCodeDecoder(
+    /** Number of targets to encode. */
+    val targetCount: Int,
+    /** Minimum reference brightness (0.0-1.0) for a pixel to be decoded. */
+    val brightnessThreshold: Float = 0.3f,
+    /** Minimum number of pixels for a target to be reported. */
+    val minBlobSize: Int = 3
+) {
+    init {
+        require(targetCount >= 1) { "targetCount must be >= 1, got $targetCount" }
+        require(brightnessThreshold in 0f..1f) {
+            "brightnessThreshold must be in [0, 1], got $brightnessThreshold"
+        }
+        require(minBlobSize >= 1) { "minBlobSize must be >= 1, got $minBlobSize" }
+    }
+
+    /** Number of coded frames, excluding the reference frame. */
+    val bitCount: Int = Int.SIZE_BITS - targetCount.countLeadingZeroBits()
+
+    /** Code assigned to target [index]. */
+    fun codeFor(index: Int): Int {
+        require(index in 0 until targetCount) { "index $index out of range for $targetCount targets" }
+        return toGray(index + 1)
+    }
+
+    /** Whether target [index] is lit in coded frame [bit]. */
+    fun isLit(index: Int, bit: Int): Boolean {
+        require(bit in 0 until bitCount) { "bit $bit out of range for $bitCount bits" }
+        return ((codeFor(index) shr bit) and 1) == 1
+    }
+
+    /**
+     * Decode a capture sequence.
+     *
+     * @param ambient   Frame with every target dark
+     * @param reference Frame with every target lit
+     * @param bitFrames [bitCount] frames, frame `b` lighting targets with bit `b` set
+     * @return one entry per target index, or null where the target was not found
+     */
+    fun decode(
+        ambient: GrayscaleFrame,
+        reference: GrayscaleFrame,
+        bitFrames: List<GrayscaleFrame>
+    ): List<DetectedBlob?> {
+        require(bitFrames.size == bitCount) {
+            "Expected $bitCount coded frames, got ${bitFrames.size}"
+        }
+        val w = ambient.width
+        val h = ambient.height
+        require(reference.width == w && reference.height == h && bitFrames.all { it.width == w && it.height == h }) {
+            "All frames must be ${w}x$h"
+        }
+
+        val amb = ambient.pixels
+        val ref = reference.pixels
+        val bits = Array(bitCount) { bitFrames[it].pixels }
+
+        val sumX = FloatArray(targetCount)
+        val sumY = FloatArray(targetCount)
+        val sumBrightness = FloatArray(targetCount)
+        val count = IntArray(targetCount)
+
+        for (y in 0 until h) {
+            val rowOffset = y * w
+            for (x in 0 until w) {
+                val idx = rowOffset + x
+                val base = amb[idx]
+                val lit = (ref[idx] - base).coerceAtLeast(0f)
+                if (lit < brightnessThreshold) continue
+
+                val half = lit * 0.5f
+                var code = 0
+                for (b in 0 until bitCount) {
+                    if (bits[b][idx] - base >= half) code = code or (1 shl b)
+                }
+                val target = fromGray(code) - 1
+                if (target !in 0 until targetCount) continue
+
+                sumX[target] += x * lit
+                sumY[target] += y * lit
+                sumBrightness[target] += lit
+                count[target]++
+            }
+        }
+
+        return List(targetCount) { i ->
+            if (count[i] < minBlobSize) {
+                null
+            } else {
+                DetectedBlob(
+                    centroid = Coord2D(x = sumX[i] / sumBrightness[i], y = sumY[i] / sumBrightness[i]),
+                    pixelCount = count[i],
+                    totalBrightness = sumBrightness[i]
+                )
+            }
+        }
+    }
+
+    companion object {
+        /** Binary-reflected Gray code of [value]. */
+        fun toGray(value: Int): Int = value xor (value ushr 1)
+
+        /** Inverse of [toGray]. */
+        fun fromGray(code: Int): Int {
+            var value = code
+            var shift = code ushr 1
+            while (shift != 0) {
+                value = value xor shift
+                shift = shift ushr 1
+            }
+            return value
+        }
+    }
+}
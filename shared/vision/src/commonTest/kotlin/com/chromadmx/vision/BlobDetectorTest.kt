@@ -288,6 +288,82 @@ class BlobDetectorTest {
         assertTrue(abs(blobsWithSub[0].centroid.y - 50f) < 2f)
     }
 
+    @Test
+    fun detect_with_baseline_matches_subtracted_frame() {
+        val ambient = SyntheticFrameHelper.uniformFrame(120, 80, 0.25f)
+        val spots = SyntheticFrameHelper.multipleSpots(
+            width = 120, height = 80,
+            spots = listOf(
+                SyntheticFrameHelper.SpotSpec(cx = 20f, cy = 20f, radius = 6f, falloff = true),
+                SyntheticFrameHelper.SpotSpec(cx = 90f, cy = 55f, radius = 9f, brightness = 0.7f)
+            )
+        )
+        val captured = com.chromadmx.vision.camera.GrayscaleFrame(
+            FloatArray(120 * 80) { i -> (spots.pixels[i] + ambient.pixels[i]).coerceIn(0f, 1f) },
+            120, 80
+        )
+
+        val expected = detector.detect(captured.subtract(ambient))
+        val fused = detector.detect(captured, ambient)
+        assertEquals(expected, fused)
+        assertEquals(2, fused.size)
+    }
+
+    // -----------------------------------------------------------------------
+    // Run merging and buffer reuse
+    // -----------------------------------------------------------------------
+
+    @Test
+    fun u_shape_runs_merge_into_one_blob() {
+        // Two vertical arms only join on the bottom row:
+        //   X . X
+        //   X . X
+        //   X X X
+        val frame = SyntheticFrameHelper.pixelFrame(
+            10, 10,
+            mapOf(
+                (2 to 2) to 0.5f, (4 to 2) to 0.5f,
+                (2 to 3) to 0.5f, (4 to 3) to 0.5f,
+                (2 to 4) to 0.5f, (3 to 4) to 0.5f, (4 to 4) to 0.5f
+            )
+        )
+        val blobs = detector.detect(frame)
+        assertEquals(1, blobs.size, "U-shape should form one connected blob")
+        assertEquals(7, blobs[0].pixelCount)
+    }
+
+    @Test
+    fun many_small_blobs_grow_working_buffers() {
+        // Isolated pixels on every other row and column: 50 * 50 = 2500 runs
+        val pixels = mutableMapOf<Pair<Int, Int>, Float>()
+        for (y in 0 until 100 step 2) {
+            for (x in 0 until 100 step 2) {
+                pixels[x to y] = 0.8f
+            }
+        }
+        val blobs = detector.detect(SyntheticFrameHelper.pixelFrame(100, 100, pixels))
+        assertEquals(2500, blobs.size)
+        assertTrue(blobs.all { it.pixelCount == 1 })
+    }
+
+    @Test
+    fun reused_detector_does_not_leak_previous_frame() {
+        val busy = SyntheticFrameHelper.multipleSpots(
+            width = 200, height = 100,
+            spots = listOf(
+                SyntheticFrameHelper.SpotSpec(cx = 30f, cy = 50f, radius = 8f),
+                SyntheticFrameHelper.SpotSpec(cx = 170f, cy = 50f, radius = 8f)
+            )
+        )
+        val single = SyntheticFrameHelper.singleSpot(200, 100, cx = 100f, cy = 40f, radius = 4f)
+
+        assertEquals(2, detector.detect(busy).size)
+        val blobs = detector.detect(single)
+        assertEquals(1, blobs.size)
+        assertEquals(BlobDetector(0.3f, 1).detect(single), blobs)
+        assertTrue(detector.detect(SyntheticFrameHelper.blankFrame(200, 100)).isEmpty())
+    }
+
     // -----------------------------------------------------------------------
     // Edge cases
     // -----------------------------------------------------------------------
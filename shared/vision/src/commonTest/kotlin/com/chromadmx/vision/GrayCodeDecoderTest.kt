@@ -0,0 +1,102 @@
+package com.chromadmx.vision
+
+import com.chromadmx.vision.camera.GrayscaleFrame
+import com.chromadmx.vision.detection.GrayCodeDecoder
+import kotlin.math.abs
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNotNull
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class GrayCodeDecoderTest {
+
+    private val w = 120
+    private val h = 60
+
+    /** Render spots for the targets lit in [bit], or all of them for the reference. */
+    private fun patternFrame(
+        decoder: GrayCodeDecoder,
+        centers: List<Pair<Float, Float>>,
+        bit: Int?,
+        ambient: Float = 0.1f
+    ): GrayscaleFrame {
+        val lit = centers.indices.filter { bit == null || decoder.isLit(it, bit) }
+        val spots = SyntheticFrameHelper.multipleSpots(
+            w, h, lit.map { SyntheticFrameHelper.SpotSpec(centers[it].first, centers[it].second, 3f, 0.8f) }
+        )
+        return GrayscaleFrame(FloatArray(w * h) { i -> (spots.pixels[i] + ambient).coerceIn(0f, 1f) }, w, h)
+    }
+
+    @Test
+    fun gray_code_round_trips() {
+        for (value in 0 until 1024) {
+            assertEquals(value, GrayCodeDecoder.fromGray(GrayCodeDecoder.toGray(value)))
+        }
+    }
+
+    @Test
+    fun neighbouring_codes_differ_by_one_bit() {
+        for (value in 0 until 1023) {
+            val diff = GrayCodeDecoder.toGray(value) xor GrayCodeDecoder.toGray(value + 1)
+            assertEquals(1, diff.countOneBits(), "codes for $value and ${value + 1}")
+        }
+    }
+
+    @Test
+    fun bit_count_is_logarithmic_and_no_code_is_dark() {
+        assertEquals(1, GrayCodeDecoder(1).bitCount)
+        assertEquals(2, GrayCodeDecoder(3).bitCount)
+        assertEquals(3, GrayCodeDecoder(4).bitCount)
+        assertEquals(8, GrayCodeDecoder(200).bitCount)
+
+        val decoder = GrayCodeDecoder(200)
+        val codes = (0 until 200).map { decoder.codeFor(it) }
+        assertTrue(codes.none { it == 0 }, "Every target must be lit in some frame")
+        assertEquals(200, codes.toSet().size, "Codes must be unique")
+        assertTrue(codes.all { it < (1 shl decoder.bitCount) })
+    }
+
+    @Test
+    fun decodes_every_target_from_log_frames() {
+        val centers = (0 until 10).map { i -> (8f + i * 11f) to (if (i % 2 == 0) 15f else 45f) }
+        val decoder = GrayCodeDecoder(centers.size, brightnessThreshold = 0.3f, minBlobSize = 1)
+
+        val ambient = SyntheticFrameHelper.uniformFrame(w, h, 0.1f)
+        val reference = patternFrame(decoder, centers, bit = null)
+        val bits = (0 until decoder.bitCount).map { patternFrame(decoder, centers, bit = it) }
+
+        val blobs = decoder.decode(ambient, reference, bits)
+        assertEquals(centers.size, blobs.size)
+        for ((i, center) in centers.withIndex()) {
+            val blob = assertNotNull(blobs[i], "target $i")
+            assertTrue(abs(blob.centroid.x - center.first) < 0.5f, "target $i X ${blob.centroid.x}")
+            assertTrue(abs(blob.centroid.y - center.second) < 0.5f, "target $i Y ${blob.centroid.y}")
+        }
+    }
+
+    @Test
+    fun missing_target_decodes_to_null() {
+        val centers = listOf(20f to 20f, 60f to 30f, 100f to 40f)
+        val decoder = GrayCodeDecoder(4, brightnessThreshold = 0.3f, minBlobSize = 1)
+
+        // Only three of the four targets are visible
+        val ambient = SyntheticFrameHelper.uniformFrame(w, h, 0.1f)
+        val reference = patternFrame(decoder, centers, bit = null)
+        val bits = (0 until decoder.bitCount).map { patternFrame(decoder, centers, bit = it) }
+
+        val blobs = decoder.decode(ambient, reference, bits)
+        assertNotNull(blobs[0])
+        assertNotNull(blobs[1])
+        assertNotNull(blobs[2])
+        assertNull(blobs[3])
+    }
+
+    @Test
+    fun rejects_wrong_frame_count() {
+        val decoder = GrayCodeDecoder(5)
+        val frame = SyntheticFrameHelper.blankFrame(w, h)
+        assertFailsWith<IllegalArgumentException> { decoder.decode(frame, frame, listOf(frame)) }
+    }
+}
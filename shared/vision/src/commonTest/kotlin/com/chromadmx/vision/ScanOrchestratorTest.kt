@@ -447,4 +447,102 @@ class ScanOrchestratorTest {
         // 1 ambient + 1 full fire + 1 endpoint = 3
         assertEquals(3, capture.captureCount)
     }
+
+    // -----------------------------------------------------------------------
+    // Tests: Gray-code mode
+    // -----------------------------------------------------------------------
+
+    /**
+     * Tracks which fixtures are lit and renders a spot for each of them,
+     * so captured frames follow whatever pattern the orchestrator shows.
+     */
+    private inner class LitRig(private val spots: Map<String, Coord2D>) : DmxController, FrameCapture {
+        val lit = mutableSetOf<String>()
+        var captureCount = 0
+            private set
+
+        override suspend fun fireFixture(fixtureId: String) { lit.add(fixtureId) }
+        override suspend fun turnOffFixture(fixtureId: String) { lit.remove(fixtureId) }
+        override suspend fun fireEndPixels(fixtureId: String) { lit.add(fixtureId) }
+        override suspend fun blackout() { lit.clear() }
+
+        override suspend fun captureFrame(): GrayscaleFrame {
+            captureCount++
+            val frame = SyntheticFrameHelper.multipleSpots(
+                frameW, frameH,
+                lit.mapNotNull { spots[it] }.map { SyntheticFrameHelper.SpotSpec(it.x, it.y, 3f, 0.9f) }
+            )
+            return GrayscaleFrame(
+                FloatArray(frameW * frameH) { i -> (frame.pixels[i] + 0.05f).coerceIn(0f, 1f) },
+                frameW, frameH
+            )
+        }
+    }
+
+    @Test
+    fun gray_code_scan_locates_every_fixture() = runTest {
+        val spots = (0 until 12).associate { i ->
+            "f$i" to Coord2D(x = 10f + (i % 4) * 25f, y = 15f + (i / 4) * 30f)
+        }
+        val rig = LitRig(spots)
+        val orchestrator = ScanOrchestrator(
+            rig, rig,
+            blobDetector = BlobDetector(brightnessThreshold = 0.3f, minBlobSize = 1),
+            fireSettleMs = 0L, decayMs = 0L,
+            scanMode = ScanMode.GRAY_CODE
+        )
+
+        val result = orchestrator.scan(spots.keys.map { ScanFixture(it) })
+
+        assertNotNull(result)
+        assertIs<ScanState.Complete>(orchestrator.state.value)
+        for ((id, expected) in spots) {
+            val pos = result.fixturePositions[id]!!.single()
+            assertTrue(abs(pos.x - expected.x) < 1f, "$id X should be ~${expected.x}, got ${pos.x}")
+            assertTrue(abs(pos.y - expected.y) < 1f, "$id Y should be ~${expected.y}, got ${pos.y}")
+        }
+        // 1 ambient + 1 reference + 4 code bits for 12 fixtures
+        assertEquals(6, rig.captureCount)
+    }
+
+    @Test
+    fun gray_code_scan_reports_missing_fixture() = runTest {
+        // f2 is patched but never shows up on camera
+        val rig = LitRig(mapOf("f0" to Coord2D(20f, 20f), "f1" to Coord2D(70f, 70f)))
+        val orchestrator = ScanOrchestrator(
+            rig, rig,
+            blobDetector = BlobDetector(brightnessThreshold = 0.3f, minBlobSize = 1),
+            fireSettleMs = 0L, decayMs = 0L,
+            scanMode = ScanMode.GRAY_CODE
+        )
+
+        val result = orchestrator.scan(listOf(ScanFixture("f0"), ScanFixture("f1"), ScanFixture("f2")))
+
+        assertNull(result)
+        val error = assertIs<ScanState.Error>(orchestrator.state.value)
+        assertTrue(error.message.contains("f2"))
+        assertTrue(rig.lit.isEmpty(), "Should black out on error")
+    }
+
+    @Test
+    fun gray_code_scan_still_detects_multi_cell_endpoints() = runTest {
+        val dmx = MockDmxController()
+        val capture = MockFrameCapture(listOf(
+            ambientFrame(),
+            twoSpotFrame(20f, 50f, 80f, 50f)   // bar1 endpoint fire
+        ))
+        val orchestrator = ScanOrchestrator(
+            dmx, capture,
+            blobDetector = BlobDetector(brightnessThreshold = 0.3f, minBlobSize = 1),
+            fireSettleMs = 0L, decayMs = 0L,
+            scanMode = ScanMode.GRAY_CODE
+        )
+
+        val result = orchestrator.scan(listOf(ScanFixture("bar1", isMultiCell = true, pixelCount = 5)))
+
+        assertNotNull(result)
+        assertEquals(5, result.fixturePositions["bar1"]!!.size)
+        // No coded patterns for bars: 1 ambient + 1 endpoint capture
+        assertEquals(2, capture.captureCount)
+    }
 }